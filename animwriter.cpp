@@ -0,0 +1,447 @@
+#include "animwriter.h"
+
+#include <QtEndian>
+#include <cstdio>
+
+static void appendLE16(QByteArray &out, int v)
+{
+    out.append(char(v & 0xFF));
+    out.append(char((v >> 8) & 0xFF));
+}
+
+static void appendBE32(QByteArray &out, quint32 v)
+{
+    char b[4];
+    qToBigEndian(v, b);
+    out.append(b, 4);
+}
+
+bool AnimWriter::open(const QString &path, const QSize &size, int frameCount)
+{
+    frameSize = size;
+    announcedFrames = frameCount;
+    frames = 0;
+    written = 0;
+    bool ok;
+    if (path == "-")
+    {
+        ok = file.open(stdout, QIODevice::WriteOnly);
+    }
+    else
+    {
+        file.setFileName(path);
+        ok = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!ok)
+    {
+        error = file.errorString();
+        return false;
+    }
+    return write(header());
+}
+
+bool AnimWriter::writeFrame(const QByteArray &encoded, int delayMs)
+{
+    ++frames;
+    return write(frameData(encoded, delayMs));
+}
+
+bool AnimWriter::finish()
+{
+    bool ok = write(trailer());
+    if (ok && frames != announcedFrames && !file.isSequential())
+        patchHeader(file);
+    file.close();
+    return ok;
+}
+
+bool AnimWriter::write(const QByteArray &data)
+{
+    if (file.write(data) != data.size())
+    {
+        error = file.errorString();
+        return false;
+    }
+    written += data.size();
+    return true;
+}
+
+// ---------------------------------------------------------------- GIF
+
+// Palette 3-3-2 : rouge et vert sur 8 niveaux, bleu sur 4. Le tramage
+// ordonné (Bayer 4x4) rend les dégradés sans bandes ; table par seuil et
+// par valeur, construite une fois (initialisation statique sûre entre
+// threads).
+struct DitherTables
+{
+    uchar level8[16][256];
+    uchar level4[16][256];
+
+    DitherTables()
+    {
+        static const int BAYER[16] = {0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5};
+        for (int t = 0; t < 16; ++t)
+        {
+            double offset = (BAYER[t] + 0.5) / 16.0 - 0.5;
+            for (int v = 0; v < 256; ++v)
+            {
+                level8[t][v] = uchar(qBound(0, qRound(v * 7 / 255.0 + offset), 7));
+                level4[t][v] = uchar(qBound(0, qRound(v * 3 / 255.0 + offset), 3));
+            }
+        }
+    }
+};
+
+static const DitherTables &ditherTables()
+{
+    static const DitherTables tables;
+    return tables;
+}
+
+// Codes LZW de longueur variable, bits de poids faible d'abord, en
+// sous-blocs d'au plus 255 octets
+class GifBitWriter
+{
+public:
+    explicit GifBitWriter(QByteArray &output) : out(output), acc(0), bits(0) {}
+
+    void put(int code, int size)
+    {
+        acc |= quint32(code) << bits;
+        bits += size;
+        while (bits >= 8)
+        {
+            block[blockSize++] = char(acc & 0xFF);
+            acc >>= 8;
+            bits -= 8;
+            if (blockSize == 255)
+                flushBlock();
+        }
+    }
+
+    void finish()
+    {
+        if (bits > 0)
+            block[blockSize++] = char(acc & 0xFF);
+        flushBlock();
+        out.append(char(0));
+    }
+
+private:
+    QByteArray &out;
+    quint32 acc;
+    int bits;
+    char block[255];
+    int blockSize = 0;
+
+    void flushBlock()
+    {
+        if (blockSize == 0)
+            return;
+        out.append(char(blockSize));
+        out.append(block, blockSize);
+        blockSize = 0;
+    }
+};
+
+// LZW de GIF sur des index 8 bits. Table des chaînes en hachage ouvert
+// (préfixe << 8 | octet -> code) ; vidée par un code d'effacement quand
+// elle atteint 4095 entrées, comme giflib.
+static void lzwEncode(const uchar *indices, int count, QByteArray &out)
+{
+    const int CLEAR = 256;
+    const int END = 257;
+    const int HASH_SIZE = 8192;
+    QVector<qint32> keys(HASH_SIZE, -1);
+    QVector<qint16> codes(HASH_SIZE);
+
+    out.append(char(8));  // taille minimale des codes
+    GifBitWriter bits(out);
+    int codeSize = 9;
+    int nextCode = END + 1;
+    bits.put(CLEAR, codeSize);
+
+    int prefix = indices[0];
+    for (int i = 1; i < count; ++i)
+    {
+        int c = indices[i];
+        qint32 key = (prefix << 8) | c;
+        int h = ((key * 2654435761u) >> 19) & (HASH_SIZE - 1);
+        while (keys[h] != -1 && keys[h] != key)
+            h = (h + 1) & (HASH_SIZE - 1);
+        if (keys[h] == key)
+        {
+            prefix = codes[h];
+            continue;
+        }
+
+        bits.put(prefix, codeSize);
+        if (nextCode < 4095)
+        {
+            keys[h] = key;
+            codes[h] = qint16(nextCode++);
+            if (nextCode > (1 << codeSize) && codeSize < 12)
+                ++codeSize;
+        }
+        else
+        {
+            bits.put(CLEAR, codeSize);
+            keys.fill(-1);
+            codeSize = 9;
+            nextCode = END + 1;
+        }
+        prefix = c;
+    }
+    bits.put(prefix, codeSize);
+    // Le décodeur ajoute encore une entrée en lisant ce dernier code
+    if (nextCode < 4095 && ++nextCode > (1 << codeSize) && codeSize < 12)
+        ++codeSize;
+    bits.put(END, codeSize);
+    bits.finish();
+}
+
+class GifWriter : public AnimWriter
+{
+public:
+    QByteArray encodeFrame(const QImage &frame) const override
+    {
+        QImage rgb = frame.convertToFormat(QImage::Format_RGB32);
+        const DitherTables &dt = ditherTables();
+        int w = rgb.width();
+        int h = rgb.height();
+        QByteArray indices(w * h, 0);
+        uchar *dst = reinterpret_cast<uchar *>(indices.data());
+        for (int y = 0; y < h; ++y)
+        {
+            const QRgb *row = reinterpret_cast<const QRgb *>(rgb.constScanLine(y));
+            for (int x = 0; x < w; ++x)
+            {
+                int t = (y & 3) * 4 + (x & 3);
+                QRgb p = row[x];
+                *dst++ = uchar(dt.level8[t][qRed(p)] << 5 | dt.level8[t][qGreen(p)] << 2
+                               | dt.level4[t][qBlue(p)]);
+            }
+        }
+
+        QByteArray out;
+        out.append(char(0x2C));   // descripteur d'image, sans palette locale
+        appendLE16(out, 0);
+        appendLE16(out, 0);
+        appendLE16(out, w);
+        appendLE16(out, h);
+        out.append(char(0));
+        lzwEncode(reinterpret_cast<const uchar *>(indices.constData()), w * h, out);
+        return out;
+    }
+
+protected:
+    QByteArray header() override
+    {
+        QByteArray out("GIF89a");
+        appendLE16(out, frameSize.width());
+        appendLE16(out, frameSize.height());
+        out.append(char(0xF7));   // palette globale de 256 couleurs
+        out.append(char(0));
+        out.append(char(0));
+        for (int i = 0; i < 256; ++i)
+        {
+            out.append(char(((i >> 5) & 7) * 255 / 7));
+            out.append(char(((i >> 2) & 7) * 255 / 7));
+            out.append(char((i & 3) * 255 / 3));
+        }
+        // Boucle infinie (extension NETSCAPE2.0)
+        out.append("\x21\xFF\x0BNETSCAPE2.0\x03\x01", 16);
+        appendLE16(out, 0);
+        out.append(char(0));
+        return out;
+    }
+
+    // Délais en centièmes : le reste est reporté sur l'image suivante
+    QByteArray frameData(const QByteArray &encoded, int delayMs) override
+    {
+        carryMs += delayMs;
+        int cs = carryMs / 10;
+        carryMs -= cs * 10;
+        QByteArray out("\x21\xF9\x04\x00", 4);
+        appendLE16(out, qMin(cs, 65535));
+        out.append(char(0));
+        out.append(char(0));
+        out.append(encoded);
+        return out;
+    }
+
+    QByteArray trailer() override { return QByteArray(1, char(0x3B)); }
+
+private:
+    int carryMs = 0;
+};
+
+// ---------------------------------------------------------------- APNG
+
+static quint32 pngCrc(const QByteArray &data, int from = 0)
+{
+    struct Table
+    {
+        quint32 t[256];
+        Table()
+        {
+            for (quint32 i = 0; i < 256; ++i)
+            {
+                quint32 c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+        }
+    };
+    static const Table table;
+    quint32 c = 0xFFFFFFFFu;
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    for (int i = from; i < data.size(); ++i)
+        c = table.t[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+static QByteArray pngChunk(const char *type, const QByteArray &data)
+{
+    QByteArray out;
+    appendBE32(out, quint32(data.size()));
+    QByteArray body(type, 4);
+    body.append(data);
+    out.append(body);
+    appendBE32(out, pngCrc(body));
+    return out;
+}
+
+class ApngWriter : public AnimWriter
+{
+public:
+    // Lignes filtrées « Up » (différence avec la ligne du dessus), puis
+    // flux zlib : qCompress préfixe la taille sur 4 octets, retirée ici
+    QByteArray encodeFrame(const QImage &frame) const override
+    {
+        QImage rgb = frame.convertToFormat(QImage::Format_RGB32);
+        int w = rgb.width();
+        int h = rgb.height();
+        QByteArray raw(h * (1 + 3 * w), 0);
+        uchar *dst = reinterpret_cast<uchar *>(raw.data());
+        const QRgb *above = nullptr;
+        for (int y = 0; y < h; ++y)
+        {
+            const QRgb *row = reinterpret_cast<const QRgb *>(rgb.constScanLine(y));
+            *dst++ = 2;
+            for (int x = 0; x < w; ++x)
+            {
+                QRgb up = above ? above[x] : 0;
+                *dst++ = uchar(qRed(row[x]) - qRed(up));
+                *dst++ = uchar(qGreen(row[x]) - qGreen(up));
+                *dst++ = uchar(qBlue(row[x]) - qBlue(up));
+            }
+            above = row;
+        }
+        QByteArray z = qCompress(raw, 6);
+        z.remove(0, 4);
+        return z;
+    }
+
+protected:
+    QByteArray header() override
+    {
+        QByteArray out("\x89PNG\r\n\x1A\n", 8);
+        QByteArray ihdr;
+        appendBE32(ihdr, quint32(frameSize.width()));
+        appendBE32(ihdr, quint32(frameSize.height()));
+        ihdr.append("\x08\x02\x00\x00\x00", 5);   // 8 bits, RGB
+        out.append(pngChunk("IHDR", ihdr));
+        out.append(animationControl(announcedFrames));
+        return out;
+    }
+
+    // fcTL puis les données : IDAT pour la première image (image par
+    // défaut des lecteurs PNG simples), fdAT numérotés ensuite
+    QByteArray frameData(const QByteArray &encoded, int delayMs) override
+    {
+        QByteArray fctl;
+        appendBE32(fctl, sequence++);
+        appendBE32(fctl, quint32(frameSize.width()));
+        appendBE32(fctl, quint32(frameSize.height()));
+        appendBE32(fctl, 0);
+        appendBE32(fctl, 0);
+        fctl.append(char((qMin(delayMs, 65535) >> 8) & 0xFF));
+        fctl.append(char(qMin(delayMs, 65535) & 0xFF));
+        fctl.append(char(1000 >> 8));
+        fctl.append(char(1000 & 0xFF));
+        fctl.append(char(0));   // pas d'effacement
+        fctl.append(char(0));   // remplacement (images opaques)
+        QByteArray out = pngChunk("fcTL", fctl);
+
+        if (frames == 1)
+        {
+            out.append(pngChunk("IDAT", encoded));
+        }
+        else
+        {
+            QByteArray fdat;
+            appendBE32(fdat, sequence++);
+            fdat.append(encoded);
+            out.append(pngChunk("fdAT", fdat));
+        }
+        return out;
+    }
+
+    QByteArray trailer() override { return pngChunk("IEND", QByteArray()); }
+
+    void patchHeader(QFile &file) override
+    {
+        file.seek(ACTL_OFFSET);
+        file.write(animationControl(frames));
+    }
+
+private:
+    static constexpr int ACTL_OFFSET = 8 + 25;   // signature, IHDR
+    quint32 sequence = 0;
+
+    static QByteArray animationControl(int frameCount)
+    {
+        QByteArray actl;
+        appendBE32(actl, quint32(frameCount));
+        appendBE32(actl, 0);   // boucle infinie
+        return pngChunk("acTL", actl);
+    }
+};
+
+// ---------------------------------------------------------------- brut
+
+class RawWriter : public AnimWriter
+{
+public:
+    QByteArray encodeFrame(const QImage &frame) const override
+    {
+        QImage rgb = frame.convertToFormat(QImage::Format_RGB32);
+        QByteArray out;
+        out.reserve(rgb.width() * rgb.height() * 4);
+        for (int y = 0; y < rgb.height(); ++y)
+            out.append(reinterpret_cast<const char *>(rgb.constScanLine(y)), rgb.width() * 4);
+        return out;
+    }
+
+protected:
+    QByteArray header() override { return QByteArray(); }
+    QByteArray frameData(const QByteArray &encoded, int delayMs) override
+    {
+        Q_UNUSED(delayMs);
+        return encoded;
+    }
+    QByteArray trailer() override { return QByteArray(); }
+};
+
+AnimWriter *AnimWriter::create(const QString &format)
+{
+    if (format == "gif")
+        return new GifWriter;
+    if (format == "apng" || format == "png")
+        return new ApngWriter;
+    if (format == "raw")
+        return new RawWriter;
+    return nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef ANIMWRITER_H
+#define ANIMWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// Animation écrite image par image, sans affichage (snake_replay_export).
+// encodeFrame() ne touche à aucun état de l'objet : les images sont
+// encodées en parallèle, puis writeFrame() les écrit dans l'ordre. Seules
+// les images en cours d'encodage restent en mémoire.
+//
+//   gif  : palette fixe 3-3-2 et tramage ordonné, LZW par image
+//   apng : RGB sans perte, chaque image compressée séparément (zlib)
+//   raw  : images BGRA 32 bits brutes à la suite, pour un encodeur vidéo
+//          (ffmpeg -f rawvideo -pix_fmt bgra -s LxH -i -)
+class AnimWriter
+{
+public:
+    virtual ~AnimWriter() {}
+
+    // "gif", "apng" ou "raw" ; nullptr pour un format inconnu
+    static AnimWriter *create(const QString &format);
+
+    // `path` "-" : sortie standard. `frameCount` est annoncé dans
+    // l'en-tête quand le format l'exige, corrigé à la fin si possible.
+    bool open(const QString &path, const QSize &size, int frameCount);
+    virtual QByteArray encodeFrame(const QImage &frame) const = 0;
+    bool writeFrame(const QByteArray &encoded, int delayMs);
+    bool finish();
+
+    qint64 bytesWritten() const { return written; }
+    QString errorString() const { return error; }
+
+protected:
+    QSize frameSize;
+    int announcedFrames = 0;
+    int frames = 0;
+
+    bool write(const QByteArray &data);
+    virtual QByteArray header() = 0;
+    virtual QByteArray frameData(const QByteArray &encoded, int delayMs) = 0;
+    virtual QByteArray trailer() = 0;
+    // Réécrit ce qui dépend du nombre réel d'images (fichier seulement)
+    virtual void patchHeader(QFile &file) { Q_UNUSED(file); }
+
+private:
+    QFile file;
+    qint64 written = 0;
+    QString error;
+};
+
+#endif // ANIMWRITER_H
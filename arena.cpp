@@ -0,0 +1,728 @@
+#include "arena.h"
+
+#include <QDataStream>
+#include <climits>
+
+static const quint32 STATE_VERSION = 3;
+
+Arena::Arena(QObject *parent)
+    : QObject(parent),
+    width(WIDTH),
+    height(HEIGHT),
+    players(1),
+    currentLevel(1),
+    tickNo(0),
+    rng(QRandomGenerator::global()->generate())
+{
+    setup(1, 1);
+}
+
+void Arena::setup(int playerCount, int botCount, int w, int h)
+{
+    int total = qBound(1, playerCount + botCount, MAX_SNAKES);
+    players = qBound(0, playerCount, total);
+    width = qBound(8, w, MAX_SIDE);
+    height = qBound(8, h, MAX_SIDE);
+
+    snakes.resize(total);
+    for (int id = 0; id < total; ++id)
+        snakes[id].isBot = (id >= players);
+}
+
+void Arena::setLevel(int level)
+{
+    if (level >= 1 && level <= 3)
+        currentLevel = level;
+}
+
+int Arena::getSpeed() const
+{
+    return levels.level(currentLevel).tickMs;
+}
+
+int Arena::stepCell(int cell, Direction dir) const
+{
+    int x = cell % width;
+    int y = cell / width;
+    switch (dir)
+    {
+    case UP: y = (y == 0) ? height - 1 : y - 1; break;
+    case DOWN: y = (y == height - 1) ? 0 : y + 1; break;
+    case LEFT: x = (x == 0) ? width - 1 : x - 1; break;
+    case RIGHT: x = (x == width - 1) ? 0 : x + 1; break;
+    }
+    return y * width + x;
+}
+
+int Arena::wrapDistance(int a, int b) const
+{
+    int dx = qAbs(a % width - b % width);
+    int dy = qAbs(a / width - b / width);
+    return qMin(dx, width - dx) + qMin(dy, height - dy);
+}
+
+void ArenaSnake::pushHead(int cell)
+{
+    if (length == ring.size())
+    {
+        // Anneau plein : on double la capacité en remettant la queue en 0
+        QVector<int> grown(ring.size() * 2);
+        for (int i = 0; i < length; ++i)
+            grown[i] = ring[(tail + i) & (ring.size() - 1)];
+        ring = grown;
+        tail = 0;
+    }
+    ring[(tail + length) & (ring.size() - 1)] = cell;
+    ++length;
+}
+
+void ArenaSnake::popTail()
+{
+    tail = (tail + 1) & (ring.size() - 1);
+    --length;
+}
+
+void ArenaTickDelta::clear()
+{
+    deaths.clear();
+    moves.clear();
+    foodRemoved.clear();
+    foodAdded.clear();
+}
+
+bool Arena::spawnSnake(int id)
+{
+    ArenaSnake &s = snakes[id];
+    s.ring = QVector<int>(8);
+    s.tail = 0;
+    s.length = 0;
+    s.score = 0;
+    s.pendingGrowth = 0;
+    s.alive = false;
+    s.targetCell = -1;
+
+    for (int tries = 0; tries < 500; ++tries)
+    {
+        Direction dir = static_cast<Direction>(rng.bounded(UP, RIGHT + 1));
+        int head = rng.bounded(height) * width + rng.bounded(width);
+        int neck = stepCell(head, oppositeDirection(dir));
+        int tailCell = stepCell(neck, oppositeDirection(dir));
+        int ahead = stepCell(head, dir);
+        int ahead2 = stepCell(ahead, dir);
+
+        if (occupancy[head] != CELL_EMPTY || occupancy[neck] != CELL_EMPTY ||
+            occupancy[tailCell] != CELL_EMPTY || occupancy[ahead] != CELL_EMPTY ||
+            occupancy[ahead2] != CELL_EMPTY)
+            continue;
+
+        quint16 tag = static_cast<quint16>(id + 1);
+        s.pushHead(tailCell);
+        s.pushHead(neck);
+        s.pushHead(head);
+        occupancy[tailCell] = tag;
+        occupancy[neck] = tag;
+        occupancy[head] = tag;
+        s.direction = dir;
+        s.nextDirection = dir;
+        s.alive = true;
+        return true;
+    }
+    return false;
+}
+
+void Arena::generateObstacles()
+{
+    obstacles.clear();
+
+    // Même densité que les murs isolés du jeu solo (5 / 8 / 12 pour 1000
+    // cases par défaut), quelle que soit la taille du plateau
+    int nbObs = static_cast<int>(qint64(levels.level(currentLevel).wallsPerThousand)
+                                 * width * height / 1000);
+
+    for (int i = 0; i < nbObs; ++i)
+    {
+        for (int tries = 0; tries < 100; ++tries)
+        {
+            int cell = rng.bounded(height) * width + rng.bounded(width);
+            if (occupancy[cell] != CELL_EMPTY)
+                continue;
+
+            // Jamais à moins de deux cases d'une tête au départ
+            bool nearHead = false;
+            for (int d1 = UP; d1 <= RIGHT && !nearHead; ++d1)
+            {
+                int n1 = stepCell(cell, static_cast<Direction>(d1));
+                for (int d2 = 0; d2 <= RIGHT && !nearHead; ++d2)
+                {
+                    int n = d2 ? stepCell(n1, static_cast<Direction>(d2)) : n1;
+                    quint16 o = occupancy[n];
+                    if (o != CELL_EMPTY && o != CELL_WALL && snakes[o - 1].headCell() == n)
+                        nearHead = true;
+                }
+            }
+            if (nearHead)
+                continue;
+
+            occupancy[cell] = CELL_WALL;
+            obstacles.push_back({cellX(cell), cellY(cell)});
+            break;
+        }
+    }
+}
+
+void Arena::spawnFood(int index)
+{
+    int cells = width * height;
+    int cell = -1;
+    for (int tries = 0; tries < 64 && cell < 0; ++tries)
+    {
+        int c = rng.bounded(cells);
+        if (occupancy[c] == CELL_EMPTY && foodAt[c] < 0)
+            cell = c;
+    }
+    if (cell < 0)
+    {
+        // Plateau très encombré : parcours depuis une case aléatoire
+        int start = rng.bounded(cells);
+        for (int i = 0; i < cells && cell < 0; ++i)
+        {
+            int c = (start + i) % cells;
+            if (occupancy[c] == CELL_EMPTY && foodAt[c] < 0)
+                cell = c;
+        }
+    }
+
+    foods[index].cell = cell;  // -1 si le plateau est plein
+    // Pas d'effets en arène : fruits seulement
+    foods[index].type = static_cast<FruitType>(fruitSampler().sample(rng));
+    if (cell >= 0)
+        foodAt[cell] = index;
+    scheduleExpiry(index);
+}
+
+void Arena::removeFood(int cell)
+{
+    int index = foodAt[cell];
+    foodAt[cell] = -1;
+    foods[index].cell = -1;
+    timers.cancel(foodTimer[index]);
+    foodTimer[index] = 0;
+}
+
+void Arena::scheduleExpiry(int index)
+{
+    timers.cancel(foodTimer[index]);
+    foodTimer[index] = 0;
+    int lifetime = itemType(foods[index].type).lifetime;
+    if (lifetime > 0 && foods[index].cell >= 0)
+        foodTimer[index] = timers.schedule(quint64(tickNo) + lifetime, 0, index);
+}
+
+int Arena::foodTicksLeft(int i) const
+{
+    quint64 due = timers.dueTick(foodTimer[i]);
+    return due ? static_cast<int>(due - timers.now()) : -1;
+}
+
+// Fin de tick : les fruits arrivés à échéance sont remplacés. Rien n'est
+// décompté par fruit, le coût ne dépend que des fruits qui expirent.
+void Arena::expireFoods()
+{
+    firedTimers.clear();
+    timers.advance(firedTimers);
+    for (const TimerEvent &event : firedTimers)
+    {
+        int index = event.arg;
+        int cell = foods[index].cell;
+        foodTimer[index] = 0;
+        if (cell < 0)
+            continue;
+        removeFood(cell);
+        delta.foodRemoved.append(cell);
+        spawnFood(index);
+        if (foods[index].cell >= 0)
+            delta.foodAdded.append(foods[index]);
+    }
+}
+
+void Arena::reset()
+{
+    int cells = width * height;
+    tickNo = 0;
+    timers.reset(tickNo);
+    occupancy.fill(CELL_EMPTY, cells);
+    foodAt.fill(-1, cells);
+    claimTick.fill(0, cells);
+    claimCount.fill(0, cells);
+    obstacles.clear();
+
+    alive.clear();
+    for (int id = 0; id < snakes.size(); ++id)
+    {
+        if (spawnSnake(id))
+            alive.append(id);
+    }
+
+    generateObstacles();
+
+    foods.resize(qMax(static_cast<int>(Game::FOOD_COUNT), static_cast<int>(snakes.size())));
+    foodTimer.fill(0, foods.size());
+    for (int i = 0; i < foods.size(); ++i)
+    {
+        foods[i].cell = -1;
+        spawnFood(i);
+    }
+}
+
+void Arena::setBotControlled(int id, bool bot)
+{
+    if (id < 0 || id >= snakes.size())
+        return;
+    snakes[id].isBot = bot;
+    snakes[id].targetCell = -1;
+}
+
+void Arena::changeDirection(int id, Direction dir)
+{
+    if (id < 0 || id >= snakes.size())
+        return;
+    ArenaSnake &s = snakes[id];
+    if (dir == oppositeDirection(s.direction))
+        return;
+    s.nextDirection = dir;
+}
+
+Direction Arena::botDirection(int id)
+{
+    ArenaSnake &s = snakes[id];
+    int head = s.headCell();
+
+    // Nouveau fruit visé uniquement quand le précédent a disparu
+    if (s.targetCell < 0 || foodAt[s.targetCell] < 0)
+    {
+        s.targetCell = -1;
+        int best = 0;
+        for (const ArenaFood &f : foods)
+        {
+            if (f.cell < 0)
+                continue;
+            int d = wrapDistance(head, f.cell);
+            if (s.targetCell < 0 || d < best)
+            {
+                best = d;
+                s.targetCell = f.cell;
+            }
+        }
+    }
+
+    Direction bestDir = s.direction;
+    int bestScore = INT_MIN;
+    for (int d = UP; d <= RIGHT; ++d)
+    {
+        Direction dir = static_cast<Direction>(d);
+        if (dir == oppositeDirection(s.direction))
+            continue;
+
+        int c = stepCell(head, dir);
+        if (occupancy[c] != CELL_EMPTY)
+            continue;
+
+        int score = (s.targetCell >= 0) ? -4 * wrapDistance(c, s.targetCell) : 0;
+        for (int n = UP; n <= RIGHT; ++n)
+        {
+            int nb = stepCell(c, static_cast<Direction>(n));
+            quint16 o = occupancy[nb];
+            if (o == CELL_EMPTY)
+                ++score;
+            else if (o != CELL_WALL && o - 1 != id && snakes[o - 1].headCell() == nb)
+                score -= 50;  // risque de face-à-face
+        }
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestDir = dir;
+        }
+    }
+    return bestDir;
+}
+
+void Arena::killSnake(int id)
+{
+    ArenaSnake &s = snakes[id];
+    for (int i = 0; i < s.length; ++i)
+        occupancy[s.segmentCell(i)] = CELL_EMPTY;
+    s.alive = false;
+    emit snakeDied(id);
+}
+
+void Arena::tick()
+{
+    if (isOver())
+        return;
+    ++tickNo;
+    delta.clear();
+    delta.tick = tickNo;
+
+    for (int id : alive)
+    {
+        if (snakes[id].isBot)
+            snakes[id].nextDirection = botDirection(id);
+    }
+
+    int n = alive.size();
+    targets.resize(n);
+    eats.resize(n);
+    dies.resize(n);
+    freed.resize(n);
+
+    // 1. Cases visées et réservations
+    for (int k = 0; k < n; ++k)
+    {
+        ArenaSnake &s = snakes[alive[k]];
+        s.direction = s.nextDirection;
+        int t = stepCell(s.headCell(), s.direction);
+        targets[k] = t;
+        eats[k] = foodAt[t] >= 0;
+        if (claimTick[t] != tickNo)
+        {
+            claimTick[t] = tickNo;
+            claimCount[t] = 1;
+        }
+        else
+        {
+            ++claimCount[t];
+        }
+    }
+
+    // 2. Les queues des serpents qui ne grandissent pas se libèrent
+    for (int k = 0; k < n; ++k)
+    {
+        ArenaSnake &s = snakes[alive[k]];
+        freed[k] = 0;
+        if (eats[k])
+            continue;
+        if (s.pendingGrowth > 0)
+        {
+            --s.pendingGrowth;
+            continue;
+        }
+        occupancy[s.tailCell()] = CELL_EMPTY;
+        s.popTail();
+        freed[k] = 1;
+    }
+
+    // 3. Collisions, évaluées sur le même état pour tous
+    for (int k = 0; k < n; ++k)
+    {
+        int t = targets[k];
+        dies[k] = claimCount[t] > 1 || occupancy[t] != CELL_EMPTY;
+    }
+
+    // 4. Déplacement des survivants, puis morts, puis nouveaux fruits
+    QVector<int> eatenFoods;
+    for (int k = 0; k < n; ++k)
+    {
+        if (dies[k])
+        {
+            delta.deaths.append(static_cast<quint16>(alive[k]));
+            continue;
+        }
+        int id = alive[k];
+        ArenaSnake &s = snakes[id];
+        int t = targets[k];
+        s.pushHead(t);
+        occupancy[t] = static_cast<quint16>(id + 1);
+        delta.moves.append(static_cast<quint8>((s.direction - 1) |
+                                               (freed[k] ? ArenaTickDelta::TAIL_REMOVED : 0) |
+                                               (eats[k] ? ArenaTickDelta::ATE : 0)));
+
+        if (eats[k])
+        {
+            int index = foodAt[t];
+            FruitType type = foods[index].type;
+            int points = fruitPoints(type);
+            s.score += points;
+            s.pendingGrowth += itemType(type).growth - 1;  // ce tick-ci compte déjà
+            removeFood(t);
+            eatenFoods.append(index);
+            delta.foodRemoved.append(t);
+            emit fruitEaten(id, cellX(t), cellY(t), points, type);
+        }
+    }
+
+    int kept = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        if (dies[k])
+            killSnake(alive[k]);
+        else
+            alive[kept++] = alive[k];
+    }
+    alive.resize(kept);
+
+    for (int index : eatenFoods)
+    {
+        spawnFood(index);
+        if (foods[index].cell >= 0)
+            delta.foodAdded.append(foods[index]);
+    }
+
+    // 5. Fruits éphémères, après les autres : une copie retire puis ajoute
+    // dans le même ordre
+    expireFoods();
+}
+
+bool Arena::applyDelta(const ArenaTickDelta &d)
+{
+    // Même ordre que tick() : morts d'abord (leur corps libère des cases
+    // que d'autres têtes peuvent prendre), puis queues, puis têtes
+    for (quint16 id : d.deaths)
+    {
+        int k = alive.indexOf(id);
+        if (k < 0)
+            return false;
+        alive.remove(k);
+        killSnake(id);
+    }
+    if (d.moves.size() != alive.size())
+        return false;
+
+    for (int k = 0; k < alive.size(); ++k)
+    {
+        ArenaSnake &s = snakes[alive[k]];
+        if (d.moves[k] & ArenaTickDelta::TAIL_REMOVED)
+        {
+            occupancy[s.tailCell()] = CELL_EMPTY;
+            s.popTail();
+        }
+        else if (!(d.moves[k] & ArenaTickDelta::ATE) && s.pendingGrowth > 0)
+        {
+            --s.pendingGrowth;  // même compte que tick()
+        }
+    }
+    for (int k = 0; k < alive.size(); ++k)
+    {
+        int id = alive[k];
+        ArenaSnake &s = snakes[id];
+        s.direction = static_cast<Direction>((d.moves[k] & ArenaTickDelta::DIR_MASK) + 1);
+        s.nextDirection = s.direction;
+        int t = stepCell(s.headCell(), s.direction);
+        s.pushHead(t);
+        occupancy[t] = static_cast<quint16>(id + 1);
+
+        if ((d.moves[k] & ArenaTickDelta::ATE) && foodAt[t] >= 0)
+        {
+            FruitType type = foods[foodAt[t]].type;
+            int points = fruitPoints(type);
+            s.score += points;
+            s.pendingGrowth += itemType(type).growth - 1;
+            emit fruitEaten(id, cellX(t), cellY(t), points, type);
+        }
+    }
+
+    // Les expirations viennent du serveur (foodRemoved) : la roue de la
+    // copie n'avance que pour le compte à rebours affiché
+    tickNo = d.tick;
+    while (timers.now() < tickNo)
+    {
+        firedTimers.clear();
+        timers.advance(firedTimers);
+    }
+
+    for (int cell : d.foodRemoved)
+    {
+        if (cell >= 0 && cell < foodAt.size() && foodAt[cell] >= 0)
+            removeFood(cell);
+    }
+    int slot = 0;
+    for (const ArenaFood &f : d.foodAdded)
+    {
+        while (slot < foods.size() && foods[slot].cell >= 0)
+            ++slot;
+        if (slot == foods.size())
+        {
+            foods.append(f);
+            foodTimer.append(0);
+        }
+        else
+        {
+            foods[slot] = f;
+        }
+        foodAt[f.cell] = slot;
+        scheduleExpiry(slot);
+    }
+    return true;
+}
+
+QByteArray Arena::saveState() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << STATE_VERSION << qint32(width) << qint32(height) << qint32(players)
+        << qint32(currentLevel) << tickNo;
+
+    out << qint32(obstacles.size());
+    for (const Obstacle &o : obstacles)
+        out << qint32(o.y * width + o.x);
+
+    out << qint32(snakes.size());
+    for (const ArenaSnake &s : snakes)
+    {
+        out << s.alive << s.isBot << qint32(s.direction) << qint32(s.score)
+            << qint32(s.pendingGrowth) << qint32(s.alive ? s.length : 0);
+        if (s.alive)
+        {
+            for (int i = s.length - 1; i >= 0; --i)
+                out << qint32(s.segmentCell(i));  // de la queue vers la tête
+        }
+    }
+
+    out << qint32(foods.size());
+    for (int i = 0; i < foods.size(); ++i)
+        out << qint32(foods[i].cell) << qint32(foods[i].type) << quint64(timers.dueTick(foodTimer[i]));
+    return data;
+}
+
+// L'état vient du réseau : chaque taille est bornée avant d'allouer, et
+// tout est lu puis vérifié dans des copies locales. Un état refusé laisse
+// l'arène inchangée.
+bool Arena::loadState(const QByteArray &data)
+{
+    QDataStream in(data);
+    quint32 version;
+    qint32 w, h, p, level, count;
+    quint32 tick;
+    in >> version >> w >> h >> p >> level >> tick;
+    if (version != STATE_VERSION || in.status() != QDataStream::Ok || w < 8 || w > MAX_SIDE
+        || h < 8 || h > MAX_SIDE || p < 0 || p > MAX_SNAKES || level < 1
+        || level > LevelTable::LEVEL_COUNT)
+        return false;
+    int cells = w * h;
+    auto adjacent = [w, h](int a, int b) {
+        int dx = qAbs(a % w - b % w);
+        int dy = qAbs(a / w - b / w);
+        return qMin(dx, w - dx) + qMin(dy, h - dy) == 1;
+    };
+
+    QVector<quint16> occ(cells, CELL_EMPTY);
+    QVector<Obstacle> walls;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0 || count > cells)
+        return false;
+    for (int i = 0; i < count; ++i)
+    {
+        qint32 cell;
+        in >> cell;
+        if (in.status() != QDataStream::Ok || cell < 0 || cell >= cells
+            || occ[cell] != CELL_EMPTY)
+            return false;
+        occ[cell] = CELL_WALL;
+        walls.push_back({cell % w, cell / w});
+    }
+
+    // Un serpent vivant a un corps d'un seul tenant, sans recouvrement ;
+    // un mort n'en a plus
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 1 || count > MAX_SNAKES || p > count)
+        return false;
+    QVector<ArenaSnake> bodies(count);
+    QVector<int> living;
+    for (int id = 0; id < count; ++id)
+    {
+        ArenaSnake &s = bodies[id];
+        qint32 dir, score, growth, length;
+        in >> s.alive >> s.isBot >> dir >> score >> growth >> length;
+        if (in.status() != QDataStream::Ok || dir < UP || dir > RIGHT || growth < 0
+            || length < 0 || length > cells || (s.alive ? length < 1 : length != 0))
+            return false;
+        s.direction = static_cast<Direction>(dir);
+        s.nextDirection = s.direction;
+        s.score = score;
+        s.pendingGrowth = growth;
+        s.targetCell = -1;
+        s.ring = QVector<int>(8);
+        s.tail = 0;
+        s.length = 0;
+        for (int i = 0; i < length; ++i)
+        {
+            qint32 cell;
+            in >> cell;
+            if (in.status() != QDataStream::Ok || cell < 0 || cell >= cells
+                || occ[cell] != CELL_EMPTY || (i > 0 && !adjacent(s.headCell(), cell)))
+                return false;
+            s.pushHead(cell);
+            occ[cell] = static_cast<quint16>(id + 1);
+        }
+        if (s.alive)
+            living.append(id);
+    }
+
+    // Case -1 : emplacement vide (plateau plein au tirage)
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0 || count > cells)
+        return false;
+    QVector<ArenaFood> fruits(count);
+    QVector<quint64> expiry(count);
+    QVector<qint32> fruitAt(cells, -1);
+    for (int i = 0; i < count; ++i)
+    {
+        qint32 cell, type;
+        in >> cell >> type >> expiry[i];
+        if (in.status() != QDataStream::Ok || cell < -1 || cell >= cells || type < 0
+            || type >= FRUIT_TYPE_COUNT
+            || (cell >= 0 && (occ[cell] != CELL_EMPTY || fruitAt[cell] >= 0)))
+            return false;
+        fruits[i].cell = cell;
+        fruits[i].type = static_cast<FruitType>(type);
+        if (cell >= 0)
+            fruitAt[cell] = i;
+    }
+
+    // État entièrement valide : l'arène est remplacée
+    width = w;
+    height = h;
+    players = p;
+    currentLevel = level;
+    tickNo = tick;
+    occupancy = occ;
+    foodAt = fruitAt;
+    claimTick.fill(0, cells);
+    claimCount.fill(0, cells);
+    obstacles = walls;
+    snakes = bodies;
+    alive = living;
+    foods = fruits;
+    foodTimer.fill(0, foods.size());
+    timers.reset(tickNo);
+    for (int i = 0; i < foods.size(); ++i)
+    {
+        if (foods[i].cell >= 0 && expiry[i] > tickNo)
+            foodTimer[i] = timers.schedule(expiry[i], 0, i);
+    }
+    return true;
+}
+
+bool Arena::isOver() const
+{
+    if (alive.isEmpty())
+        return true;
+    if (snakes.size() > 1 && alive.size() <= 1)
+        return true;
+    if (players == 0)
+        return false;
+    // Plus aucun joueur humain en vie
+    return alive.first() >= players;
+}
+
+int Arena::winner() const
+{
+    int best = -1;
+    for (int id = 0; id < snakes.size(); ++id)
+    {
+        if (best < 0 || snakes[id].score > snakes[best].score ||
+            (snakes[id].score == snakes[best].score && snakes[id].alive && !snakes[best].alive))
+            best = id;
+    }
+    return best;
+}
@@ -0,0 +1,170 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QObject>
+#include <QVector>
+#include <QRandomGenerator>
+#include "game.h"
+#include "timerwheel.h"
+
+// Un serpent de l'arène. Le corps est un anneau de cases (index
+// y * largeur + x) : ajout de tête et retrait de queue en O(1).
+struct ArenaSnake
+{
+    QVector<int> ring;   // capacité puissance de 2
+    int tail;            // position de la queue dans l'anneau
+    int length;
+    Direction direction;
+    Direction nextDirection;
+    int score;
+    int pendingGrowth;
+    bool alive;
+    bool isBot;
+    int targetCell;      // bots : case du fruit visé (-1 = à choisir)
+
+    int headCell() const { return ring[(tail + length - 1) & (ring.size() - 1)]; }
+    int tailCell() const { return ring[tail]; }
+    // i = 0 pour la tête, length - 1 pour la queue
+    int segmentCell(int i) const { return ring[(tail + length - 1 - i) & (ring.size() - 1)]; }
+
+    void pushHead(int cell);
+    void popTail();
+};
+
+struct ArenaFood
+{
+    int cell;
+    FruitType type;
+};
+
+// Changements d'un tick, assez pour rejouer le tick sur une copie
+// (client réseau) sans jamais transmettre un corps entier
+struct ArenaTickDelta
+{
+    enum MoveFlag : quint8
+    {
+        DIR_MASK = 0x03,       // direction - 1
+        TAIL_REMOVED = 0x04,
+        ATE = 0x08
+    };
+
+    quint32 tick;
+    QVector<quint16> deaths;       // serpents morts pendant ce tick
+    QVector<quint8> moves;         // un octet par survivant, ids croissants
+    QVector<int> foodRemoved;      // cases
+    QVector<ArenaFood> foodAdded;
+
+    void clear();
+};
+
+// Mode arène : 2 à 256 serpents (joueurs locaux et bots) sur un même
+// plateau. Les collisions passent par une grille d'occupation partagée,
+// si bien qu'un tick coûte O(têtes déplacées) et non O(serpents²).
+//
+// Règles d'un tick, toutes simultanées et indépendantes de l'ordre :
+//  - les serpents qui ne grandissent pas libèrent d'abord leur queue ;
+//  - plusieurs têtes sur la même case : toutes meurent (le fruit reste) ;
+//  - une tête sur une case occupée (mur, corps, tête adverse) meurt ;
+//  - le corps d'un serpent mort disparaît à la fin du tick.
+class Arena : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_SNAKES = 256;
+    static constexpr int MAX_SIDE = 1024;   // côté du plateau, en cases
+    static constexpr quint16 CELL_EMPTY = 0;
+    static constexpr quint16 CELL_WALL = 0xFFFF;  // sinon : id du serpent + 1
+
+    explicit Arena(QObject *parent = nullptr);
+
+    // Les joueurs occupent les premiers ids, les bots les suivants
+    void setup(int players, int bots, int width = WIDTH, int height = HEIGHT);
+    void setLevel(int level);
+    int getLevel() const { return currentLevel; }
+    int getSpeed() const;
+    // Vitesse et densité des murs isolés de chaque niveau
+    void setLevelTable(const LevelTable &table) { levels = table; }
+    void setSeed(quint32 seed) { rng.seed(seed); }
+
+    void reset();
+    void tick();
+    void changeDirection(int id, Direction dir);
+    void setBotControlled(int id, bool bot);
+
+    // Réplication : le serveur diffuse lastDelta(), les clients
+    // appliquent chaque delta à une copie chargée par loadState()
+    const ArenaTickDelta &lastDelta() const { return delta; }
+    bool applyDelta(const ArenaTickDelta &d);  // false : copie désynchronisée
+    QByteArray saveState() const;
+    bool loadState(const QByteArray &data);
+
+    int boardWidth() const { return width; }
+    int boardHeight() const { return height; }
+    int cellX(int cell) const { return cell % width; }
+    int cellY(int cell) const { return cell / width; }
+    int stepCell(int cell, Direction dir) const;
+    quint16 cellAt(int x, int y) const { return occupancy[y * width + x]; }
+
+    int snakeCount() const { return snakes.size(); }
+    int playerCount() const { return players; }
+    const ArenaSnake &snake(int id) const { return snakes[id]; }
+    int aliveCount() const { return alive.size(); }
+    bool isOver() const;
+    int winner() const;  // id du meilleur score (-1 si aucun serpent)
+    quint32 tickCount() const { return tickNo; }
+
+    int foodCount() const { return foods.size(); }
+    int foodX(int i) const { return cellX(foods[i].cell); }
+    int foodY(int i) const { return cellY(foods[i].cell); }
+    FruitType foodType(int i) const { return foods[i].type; }
+    int foodTicksLeft(int i) const;  // -1 : fruit permanent
+    const QVector<Obstacle> &getObstacles() const { return obstacles; }
+
+signals:
+    void fruitEaten(int snakeId, int x, int y, int points, FruitType type);
+    void snakeDied(int snakeId);
+
+private:
+    int width;
+    int height;
+    int players;
+    int currentLevel;
+    LevelTable levels;
+    quint32 tickNo;
+    QRandomGenerator rng;
+
+    QVector<ArenaSnake> snakes;
+    QVector<int> alive;          // ids vivants, croissants
+    QVector<quint16> occupancy;  // une entrée par case
+    QVector<qint32> foodAt;      // case -> index dans foods (-1 = aucun)
+    QVector<ArenaFood> foods;
+    QVector<Obstacle> obstacles;
+
+    // Fruits éphémères : une échéance par fruit, au pas d'apparition plus
+    // sa durée de vie. Une copie la retrouve depuis la table des objets.
+    TimerWheel timers;
+    QVector<TimerWheel::TimerId> foodTimer;  // par index de foods
+    QVector<TimerEvent> firedTimers;
+
+    // Réservations de cases du tick courant (horodatées : jamais remises à zéro)
+    QVector<quint32> claimTick;
+    QVector<quint16> claimCount;
+    QVector<int> targets;        // par serpent vivant, même ordre que alive
+    QVector<char> eats;
+    QVector<char> dies;
+    QVector<char> freed;
+    ArenaTickDelta delta;
+
+    bool spawnSnake(int id);
+    void killSnake(int id);
+    void generateObstacles();
+    void spawnFood(int index);
+    void removeFood(int cell);
+    void scheduleExpiry(int index);
+    void expireFoods();
+    Direction botDirection(int id);
+    int wrapDistance(int a, int b) const;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,105 @@
+#ifndef BOTAPI_H
+#define BOTAPI_H
+
+// Interface des bots chargés à l'exécution (bibliothèques partagées, voir
+// bots/ et snake_tournament). Aucun en-tête Qt ici : un bot se compile
+// avec ce seul fichier. Les structures n'ont que des types de taille fixe
+// et la version est vérifiée au chargement ; une bibliothèque compilée
+// pour une autre version est refusée plutôt que mal lue.
+//
+// À chaque pas, l'hôte remplit une BotView (le plateau vu par un serpent)
+// et appelle decide(). Une réponse rendue après budgetNs est ignorée : le
+// serpent garde sa direction. Une instance ne sert qu'à un thread à la
+// fois ; l'hôte en crée une par thread.
+
+#include <cstdint>
+
+#define BOT_API_VERSION 1
+
+// Mêmes valeurs que l'enum Direction du jeu
+enum BotDirection : int32_t
+{
+    BOT_UP = 1,
+    BOT_DOWN = 2,
+    BOT_LEFT = 3,
+    BOT_RIGHT = 4
+};
+
+// Contenu d'une case (mêmes codes que EnvCell)
+enum BotCell : uint8_t
+{
+    BOT_CELL_EMPTY = 0,
+    BOT_CELL_WALL = 1,
+    BOT_CELL_BODY = 2,   // corps de n'importe quel serpent
+    BOT_CELL_HEAD = 3,
+    BOT_CELL_FOOD = 4,   // + FruitType
+    BOT_CELL_HAZARD = 32
+};
+
+struct BotSnake
+{
+    int32_t headX;
+    int32_t headY;
+    int32_t direction;   // BotDirection
+    int32_t length;
+    int32_t score;
+    uint32_t alive;
+};
+
+struct BotFood
+{
+    int32_t x;
+    int32_t y;
+    int32_t type;        // FruitType
+    int32_t points;      // négatif : objet piégé
+};
+
+// Plateau torique : sortir d'un bord fait entrer par l'autre
+struct BotView
+{
+    int32_t width;
+    int32_t height;
+    const uint8_t *cells;     // width * height, ligne par ligne (BotCell)
+    int32_t self;             // index du serpent joué dans snakes
+    int32_t snakeCount;
+    const BotSnake *snakes;
+    int32_t foodCount;
+    const BotFood *foods;
+    uint64_t tick;
+    int64_t budgetNs;         // temps accordé à decide() ; 0 : illimité
+};
+
+class SnakeBot
+{
+public:
+    virtual ~SnakeBot() {}
+
+    // Début d'une partie ; un bot aléatoire en tire sa graine pour que
+    // deux tournois de même graine soient identiques
+    virtual void newGame(uint32_t seed) { (void)seed; }
+    // Direction du prochain pas (BotDirection) ; toute autre valeur, ou le
+    // demi-tour, laisse le serpent continuer tout droit
+    virtual int32_t decide(const BotView &view) = 0;
+};
+
+// Points d'entrée de la bibliothèque, résolus par nom
+typedef uint32_t (*BotApiVersionFn)();
+typedef const char *(*BotNameFn)();
+typedef SnakeBot *(*BotCreateFn)();
+typedef void (*BotDestroyFn)(SnakeBot *);
+
+#if defined(_WIN32)
+#define BOT_EXPORT extern "C" __declspec(dllexport)
+#else
+#define BOT_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+// À placer une fois dans la bibliothèque d'un bot. La destruction passe
+// par la bibliothèque : l'instance est libérée par l'allocateur qui l'a créée.
+#define SNAKE_BOT_PLUGIN(BotClass, botName)                                    \
+    BOT_EXPORT uint32_t snake_bot_api_version() { return BOT_API_VERSION; }    \
+    BOT_EXPORT const char *snake_bot_name() { return botName; }                \
+    BOT_EXPORT SnakeBot *snake_bot_create() { return new BotClass(); }         \
+    BOT_EXPORT void snake_bot_destroy(SnakeBot *bot) { delete bot; }
+
+#endif // BOTAPI_H
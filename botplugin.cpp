@@ -0,0 +1,162 @@
+#include "botplugin.h"
+
+#include <cstring>
+#include "arena.h"
+#include "game.h"
+
+static_assert(int(BOT_UP) == UP && int(BOT_DOWN) == DOWN && int(BOT_LEFT) == LEFT
+                  && int(BOT_RIGHT) == RIGHT,
+              "BotDirection doit suivre Direction");
+
+bool BotPlugin::load(const QString &path, QString *error)
+{
+    library.setFileName(path);
+    if (!library.load())
+    {
+        if (error)
+            *error = library.errorString();
+        return false;
+    }
+    auto version = reinterpret_cast<BotApiVersionFn>(library.resolve("snake_bot_api_version"));
+    auto nameFn = reinterpret_cast<BotNameFn>(library.resolve("snake_bot_name"));
+    createFn = reinterpret_cast<BotCreateFn>(library.resolve("snake_bot_create"));
+    destroyFn = reinterpret_cast<BotDestroyFn>(library.resolve("snake_bot_destroy"));
+    if (!version || !nameFn || !createFn || !destroyFn)
+    {
+        if (error)
+            *error = "pas un bot (SNAKE_BOT_PLUGIN absent)";
+        return false;
+    }
+    if (version() != BOT_API_VERSION)
+    {
+        if (error)
+            *error = QString("bot compile pour l'API %1 (attendue : %2)")
+                         .arg(version()).arg(BOT_API_VERSION);
+        return false;
+    }
+    botName = QString::fromUtf8(nameFn());
+    return true;
+}
+
+const BotView &BotObserver::observe(const Game &game, qint64 budgetNs)
+{
+    filledArena = nullptr;
+    int w = game.boardWidth(), h = game.boardHeight();
+    cells.resize(w * h);
+    uint8_t *grid = cells.data();
+    memset(grid, BOT_CELL_EMPTY, size_t(w) * h);
+    const WallGrid &walls = game.wallGrid();
+    for (int y = 0; y < h; ++y)
+    {
+        const uchar *row = walls.row(y);
+        for (int x = 0; x < w; x += 8)
+        {
+            // Octets vides sautés d'un coup, comme EnvServer
+            if (!row[x >> 3])
+                continue;
+            for (int b = x; b < x + 8 && b < w; ++b)
+            {
+                if (walls.isWall(b, y))
+                    grid[y * w + b] = BOT_CELL_WALL;
+            }
+        }
+    }
+
+    foods.resize(game.foodCount());
+    for (int k = 0; k < game.foodCount(); ++k)
+    {
+        BotFood &food = foods[k];
+        food.x = game.foodX(k);
+        food.y = game.foodY(k);
+        food.type = game.foodType(k);
+        food.points = fruitPoints(game.foodType(k));
+        grid[food.y * w + food.x] = uint8_t(BOT_CELL_FOOD + food.type);
+    }
+    const HazardField &hazards = game.hazardField();
+    for (int k = 0; k < hazards.count(); ++k)
+        grid[hazards.hazard(k).y * w + hazards.hazard(k).x] = BOT_CELL_HAZARD;
+    uint8_t cell = BOT_CELL_HEAD;
+    for (PackedBody::Cursor c = game.snakeBody().cursor(); c.valid(); c.next())
+    {
+        grid[c.y() * w + c.x()] = cell;
+        cell = BOT_CELL_BODY;
+    }
+
+    snakes.resize(1);
+    BotSnake &self = snakes[0];
+    self.headX = game.headX();
+    self.headY = game.headY();
+    self.direction = game.getDirection();
+    self.length = game.getLength();
+    self.score = game.getScore();
+    self.alive = game.isGameOver() ? 0 : 1;
+    return finish(w, h, 0, game.tickCount(), budgetNs);
+}
+
+const BotView &BotObserver::observe(const Arena &arena, int self, qint64 budgetNs)
+{
+    int w = arena.boardWidth(), h = arena.boardHeight();
+    if (filledArena == &arena && filledTick == arena.tickCount())
+        return finish(w, h, self, arena.tickCount(), budgetNs);
+    filledArena = &arena;
+    filledTick = arena.tickCount();
+    cells.resize(w * h);
+    uint8_t *grid = cells.data();
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            quint16 owner = arena.cellAt(x, y);
+            grid[y * w + x] = owner == Arena::CELL_EMPTY ? BOT_CELL_EMPTY
+                            : owner == Arena::CELL_WALL  ? BOT_CELL_WALL
+                                                         : BOT_CELL_BODY;
+        }
+    }
+
+    // Un fruit non replacé (plateau plein) n'a pas de case
+    foods.resize(0);
+    for (int k = 0; k < arena.foodCount(); ++k)
+    {
+        if (arena.foodX(k) < 0)
+            continue;
+        BotFood food;
+        food.x = arena.foodX(k);
+        food.y = arena.foodY(k);
+        food.type = arena.foodType(k);
+        food.points = fruitPoints(arena.foodType(k));
+        grid[food.y * w + food.x] = uint8_t(BOT_CELL_FOOD + food.type);
+        foods.append(food);
+    }
+
+    snakes.resize(arena.snakeCount());
+    for (int id = 0; id < arena.snakeCount(); ++id)
+    {
+        const ArenaSnake &s = arena.snake(id);
+        BotSnake &out = snakes[id];
+        out.alive = s.alive ? 1 : 0;
+        out.length = s.alive ? s.length : 0;
+        out.direction = s.direction;
+        out.score = s.score;
+        out.headX = s.alive ? arena.cellX(s.headCell()) : -1;
+        out.headY = s.alive ? arena.cellY(s.headCell()) : -1;
+        if (s.alive)
+            grid[s.headCell()] = BOT_CELL_HEAD;
+    }
+    return finish(w, h, self, arena.tickCount(), budgetNs);
+}
+
+const BotView &BotObserver::finish(int width, int height, int self, quint64 tick,
+                                   qint64 budgetNs)
+{
+    view.width = width;
+    view.height = height;
+    view.cells = cells.constData();
+    view.self = self;
+    view.snakeCount = snakes.size();
+    view.snakes = snakes.constData();
+    view.foodCount = foods.size();
+    view.foods = foods.constData();
+    view.tick = tick;
+    view.budgetNs = budgetNs;
+    return view;
+}
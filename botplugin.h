@@ -0,0 +1,62 @@
+#ifndef BOTPLUGIN_H
+#define BOTPLUGIN_H
+
+#include <QLibrary>
+#include <QString>
+#include <QVector>
+#include "botapi.h"
+#include "direction.h"
+
+class Arena;
+class Game;
+
+// Bot chargé depuis une bibliothèque partagée (botapi.h). Les instances
+// créées doivent être rendues par destroy(), jamais par delete.
+class BotPlugin
+{
+public:
+    bool load(const QString &path, QString *error = nullptr);
+
+    QString name() const { return botName; }
+    QString path() const { return library.fileName(); }
+    SnakeBot *create() const { return createFn(); }
+    void destroy(SnakeBot *bot) const { destroyFn(bot); }
+
+private:
+    QLibrary library;
+    QString botName;
+    BotCreateFn createFn = nullptr;
+    BotDestroyFn destroyFn = nullptr;
+};
+
+// Réponse de decide() : une direction valide, sinon on continue tout droit
+inline Direction botDecision(int32_t value, Direction current)
+{
+    if (value < BOT_UP || value > BOT_RIGHT)
+        return current;
+    return static_cast<Direction>(value);
+}
+
+// Plateau vu par un serpent. Les tampons sont gardés d'un pas à l'autre :
+// une observation n'alloue plus après la première. Dans l'arène, les
+// serpents d'un même pas partagent la grille remplie pour le premier.
+class BotObserver
+{
+public:
+    const BotView &observe(const Game &game, qint64 budgetNs);
+    const BotView &observe(const Arena &arena, int self, qint64 budgetNs);
+    // À appeler après Arena::reset() : le pas 0 d'une autre partie
+    void newGame() { filledArena = nullptr; }
+
+private:
+    QVector<uint8_t> cells;
+    QVector<BotSnake> snakes;
+    QVector<BotFood> foods;
+    BotView view;
+    const Arena *filledArena = nullptr;   // grille de ce pas de l'arène
+    quint32 filledTick = 0;
+
+    const BotView &finish(int width, int height, int self, quint64 tick, qint64 budgetNs);
+};
+
+#endif // BOTPLUGIN_H
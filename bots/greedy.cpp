@@ -0,0 +1,59 @@
+// Bot glouton : le fruit (non piégé) le plus proche, par le plus court
+// chemin sur le tore, sans entrer dans une case occupée. Sert de référence
+// pour snake_tournament ; ne dépend que de botapi.h.
+
+#include "botapi.h"
+#include <cstdlib>
+
+class GreedyBot : public SnakeBot
+{
+public:
+    int32_t decide(const BotView &view) override
+    {
+        const BotSnake &me = view.snakes[view.self];
+        int32_t best = me.direction;
+        int bestDist = view.width + view.height + 1;
+        for (int32_t d = BOT_UP; d <= BOT_RIGHT; ++d)
+        {
+            if (d == opposite(me.direction))
+                continue;
+            int x = (me.headX + (d == BOT_RIGHT) - (d == BOT_LEFT) + view.width) % view.width;
+            int y = (me.headY + (d == BOT_DOWN) - (d == BOT_UP) + view.height) % view.height;
+            uint8_t cell = view.cells[y * view.width + x];
+            if (cell != BOT_CELL_EMPTY && (cell < BOT_CELL_FOOD || cell >= BOT_CELL_HAZARD))
+                continue;
+            int dist = view.width + view.height;
+            for (int i = 0; i < view.foodCount; ++i)
+            {
+                if (view.foods[i].points <= 0)
+                    continue;
+                int dx = std::abs(view.foods[i].x - x), dy = std::abs(view.foods[i].y - y);
+                int wrapped = (dx < view.width - dx ? dx : view.width - dx)
+                            + (dy < view.height - dy ? dy : view.height - dy);
+                if (wrapped < dist)
+                    dist = wrapped;
+            }
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                best = d;
+            }
+        }
+        return best;
+    }
+
+private:
+    static int32_t opposite(int32_t d)
+    {
+        switch (d)
+        {
+        case BOT_UP: return BOT_DOWN;
+        case BOT_DOWN: return BOT_UP;
+        case BOT_LEFT: return BOT_RIGHT;
+        case BOT_RIGHT: return BOT_LEFT;
+        }
+        return 0;
+    }
+};
+
+SNAKE_BOT_PLUGIN(GreedyBot, "glouton")
@@ -0,0 +1,119 @@
+// Bot prudent : parmi les pas sûrs, celui qui garde la plus grande zone
+// libre accessible (remplissage par diffusion), puis le plus proche d'un
+// fruit. Le remplissage est borné à la longueur du serpent plus une marge :
+// au-delà, la zone suffit et chercher plus loin ne ferait que coûter.
+
+#include "botapi.h"
+#include <cstdlib>
+#include <vector>
+
+class SurvivorBot : public SnakeBot
+{
+public:
+    int32_t decide(const BotView &view) override
+    {
+        const BotSnake &me = view.snakes[view.self];
+        int cells = view.width * view.height;
+        if (int(seen.size()) != cells)
+        {
+            seen.assign(cells, 0);
+            stamp = 0;
+        }
+        int limit = me.length + 2 * (view.width + view.height);
+
+        int32_t best = me.direction;
+        int bestArea = -1;
+        int bestDist = 0;
+        for (int32_t d = BOT_UP; d <= BOT_RIGHT; ++d)
+        {
+            if (d == opposite(me.direction))
+                continue;
+            int next = step(view, me.headY * view.width + me.headX, d);
+            if (!isFree(view.cells[next]))
+                continue;
+            int area = floodArea(view, next, limit);
+            int dist = foodDistance(view, next);
+            if (area > bestArea || (area == bestArea && dist < bestDist))
+            {
+                best = d;
+                bestArea = area;
+                bestDist = dist;
+            }
+        }
+        return best;
+    }
+
+private:
+    std::vector<uint32_t> seen;   // horodaté : jamais remis à zéro
+    uint32_t stamp = 0;
+    std::vector<int> queue;
+
+    static bool isFree(uint8_t cell)
+    {
+        return cell == BOT_CELL_EMPTY || (cell >= BOT_CELL_FOOD && cell < BOT_CELL_HAZARD);
+    }
+
+    static int32_t opposite(int32_t d)
+    {
+        switch (d)
+        {
+        case BOT_UP: return BOT_DOWN;
+        case BOT_DOWN: return BOT_UP;
+        case BOT_LEFT: return BOT_RIGHT;
+        case BOT_RIGHT: return BOT_LEFT;
+        }
+        return 0;
+    }
+
+    static int step(const BotView &view, int cell, int32_t d)
+    {
+        int x = cell % view.width, y = cell / view.width;
+        x = (x + (d == BOT_RIGHT) - (d == BOT_LEFT) + view.width) % view.width;
+        y = (y + (d == BOT_DOWN) - (d == BOT_UP) + view.height) % view.height;
+        return y * view.width + x;
+    }
+
+    int floodArea(const BotView &view, int start, int limit)
+    {
+        if (++stamp == 0)
+        {
+            seen.assign(seen.size(), 0);
+            stamp = 1;
+        }
+        queue.clear();
+        queue.push_back(start);
+        seen[start] = stamp;
+        for (size_t i = 0; i < queue.size() && int(queue.size()) < limit; ++i)
+        {
+            for (int32_t d = BOT_UP; d <= BOT_RIGHT; ++d)
+            {
+                int next = step(view, queue[i], d);
+                if (seen[next] != stamp && isFree(view.cells[next]))
+                {
+                    seen[next] = stamp;
+                    queue.push_back(next);
+                }
+            }
+        }
+        return int(queue.size());
+    }
+
+    static int foodDistance(const BotView &view, int cell)
+    {
+        int x = cell % view.width, y = cell / view.width;
+        int dist = view.width + view.height;
+        for (int i = 0; i < view.foodCount; ++i)
+        {
+            if (view.foods[i].points <= 0)
+                continue;
+            int dx = std::abs(view.foods[i].x - x), dy = std::abs(view.foods[i].y - y);
+            int wrapped = (dx < view.width - dx ? dx : view.width - dx)
+                        + (dy < view.height - dy ? dy : view.height - dy);
+            if (wrapped < dist)
+                dist = wrapped;
+        }
+        return dist;
+    }
+};
+
+SNAKE_BOT_PLUGIN(SurvivorBot, "prudent")
@@ -0,0 +1,24 @@
+#ifndef DIRECTION_H
+#define DIRECTION_H
+
+enum Direction
+{
+    UP = 1,
+    DOWN = 2,
+    LEFT = 3,
+    RIGHT = 4
+};
+
+inline Direction oppositeDirection(Direction d)
+{
+    switch (d)
+    {
+    case UP: return DOWN;
+    case DOWN: return UP;
+    case LEFT: return RIGHT;
+    case RIGHT: return LEFT;
+    }
+    return d;
+}
+
+#endif // DIRECTION_H
@@ -0,0 +1,211 @@
+#include "envchannel.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ENV_CPU_RELAX() _mm_pause()
+#else
+#define ENV_CPU_RELAX() ((void)0)
+#endif
+
+static long futexCall(std::atomic<uint32_t> *addr, int op, uint32_t val,
+                      const timespec *timeout)
+{
+    // Pas de FUTEX_PRIVATE_FLAG : le mot est partagé entre processus
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(addr), op, val,
+                   timeout, nullptr, 0);
+}
+
+EnvChannel::EnvChannel()
+    : mem(nullptr),
+    owner(false)
+{
+}
+
+EnvChannel::~EnvChannel()
+{
+    close();
+}
+
+// Pid du serveur qui a créé le segment `name`, 0 s'il n'est plus en vie
+// (ou si le segment n'a jamais été initialisé)
+static pid_t liveOwner(const char *name)
+{
+    int fd = shm_open(name, O_RDONLY, 0600);
+    if (fd < 0)
+        return 0;
+    struct stat st;
+    void *p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(EnvShared)))
+        p = mmap(nullptr, sizeof(EnvShared), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        return 0;
+    pid_t pid = static_cast<pid_t>(static_cast<const EnvShared *>(p)->serverPid);
+    munmap(p, sizeof(EnvShared));
+    // EPERM : le processus existe, sous un autre utilisateur
+    if (pid > 0 && (kill(pid, 0) == 0 || errno == EPERM))
+        return pid;
+    return 0;
+}
+
+bool EnvChannel::create(const QString &name)
+{
+    close();
+    QByteArray n = name.toLocal8Bit();
+
+    // Un segment existant n'est repris que si son serveur est mort
+    int fd = shm_open(n.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST)
+    {
+        if (pid_t pid = liveOwner(n.constData()))
+        {
+            error = QString("segment %1 deja utilise par le serveur %2").arg(name).arg(pid);
+            return false;
+        }
+        shm_unlink(n.constData());  // segment orphelin d'un serveur précédent
+        fd = shm_open(n.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0)
+    {
+        error = QString("shm_open : %1").arg(strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(EnvShared)) != 0)
+    {
+        error = QString("ftruncate : %1").arg(strerror(errno));
+        ::close(fd);
+        shm_unlink(n.constData());
+        return false;
+    }
+
+    void *p = mmap(nullptr, sizeof(EnvShared), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        error = QString("mmap : %1").arg(strerror(errno));
+        shm_unlink(n.constData());
+        return false;
+    }
+
+    // Le segment sort de ftruncate rempli de zéros
+    mem = static_cast<EnvShared *>(p);
+    mem->maxBatch = ENV_MAX_BATCH;
+    mem->ringSlots = ENV_RING_SLOTS;
+    mem->gridWidth = ENV_GRID_WIDTH;
+    mem->gridHeight = ENV_GRID_HEIGHT;
+    mem->serverPid = static_cast<uint32_t>(getpid());
+    mem->version = ENV_PROTOCOL_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    mem->magic = ENV_SHM_MAGIC;
+
+    shmName = name;
+    owner = true;
+    return true;
+}
+
+bool EnvChannel::open(const QString &name)
+{
+    close();
+    QByteArray n = name.toLocal8Bit();
+    int fd = shm_open(n.constData(), O_RDWR, 0600);
+    if (fd < 0)
+    {
+        error = QString("shm_open : %1").arg(strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(EnvShared)))
+    {
+        error = "segment trop petit ou inaccessible";
+        ::close(fd);
+        return false;
+    }
+
+    void *p = mmap(nullptr, sizeof(EnvShared), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        error = QString("mmap : %1").arg(strerror(errno));
+        return false;
+    }
+
+    EnvShared *s = static_cast<EnvShared *>(p);
+    if (s->magic != ENV_SHM_MAGIC || s->version != ENV_PROTOCOL_VERSION)
+    {
+        error = "version de protocole incompatible";
+        munmap(p, sizeof(EnvShared));
+        return false;
+    }
+
+    mem = s;
+    shmName = name;
+    owner = false;
+    return true;
+}
+
+void EnvChannel::close()
+{
+    if (!mem)
+        return;
+    munmap(mem, sizeof(EnvShared));
+    mem = nullptr;
+    if (owner)
+        shm_unlink(shmName.toLocal8Bit().constData());
+    owner = false;
+}
+
+void EnvChannel::publish(EnvCounter &counter, uint32_t value)
+{
+    counter.value.store(value, std::memory_order_seq_cst);
+    if (counter.waiters.load(std::memory_order_seq_cst) > 0)
+        futexCall(&counter.value, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+uint32_t EnvChannel::waitChange(EnvCounter &counter, uint32_t seen,
+                                int spinCount, int timeoutMs)
+{
+    for (int i = 0; i < spinCount; ++i)
+    {
+        uint32_t v = counter.value.load(std::memory_order_acquire);
+        if (v != seen)
+            return v;
+        ENV_CPU_RELAX();
+    }
+
+    timespec ts;
+    timespec *timeout = nullptr;
+    if (timeoutMs >= 0)
+    {
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+        timeout = &ts;
+    }
+
+    counter.waiters.fetch_add(1, std::memory_order_seq_cst);
+    uint32_t v = counter.value.load(std::memory_order_seq_cst);
+    while (v == seen)
+    {
+        // Retourne aussitôt (EAGAIN) si la valeur a déjà changé
+        long r = futexCall(&counter.value, FUTEX_WAIT, seen, timeout);
+        v = counter.value.load(std::memory_order_acquire);
+        if (r != 0 && errno == ETIMEDOUT)
+            break;
+    }
+    counter.waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return v;
+}
@@ -0,0 +1,41 @@
+#ifndef ENVCHANNEL_H
+#define ENVCHANNEL_H
+
+#include <QString>
+#include "envprotocol.h"
+
+// Segment de mémoire partagée POSIX + signalisation futex entre le serveur
+// d'environnement et un entraîneur. Linux uniquement.
+class EnvChannel
+{
+public:
+    EnvChannel();
+    ~EnvChannel();
+
+    bool create(const QString &name);  // côté serveur : crée et initialise
+    bool open(const QString &name);    // côté client : s'attache
+    void close();
+
+    EnvShared *shared() const { return mem; }
+    QString errorString() const { return error; }
+
+    // Publie une nouvelle valeur et réveille les processus endormis dessus
+    static void publish(EnvCounter &counter, uint32_t value);
+
+    // Attend que counter.value != seen : attente active pendant spinCount
+    // itérations, puis futex. Retourne la nouvelle valeur, ou seen si
+    // timeoutMs (>= 0) s'est écoulé.
+    static uint32_t waitChange(EnvCounter &counter, uint32_t seen,
+                               int spinCount, int timeoutMs = -1);
+
+private:
+    EnvShared *mem;
+    QString shmName;
+    bool owner;
+    QString error;
+
+    EnvChannel(const EnvChannel &) = delete;
+    EnvChannel &operator=(const EnvChannel &) = delete;
+};
+
+#endif // ENVCHANNEL_H
@@ -0,0 +1,83 @@
+#include "envclient.h"
+
+#include <cstring>
+
+static const int CLIENT_SPIN = 1000000;
+
+EnvClient::EnvClient()
+    : submitted(0),
+    received(0)
+{
+}
+
+bool EnvClient::connectTo(const QString &name)
+{
+    if (!channel.open(name))
+        return false;
+    EnvShared *s = channel.shared();
+    submitted = s->requestHead.value.load(std::memory_order_acquire);
+    received = s->responseHead.value.load(std::memory_order_acquire);
+    return true;
+}
+
+EnvRequest *EnvClient::beginRequest()
+{
+    EnvShared *s = channel.shared();
+    // Anneau plein : on consomme d'abord la plus ancienne réponse
+    if (submitted - received >= ENV_RING_SLOTS)
+        waitResponse();
+    return &s->requests[submitted % ENV_RING_SLOTS];
+}
+
+void EnvClient::submit()
+{
+    ++submitted;
+    EnvChannel::publish(channel.shared()->requestHead, submitted);
+}
+
+const EnvResponse *EnvClient::waitResponse()
+{
+    EnvShared *s = channel.shared();
+    uint32_t head = s->responseHead.value.load(std::memory_order_acquire);
+    while (head == received)
+        head = EnvChannel::waitChange(s->responseHead, received, CLIENT_SPIN);
+    return &s->responses[received++ % ENV_RING_SLOTS];
+}
+
+const EnvResponse *EnvClient::reset(int count, quint32 seed, int level, quint32 flags, int foodCount,
+                                     int hazardCount)
+{
+    EnvRequest *req = beginRequest();
+    req->op = ENV_OP_RESET;
+    req->count = static_cast<uint32_t>(count);
+    req->flags = flags;
+    req->seed = seed;
+    req->level = static_cast<uint32_t>(level);
+    req->foodCount = static_cast<uint32_t>(qMax(0, foodCount));
+    req->hazardCount = static_cast<uint32_t>(qMax(0, hazardCount));
+    submit();
+    return waitResponse();
+}
+
+const EnvResponse *EnvClient::step(const uint8_t *actions, int count, quint32 flags)
+{
+    EnvRequest *req = beginRequest();
+    req->op = ENV_OP_STEP;
+    req->count = static_cast<uint32_t>(count);
+    req->flags = flags;
+    memcpy(req->actions, actions, count);
+    submit();
+    return waitResponse();
+}
+
+void EnvClient::close()
+{
+    if (!channel.shared())
+        return;
+    EnvRequest *req = beginRequest();
+    req->op = ENV_OP_CLOSE;
+    req->count = 0;
+    submit();
+    waitResponse();
+    channel.close();
+}
@@ -0,0 +1,33 @@
+#ifndef ENVCLIENT_H
+#define ENVCLIENT_H
+
+#include "envchannel.h"
+
+// Client de référence du serveur d'environnement. Un entraîneur réel
+// reproduit simplement ces quelques lignes sur le segment partagé.
+class EnvClient
+{
+public:
+    EnvClient();
+
+    bool connectTo(const QString &name = ENV_DEFAULT_NAME);
+    QString errorString() const { return channel.errorString(); }
+
+    // Les réponses restent valides jusqu'à la requête ENV_RING_SLOTS suivante
+    const EnvResponse *reset(int count, quint32 seed, int level, quint32 flags = 0,
+                             int foodCount = 0, int hazardCount = 0);
+    const EnvResponse *step(const uint8_t *actions, int count, quint32 flags = 0);
+    void close();
+
+    // Envoi sans attente (pipeline jusqu'à ENV_RING_SLOTS requêtes)
+    EnvRequest *beginRequest();
+    void submit();
+    const EnvResponse *waitResponse();
+
+private:
+    EnvChannel channel;
+    uint32_t submitted;
+    uint32_t received;
+};
+
+#endif // ENVCLIENT_H
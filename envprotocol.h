@@ -0,0 +1,132 @@
+#ifndef ENVPROTOCOL_H
+#define ENVPROTOCOL_H
+
+// Format binaire du serveur d'environnement (mémoire partagée POSIX).
+// Aucun en-tête Qt ici : un entraîneur externe (C, C++, Python via
+// ctypes/numpy) peut reproduire ces structures telles quelles. Aucune
+// sérialisation : le client écrit une requête dans un emplacement de
+// l'anneau, le serveur écrit la réponse dans l'emplacement de même index.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#define ENV_SHM_MAGIC 0x534E4B45u  // "SNKE"
+#define ENV_PROTOCOL_VERSION 4
+#define ENV_DEFAULT_NAME "/snake_env"
+
+#define ENV_MAX_BATCH 256
+#define ENV_RING_SLOTS 4
+#define ENV_GRID_WIDTH 40
+#define ENV_GRID_HEIGHT 25
+#define ENV_OBS_FOOD 3
+
+// Opérations
+enum EnvOp : uint32_t
+{
+    ENV_OP_RESET = 1,
+    ENV_OP_STEP = 2,
+    ENV_OP_CLOSE = 3
+};
+
+// Options de requête (combinables)
+enum EnvFlag : uint32_t
+{
+    ENV_FLAG_GRID = 1u << 0,        // remplir EnvResponse::grid
+    ENV_FLAG_AUTO_RESET = 1u << 1,  // un jeu terminé repart au STEP suivant
+    ENV_FLAG_END_DOOMED = 1u << 2   // un jeu condamné est terminé tout de suite
+};
+
+// Contenu d'une case de la grille d'observation
+enum EnvCell : uint8_t
+{
+    ENV_CELL_EMPTY = 0,
+    ENV_CELL_WALL = 1,
+    ENV_CELL_BODY = 2,
+    ENV_CELL_HEAD = 3,
+    ENV_CELL_FOOD = 4,  // + FruitType
+    ENV_CELL_HAZARD = 32
+};
+
+enum EnvStatus : uint32_t
+{
+    ENV_STATUS_OK = 0,
+    ENV_STATUS_BAD_REQUEST = 1
+};
+
+struct EnvGameObs
+{
+    int32_t headX;
+    int32_t headY;
+    int32_t direction;  // valeurs de l'enum Direction
+    int32_t length;
+    int32_t score;
+    int32_t reward;     // points gagnés pendant ce pas
+    uint32_t done;
+    uint32_t ticks;     // pas joués depuis le dernier reset
+    int32_t foodX[ENV_OBS_FOOD];  // premiers fruits ; tous dans la grille
+    int32_t foodY[ENV_OBS_FOOD];
+    int32_t foodType[ENV_OBS_FOOD];
+    uint32_t doomed;    // perdu quoi qu'on joue (voir Game::isDoomed)
+    int32_t reachable;  // cases libres accessibles depuis la tête
+};
+
+struct EnvRequest
+{
+    uint32_t op;
+    uint32_t count;   // nombre de jeux du lot (<= ENV_MAX_BATCH)
+    uint32_t flags;
+    uint32_t seed;    // RESET : le jeu i reçoit la graine seed + i
+    uint32_t level;   // RESET : niveau 1..3
+    uint32_t foodCount;  // RESET : fruits par jeu, 0 = Game::FOOD_COUNT
+    uint32_t hazardCount;  // RESET : dangers mobiles par jeu
+    uint32_t reserved;
+    uint8_t actions[ENV_MAX_BATCH];  // STEP : 0 = garder, 1..4 = Direction
+};
+
+struct EnvResponse
+{
+    uint32_t status;
+    uint32_t count;
+    uint32_t serverNanos;  // temps de traitement côté serveur
+    uint32_t reserved;
+    EnvGameObs obs[ENV_MAX_BATCH];
+    uint8_t grid[ENV_MAX_BATCH][ENV_GRID_HEIGHT * ENV_GRID_WIDTH];
+};
+
+// Compteur monotone sur sa propre ligne de cache. "value" sert aussi de
+// mot futex ; "waiters" évite l'appel système quand personne ne dort.
+struct alignas(64) EnvCounter
+{
+    std::atomic<uint32_t> value;
+    std::atomic<uint32_t> waiters;
+};
+
+struct EnvShared
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t maxBatch;
+    uint32_t ringSlots;
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint32_t serverPid;
+    uint32_t reserved;
+
+    EnvCounter requestHead;   // incrémenté par le client
+    EnvCounter responseHead;  // incrémenté par le serveur
+
+    EnvRequest requests[ENV_RING_SLOTS];
+    EnvResponse responses[ENV_RING_SLOTS];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "le protocole exige des atomiques 32 bits sans verrou");
+static_assert(sizeof(std::atomic<uint32_t>) == 4, "atomique 32 bits attendu");
+static_assert(sizeof(EnvGameObs) == 76, "disposition EnvGameObs");
+static_assert(sizeof(EnvRequest) == 32 + ENV_MAX_BATCH, "disposition EnvRequest");
+static_assert(offsetof(EnvResponse, obs) == 16, "disposition EnvResponse");
+static_assert(sizeof(EnvCounter) == 64, "disposition EnvCounter");
+static_assert(offsetof(EnvShared, requestHead) == 64, "disposition EnvShared");
+
+#endif // ENVPROTOCOL_H
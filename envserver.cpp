@@ -0,0 +1,212 @@
+#include "envserver.h"
+
+#include <QElapsedTimer>
+#include <cstring>
+
+static_assert(ENV_GRID_WIDTH == WIDTH && ENV_GRID_HEIGHT == HEIGHT,
+              "la grille d'observation doit couvrir le plateau");
+
+// Attente active avant de s'endormir sur le futex (le pas suivant d'un
+// entraîneur arrive en général en quelques microsecondes)
+static const int SERVER_SPIN = 200000;
+static const int SERVER_IDLE_TIMEOUT_MS = 100;
+
+EnvServer::EnvServer(const QString &name)
+    : shmName(name),
+    baseSeed(0),
+    level(1),
+    foodCount(Game::FOOD_COUNT),
+    hazardCount(0),
+    stopRequested(false)
+{
+}
+
+EnvServer::~EnvServer()
+{
+    qDeleteAll(games);
+}
+
+bool EnvServer::start()
+{
+    return channel.create(shmName);
+}
+
+void EnvServer::run()
+{
+    EnvShared *s = channel.shared();
+    if (!s)
+        return;
+
+    // Le segment part de zéro et se voit dès create() : une requête
+    // soumise avant run() reste à traiter
+    uint32_t handled = 0;
+    while (!stopRequested.load(std::memory_order_relaxed))
+    {
+        uint32_t head = EnvChannel::waitChange(s->requestHead, handled,
+                                               SERVER_SPIN, SERVER_IDLE_TIMEOUT_MS);
+        while (handled != head)
+        {
+            int slot = handled % ENV_RING_SLOTS;
+            const EnvRequest &req = s->requests[slot];
+            EnvResponse &resp = s->responses[slot];
+
+            QElapsedTimer t;
+            t.start();
+            handleRequest(req, resp);
+            resp.serverNanos = static_cast<uint32_t>(t.nsecsElapsed());
+
+            ++handled;
+            EnvChannel::publish(s->responseHead, handled);
+
+            if (req.op == ENV_OP_CLOSE)
+                return;
+        }
+    }
+}
+
+void EnvServer::handleRequest(const EnvRequest &req, EnvResponse &resp)
+{
+    resp.count = 0;
+    if (req.count > ENV_MAX_BATCH)
+    {
+        resp.status = ENV_STATUS_BAD_REQUEST;
+        return;
+    }
+    resp.status = ENV_STATUS_OK;
+    bool withGrid = (req.flags & ENV_FLAG_GRID) != 0;
+    int n = static_cast<int>(req.count);
+
+    switch (req.op)
+    {
+    case ENV_OP_RESET:
+        baseSeed = req.seed;
+        level = (req.level >= 1 && req.level <= 3) ? static_cast<int>(req.level) : 1;
+        foodCount = req.foodCount > 0 ? static_cast<int>(qMin(req.foodCount, 100000u)) : Game::FOOD_COUNT;
+        hazardCount = static_cast<int>(qMin(req.hazardCount, 100000u));
+        while (games.size() < n)
+            games.append(new Game());
+        lastScores.resize(n);
+        ticks.resize(n);
+        episodes.resize(n);
+        for (int i = 0; i < n; ++i)
+        {
+            episodes[i] = 0;
+            resetGame(i, baseSeed + i);
+            fillObservation(i, 0, resp.obs[i], resp.grid[i], withGrid);
+        }
+        resp.count = req.count;
+        break;
+
+    case ENV_OP_STEP:
+        if (n > lastScores.size())
+        {
+            resp.status = ENV_STATUS_BAD_REQUEST;
+            return;
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            Game *g = games[i];
+            if (g->isGameOver() && (req.flags & ENV_FLAG_AUTO_RESET))
+            {
+                // Nouvelle graine déterministe pour l'épisode suivant
+                ++episodes[i];
+                resetGame(i, baseSeed + i + ENV_MAX_BATCH * episodes[i]);
+                fillObservation(i, 0, resp.obs[i], resp.grid[i], withGrid);
+                continue;
+            }
+
+            uint8_t a = req.actions[i];
+            if (a >= UP && a <= RIGHT)
+                g->changeDirection(static_cast<Direction>(a));
+            if (!g->isGameOver())
+            {
+                g->updateGame();
+                ++ticks[i];
+                if ((req.flags & ENV_FLAG_END_DOOMED) && g->isDoomed())
+                    g->abandon();
+            }
+
+            int reward = g->getScore() - lastScores[i];
+            lastScores[i] = g->getScore();
+            fillObservation(i, reward, resp.obs[i], resp.grid[i], withGrid);
+        }
+        resp.count = req.count;
+        break;
+
+    case ENV_OP_CLOSE:
+        stopRequested.store(true);
+        break;
+
+    default:
+        resp.status = ENV_STATUS_BAD_REQUEST;
+        break;
+    }
+}
+
+void EnvServer::resetGame(int i, quint32 seed)
+{
+    Game *g = games[i];
+    g->setLevel(level);
+    g->setFoodCount(foodCount);
+    g->setHazardCount(hazardCount);
+    g->setSeed(seed);
+    g->reset();
+    lastScores[i] = 0;
+    ticks[i] = 0;
+}
+
+void EnvServer::fillObservation(int i, int reward, EnvGameObs &obs,
+                                uint8_t *grid, bool withGrid)
+{
+    const Game *g = games[i];
+
+    obs.headX = g->headX();
+    obs.headY = g->headY();
+    obs.direction = g->getDirection();
+    obs.length = g->getLength();
+    obs.score = g->getScore();
+    obs.reward = reward;
+    obs.done = g->isGameOver() ? 1 : 0;
+    obs.ticks = ticks[i];
+    obs.doomed = g->isDoomed() ? 1 : 0;
+    obs.reachable = g->reachableArea();
+    for (int k = 0; k < ENV_OBS_FOOD; ++k)
+    {
+        bool present = k < g->foodCount();
+        obs.foodX[k] = present ? g->foodX(k) : -1;
+        obs.foodY[k] = present ? g->foodY(k) : -1;
+        obs.foodType[k] = present ? g->foodType(k) : -1;
+    }
+
+    if (!withGrid)
+        return;
+
+    memset(grid, ENV_CELL_EMPTY, ENV_GRID_WIDTH * ENV_GRID_HEIGHT);
+    const WallGrid &walls = g->wallGrid();
+    for (int y = 0; y < ENV_GRID_HEIGHT; ++y)
+    {
+        const uchar *row = walls.row(y);
+        for (int x = 0; x < ENV_GRID_WIDTH; x += 8)
+        {
+            // Octets vides sautés d'un coup : les murs sont rares
+            if (!row[x >> 3])
+                continue;
+            for (int b = x; b < x + 8 && b < ENV_GRID_WIDTH; ++b)
+            {
+                if (walls.isWall(b, y))
+                    grid[y * ENV_GRID_WIDTH + b] = ENV_CELL_WALL;
+            }
+        }
+    }
+    for (int k = 0; k < g->foodCount(); ++k)
+        grid[g->foodY(k) * ENV_GRID_WIDTH + g->foodX(k)] = ENV_CELL_FOOD + g->foodType(k);
+    const HazardField &hazards = g->hazardField();
+    for (int k = 0; k < hazards.count(); ++k)
+        grid[hazards.hazard(k).y * ENV_GRID_WIDTH + hazards.hazard(k).x] = ENV_CELL_HAZARD;
+    uint8_t cell = ENV_CELL_HEAD;
+    for (PackedBody::Cursor c = g->snakeBody().cursor(); c.valid(); c.next())
+    {
+        grid[c.y() * ENV_GRID_WIDTH + c.x()] = cell;
+        cell = ENV_CELL_BODY;
+    }
+}
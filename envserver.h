@@ -0,0 +1,42 @@
+#ifndef ENVSERVER_H
+#define ENVSERVER_H
+
+#include <QVector>
+#include <atomic>
+#include "envchannel.h"
+#include "game.h"
+
+// Serveur d'environnement : un lot de parties Game pilotées par un
+// entraîneur externe via reset/step sur l'anneau de mémoire partagée.
+class EnvServer
+{
+public:
+    explicit EnvServer(const QString &name = ENV_DEFAULT_NAME);
+    ~EnvServer();
+
+    bool start();
+    void run();   // boucle bloquante jusqu'à ENV_OP_CLOSE ou stop()
+    void stop() { stopRequested.store(true); }
+
+    QString errorString() const { return channel.errorString(); }
+
+private:
+    EnvChannel channel;
+    QString shmName;
+    QVector<Game *> games;
+    QVector<int> lastScores;
+    QVector<quint32> ticks;
+    QVector<quint32> episodes;
+    quint32 baseSeed;
+    int level;
+    int foodCount;
+    int hazardCount;
+    std::atomic<bool> stopRequested;
+
+    void handleRequest(const EnvRequest &req, EnvResponse &resp);
+    void resetGame(int i, quint32 seed);
+    void fillObservation(int i, int reward, EnvGameObs &obs,
+                         uint8_t *grid, bool withGrid);
+};
+
+#endif // ENVSERVER_H
@@ -0,0 +1,280 @@
+#include "freespace.h"
+
+FreeSpaceTracker::FreeSpaceTracker()
+    : w(0),
+    h(0),
+    splits(0),
+    epoch(0)
+{
+}
+
+void FreeSpaceTracker::reset(int width, int height)
+{
+    w = width;
+    h = height;
+    label.fill(UNLABELED, w * h);
+    sizes.clear();
+    freeIds.clear();
+    mark.fill(0, w * h);
+    owner.fill(0, w * h);
+    epoch = 0;
+    splits = 0;
+}
+
+void FreeSpaceTracker::relabel()
+{
+    sizes.clear();
+    freeIds.clear();
+    for (int i = 0; i < label.size(); ++i)
+        if (label[i] != BLOCKED)
+            label[i] = UNLABELED;
+    for (int i = 0; i < label.size(); ++i)
+    {
+        if (label[i] != UNLABELED)
+            continue;
+        int id = allocId();
+        label[i] = id;
+        sizes[id] = 1;
+        fill(i, UNLABELED, id);
+    }
+}
+
+void FreeSpaceTracker::neighbours(int cell, int out[4]) const
+{
+    int x = cell % w;
+    int y = cell - x;
+    out[0] = (x == 0) ? cell + w - 1 : cell - 1;
+    out[1] = (x == w - 1) ? y : cell + 1;
+    out[2] = (y == 0) ? cell + (h - 1) * w : cell - w;
+    out[3] = (y == (h - 1) * w) ? x : cell + w;
+}
+
+int FreeSpaceTracker::allocId()
+{
+    if (!freeIds.isEmpty())
+    {
+        int id = freeIds.takeLast();
+        sizes[id] = 0;
+        return id;
+    }
+    sizes.append(0);
+    return static_cast<int>(sizes.size()) - 1;
+}
+
+void FreeSpaceTracker::releaseId(int id)
+{
+    sizes[id] = 0;
+    freeIds.append(id);
+}
+
+// Passe toute la composante de `seed` (étiquetée `from`, seed compris s'il
+// l'est encore) à l'étiquette `to` ; ajoute les cases comptées à sizes[to]
+void FreeSpaceTracker::fill(int seed, int from, int to)
+{
+    queue.clear();
+    if (label[seed] == from)
+    {
+        label[seed] = to;
+        ++sizes[to];
+    }
+    queue.append(seed);
+    for (int q = 0; q < queue.size(); ++q)
+    {
+        int n[4];
+        neighbours(queue[q], n);
+        for (int k = 0; k < 4; ++k)
+        {
+            if (label[n[k]] == from)
+            {
+                label[n[k]] = to;
+                ++sizes[to];
+                queue.append(n[k]);
+            }
+        }
+    }
+}
+
+void FreeSpaceTracker::unblock(int cell)
+{
+    if (label[cell] != BLOCKED)
+        return;
+
+    int n[4];
+    neighbours(cell, n);
+    int largest = -1;
+    for (int k = 0; k < 4; ++k)
+    {
+        int id = label[n[k]];
+        if (id >= 0 && (largest < 0 || sizes[id] > sizes[largest]))
+            largest = id;
+    }
+    if (largest < 0)
+    {
+        largest = allocId();
+    }
+    else
+    {
+        // Les autres composantes voisines rejoignent la plus grande
+        for (int k = 0; k < 4; ++k)
+        {
+            int id = label[n[k]];
+            if (id < 0 || id == largest)
+                continue;
+            fill(n[k], id, largest);
+            releaseId(id);
+        }
+    }
+    label[cell] = largest;
+    ++sizes[largest];
+}
+
+// Vrai si les voisines libres de la case restent reliées entre elles par
+// les coins libres de l'anneau de 8 cases : la bloquer ne coupe rien
+bool FreeSpaceTracker::locallyConnected(int cell) const
+{
+    int n[4];
+    neighbours(cell, n);
+    // Ordre autour de la case : haut, droite, bas, gauche
+    const int side[4] = { n[2], n[1], n[3], n[0] };
+    int corner[4];
+    int up[4], down[4];
+    neighbours(n[2], up);
+    neighbours(n[3], down);
+    corner[0] = up[1];    // haut-droite
+    corner[1] = down[1];  // bas-droite
+    corner[2] = down[0];  // bas-gauche
+    corner[3] = up[0];    // haut-gauche
+
+    int freeSides = 0, links = 0;
+    for (int k = 0; k < 4; ++k)
+    {
+        bool a = label[side[k]] >= 0;
+        bool b = label[side[(k + 1) & 3]] >= 0;
+        freeSides += a;
+        links += a && b && label[corner[k]] >= 0;
+    }
+    return freeSides - links <= 1;
+}
+
+void FreeSpaceTracker::block(int cell)
+{
+    int id = label[cell];
+    if (id < 0)
+        return;
+    label[cell] = BLOCKED;
+    if (--sizes[id] == 0)
+    {
+        releaseId(id);
+        return;
+    }
+    if (locallyConnected(cell))
+        return;
+
+    int n[4], seeds[4], count = 0;
+    neighbours(cell, n);
+    for (int k = 0; k < 4; ++k)
+        if (label[n[k]] == id)
+            seeds[count++] = n[k];
+    split(id, seeds, count);
+}
+
+// Recherches en largeur simultanées depuis chaque voisine, un pas chacune
+// à tour de rôle. Deux recherches qui se rencontrent fusionnent ; une
+// recherche épuisée a trouvé un morceau détaché, qui reçoit une nouvelle
+// étiquette. On s'arrête dès qu'il n'en reste qu'une active : le morceau
+// qu'elle explore garde l'ancienne étiquette sans être parcouru en entier.
+void FreeSpaceTracker::split(int id, const int *seeds, int count)
+{
+    ++splits;
+    if (++epoch == 0)
+    {
+        mark.fill(0);
+        epoch = 1;
+    }
+
+    int root[4], head[4];
+    bool done[4];
+    for (int i = 0; i < count; ++i)
+    {
+        root[i] = i;
+        head[i] = 0;
+        done[i] = false;
+        found[i].clear();
+        found[i].append(seeds[i]);
+        mark[seeds[i]] = epoch;
+        owner[seeds[i]] = uchar(i);
+    }
+    auto findRoot = [&root](int i) {
+        while (root[i] != i)
+            i = root[i];
+        return i;
+    };
+
+    for (;;)
+    {
+        int active = 0;
+        for (int i = 0; i < count; ++i)
+            active += (root[i] == i && !done[i]);
+        if (active <= 1)
+            break;
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (root[i] != i || done[i])
+                continue;
+            if (head[i] == found[i].size())
+            {
+                done[i] = true;
+                continue;
+            }
+            int n[4];
+            neighbours(found[i][head[i]++], n);
+            for (int k = 0; k < 4; ++k)
+            {
+                int c = n[k];
+                if (label[c] != id)
+                    continue;
+                if (mark[c] != epoch)
+                {
+                    mark[c] = epoch;
+                    owner[c] = uchar(i);
+                    found[i].append(c);
+                    continue;
+                }
+                int r = findRoot(owner[c]);
+                if (r == i)
+                    continue;
+                // Même morceau : la recherche r est absorbée par i
+                root[r] = i;
+                found[i].append(found[r]);
+                found[r].clear();
+            }
+        }
+    }
+
+    // Le morceau gardé : la recherche encore active, sinon le plus grand
+    int keep = -1;
+    for (int i = 0; i < count; ++i)
+    {
+        if (root[i] != i)
+            continue;
+        if (!done[i])
+        {
+            keep = i;
+            break;
+        }
+        if (keep < 0 || found[i].size() > found[keep].size())
+            keep = i;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (root[i] != i || i == keep)
+            continue;
+        int piece = allocId();
+        for (int c : found[i])
+            label[c] = piece;
+        sizes[piece] = static_cast<int>(found[i].size());
+        sizes[id] -= sizes[piece];
+    }
+}
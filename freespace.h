@@ -0,0 +1,63 @@
+#ifndef FREESPACE_H
+#define FREESPACE_H
+
+#include <QVector>
+
+// Composantes connexes des cases libres d'un plateau torique, tenues à
+// jour case par case. Bloquer une case ne relance de parcours que si elle
+// coupe localement son voisinage (test sur les 8 cases autour), et alors
+// seulement sur les morceaux détachés, explorés en parallèle : le plus
+// gros n'est jamais parcouru. Libérer une case fusionne au plus quatre
+// composantes en réétiquetant les plus petites.
+class FreeSpaceTracker
+{
+public:
+    FreeSpaceTracker();
+
+    // Plateau entièrement libre, puis setBlocked() pour l'état initial et
+    // relabel() pour étiqueter le tout
+    void reset(int width, int height);
+    void setBlocked(int cell) { label[cell] = BLOCKED; }
+    void relabel();
+
+    // Mises à jour incrémentales
+    void block(int cell);
+    void unblock(int cell);
+
+    bool isBlocked(int cell) const { return label[cell] == BLOCKED; }
+    int componentOf(int cell) const { return label[cell]; }  // -1 si bloquée
+    int componentSize(int id) const { return sizes[id]; }
+    int componentCount() const { return static_cast<int>(sizes.size() - freeIds.size()); }
+
+    // Voisines d'une case (gauche, droite, haut, bas), bords repliés
+    void neighbours(int cell, int out[4]) const;
+
+    // Parcours déclenchés par block() depuis reset(), pour les mesures
+    int splitSearches() const { return splits; }
+
+private:
+    static constexpr int BLOCKED = -1;
+    static constexpr int UNLABELED = -2;
+
+    int w;
+    int h;
+    QVector<int> label;
+    QVector<int> sizes;
+    QVector<int> freeIds;
+    int splits;
+
+    // Recherches parallèles de block()
+    QVector<int> queue;
+    QVector<quint32> mark;
+    QVector<uchar> owner;
+    quint32 epoch;
+    QVector<int> found[4];
+
+    int allocId();
+    void releaseId(int id);
+    void fill(int seed, int from, int to);
+    bool locallyConnected(int cell) const;
+    void split(int id, const int *seeds, int count);
+};
+
+#endif // FREESPACE_H
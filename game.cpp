@@ -1,22 +1,38 @@
 #include "game.h"
+#include "mapfile.h"
+
+#include <QDataStream>
+#include <algorithm>
+#include <cstring>
+
+static const quint32 GAME_STATE_VERSION = 1;
 
 Game::Game(QObject *parent)
     : QObject(parent),
-    head(nullptr),
-    length(0),
     direction(RIGHT),
     nextDirection(RIGHT),
+    requestedFood(FOOD_COUNT),
     score(0),
+    pendingGrowth(0),
     gameOver(false),
+    cause(DEATH_NONE),
+    boardW(WIDTH),
+    boardH(HEIGHT),
+    layout(LAYOUT_SCATTER),
+    requestedHazards(0),
+    headStamp(0),
+    tailStamp(1),
+    visitEpoch(0),
     lastFruitEaten(-1),
-    currentLevel(1)  // NOUVEAU : niveau par défaut
+    speedPercent(100),
+    currentLevel(1),  // NOUVEAU : niveau par défaut
+    rng(QRandomGenerator::global()->generate())
 {
     reset();
 }
 
 Game::~Game()
 {
-    freeSnake();
 }
 
 // NOUVEAU : définir le niveau
@@ -26,272 +42,450 @@ void Game::setLevel(int level)
         currentLevel = level;
 }
 
-// NOUVEAU : retourner la vitesse selon le niveau
+// NOUVEAU : retourner la vitesse selon le niveau (200 / 140 / 90 ms par
+// défaut, voir LevelTable)
 int Game::getSpeed() const
 {
-    switch (currentLevel)
-    {
-    case 1: return 200;  // Facile : 200ms
-    case 2: return 140;  // Moyen : 140ms
-    case 3: return 90;   // Difficile : 90ms
-    default: return 140;
-    }
+    int ms = levels.level(currentLevel).tickMs;
+    if (effectTimer[EFFECT_SPEED])
+        ms = ms * speedPercent / 100;
+    return ms;
 }
 
-SnakeNode *Game::createNode(int x, int y)
+int Game::effectTicksLeft(ItemEffect effect) const
 {
-    SnakeNode *node = new SnakeNode;
-    node->x = x;
-    node->y = y;
-    node->next = nullptr;
-    return node;
+    quint64 due = timers.dueTick(effectTimer[effect]);
+    return due ? static_cast<int>(due - timers.now()) : 0;
 }
 
-void Game::freeSnake()
+int Game::foodTicksLeft(int i) const
+{
+    quint64 due = timers.dueTick(foodTimer[i]);
+    return due ? static_cast<int>(due - timers.now()) : -1;
+}
+
+void Game::removeLastSegment()
 {
-    SnakeNode *current = head;
-    while (current != nullptr)
+    if (body.length() <= 1)
+        return;
+    // En mode fantôme, un segment plus récent peut occuper la même case
+    int cell = body.tailY() * boardW + body.tailX();
+    if (bodyStamp[cell] == tailStamp)
     {
-        SnakeNode *tmp = current;
-        current = current->next;
-        delete tmp;
+        bodyStamp[cell] = 0;
+        space.unblock(cell);
     }
-    head = nullptr;
-    length = 0;
+    ++tailStamp;
+    body.popTail();
 }
 
-void Game::addSegment(int x, int y)
+// Grille du corps et composantes libres, reconstruites après les murs
+void Game::trackSnake()
 {
-    SnakeNode *newNode = createNode(x, y);
-    if (!head)
+    bodyStamp.fill(0, boardW * boardH);
+    headStamp = static_cast<quint32>(body.length());
+    tailStamp = 1;
+    quint32 stamp = headStamp;
+    // Tête d'abord : une case traversée en mode fantôme garde le segment le
+    // plus récent, comme pendant la partie (corps repris d'une sauvegarde)
+    for (PackedBody::Cursor c = body.cursor(); c.valid(); c.next(), --stamp)
     {
-        head = newNode;
+        if (!bodyStamp[c.cell()])
+            bodyStamp[c.cell()] = stamp;
     }
-    else
+
+    space.reset(boardW, boardH);
+    for (int y = 0; y < boardH; ++y)
     {
-        SnakeNode *cur = head;
-        while (cur->next)
-            cur = cur->next;
-        cur->next = newNode;
+        const uchar *row = walls.row(y);
+        for (int x = 0; x < boardW; ++x)
+            if (((row[x >> 3] >> (x & 7)) & 1) || bodyStamp[y * boardW + x])
+                space.setBlocked(y * boardW + x);
     }
-    ++length;
+    space.relabel();
 }
 
-void Game::removeLastSegment()
+int Game::reachableArea() const
 {
-    if (!head)
-        return;
-    if (!head->next)
-    {
-        delete head;
-        head = nullptr;
-    }
-    else
+    int n[4], seen[4], count = 0, area = 0;
+    space.neighbours(body.headY() * boardW + body.headX(), n);
+    for (int k = 0; k < 4; ++k)
     {
-        SnakeNode *cur = head;
-        while (cur->next->next)
-            cur = cur->next;
-        delete cur->next;
-        cur->next = nullptr;
+        int id = space.componentOf(n[k]);
+        if (id < 0)
+            continue;
+        bool dup = false;
+        for (int i = 0; i < count; ++i)
+            dup = dup || seen[i] == id;
+        if (dup)
+            continue;
+        seen[count++] = id;
+        area += space.componentSize(id);
     }
-    --length;
+    return area;
 }
 
-bool Game::isPositionOnSnake(int x, int y)
+bool Game::isDoomed() const
 {
-    SnakeNode *cur = head;
-    while (cur)
+    if (gameOver)
+        return true;
+    if (isGhost())
+        return false;
+
+    // Le segment de rang r se libère au pas r - queue + 1 ; la tête peut
+    // faire au plus `area` pas dans la poche avant d'avoir besoin d'une
+    // case libérée. Le cou (pas length - 1) borde toujours la poche : au
+    // moins aussi grande que le serpent, elle ne permet aucune conclusion.
+    // Les fruits ne font que retarder la queue ; un objet qui la raccourcit
+    // dans la poche interdit de conclure.
+    int area = reachableArea();
+    if (area >= body.length())
+        return false;
+
+    quint32 firstFree = headStamp;  // plus petit pas de libération voisin
+
+    if (++visitEpoch == 0)
     {
-        if (cur->x == x && cur->y == y)
-            return true;
-        cur = cur->next;
+        visitMark.fill(0);
+        visitEpoch = 1;
     }
-    return false;
+    visitMark.resize(boardW * boardH);
+    visitQueue.clear();
+    int start = body.headY() * boardW + body.headX();
+    visitMark[start] = visitEpoch;
+    visitQueue.append(start);
+    for (int q = 0; q < visitQueue.size(); ++q)
+    {
+        int n[4];
+        space.neighbours(visitQueue[q], n);
+        for (int k = 0; k < 4; ++k)
+        {
+            int c = n[k];
+            if (visitMark[c] == visitEpoch)
+                continue;
+            visitMark[c] = visitEpoch;
+            if (bodyStamp[c])
+            {
+                firstFree = qMin(firstFree, bodyStamp[c] - tailStamp + 1);
+                continue;
+            }
+            if (space.isBlocked(c))
+                continue;
+            if (foodAt[c] >= 0 && itemType(food_type[foodAt[c]]).effect == EFFECT_SHRINK)
+                return false;
+            visitQueue.append(c);
+        }
+    }
+    return quint32(area) + 1 < firstFree;
 }
 
-bool Game::isPositionObstacle(int x, int y)
+bool Game::loadMap(const QString &path, QString *error)
 {
-    for (const Obstacle &o : obstacles)
+    QSharedPointer<MapFile> m(new MapFile);
+    if (!m->open(path))
     {
-        if (o.x == x && o.y == y)
-            return true;
+        if (error)
+            *error = m->errorString();
+        return false;
     }
-    return false;
+    map = m;
+    return true;
+}
+
+void Game::clearMap()
+{
+    map.reset();
 }
 
+// Test d'occupation par la grille foodAt : O(1) par essai, quel que soit
+// le nombre de fruits
 void Game::generateSingleFood(int index)
 {
-    int x, y;
+    if (food_x[index] >= 0)
+        foodAt[food_y[index] * boardW + food_x[index]] = -1;
+
+    int x = 0, y = 0;
     bool ok = false;
-    while (!ok)
+    for (int tries = 0; !ok && tries < 1000; ++tries)
     {
-        x = QRandomGenerator::global()->bounded(1, WIDTH - 1);
-        y = QRandomGenerator::global()->bounded(1, HEIGHT - 1);
+        if (map && map->zoneCount() > 0)
+        {
+            const MapZone &z = map->zone(rng.bounded(map->zoneCount()));
+            x = static_cast<int>(z.x) + rng.bounded(static_cast<int>(z.width));
+            y = static_cast<int>(z.y) + rng.bounded(static_cast<int>(z.height));
+        }
+        else
+        {
+            x = rng.bounded(1, boardW - 1);
+            y = rng.bounded(1, boardH - 1);
+        }
         ok = true;
         if (isPositionOnSnake(x, y))
             ok = false;
         if (isPositionObstacle(x, y))
             ok = false;
+        if (foodAt[y * boardW + x] >= 0 || hazards.contains(x, y))
+            ok = false;
+    }
 
-        for (int i = 0; i < FOOD_COUNT; ++i)
-        {
-            if (i == index) continue;
-            if (food_x[i] == x && food_y[i] == y)
-            {
-                ok = false;
-                break;
-            }
-        }
+    // Zones pleines : première case libre du plateau
+    for (int cell = 0; !ok && cell < boardW * boardH; ++cell)
+    {
+        x = cell % boardW;
+        y = cell / boardW;
+        ok = !isPositionOnSnake(x, y) && !isPositionObstacle(x, y) && foodAt[cell] < 0 &&
+             !hazards.contains(x, y);
     }
     food_x[index] = x;
     food_y[index] = y;
-
-    if (index == 0)
-        food_type[index] = APPLE;
-    else if (index == 1)
-        food_type[index] = BANANA;
-    else if (index == 2)
-        food_type[index] = PINEAPPLE;
+    foodAt[y * boardW + x] = index;
+    food_type[index] = static_cast<FruitType>(itemSampler().sample(rng));
+
+    timers.cancel(foodTimer[index]);
+    foodTimer[index] = 0;
+    int lifetime = itemType(food_type[index]).lifetime;
+    if (lifetime > 0)
+        foodTimer[index] = timers.schedule(timers.now() + lifetime, TIMER_FOOD_EXPIRY, index);
 }
 
 void Game::generateFood()
 {
-    for (int i = 0; i < FOOD_COUNT; ++i)
+    for (int i = 0; i < food_x.size(); ++i)
         generateSingleFood(i);
 }
 
 void Game::generateObstacles()
 {
-    obstacles.clear();
-    QRandomGenerator *rg = QRandomGenerator::global();
+    if (map)
+    {
+        // La bitmap de la carte sert directement de grille de collision
+        walls.attach(map->bitmap(), boardW, boardH, map->rowBytes());
+        return;
+    }
 
-    // MODIFIÉ : nombre d'obstacles selon le niveau
-    int nbObs;
-    switch (currentLevel)
+    // Réservé : la tête, trois cases devant elle, puis le corps
+    int dx = (direction == RIGHT) ? 1 : (direction == LEFT) ? -1 : 0;
+    int dy = (direction == DOWN) ? 1 : (direction == UP) ? -1 : 0;
+    QVector<int> reserved;
+    reserved.append(body.headY() * boardW + body.headX());
+    for (int i = 1; i <= 3; ++i)
     {
-    case 1: nbObs = 5; break;   // Facile : 5 obstacles
-    case 2: nbObs = 8; break;   // Moyen : 8 obstacles
-    case 3: nbObs = 12; break;  // Difficile : 12 obstacles
-    default: nbObs = 8; break;
+        int x = (body.headX() + i * dx + boardW) % boardW;
+        int y = (body.headY() + i * dy + boardH) % boardH;
+        reserved.append(y * boardW + x);
     }
+    PackedBody::Cursor c = body.cursor();
+    for (c.next(); c.valid(); c.next())
+        reserved.append(c.cell());
+
+    // MODIFIÉ : densité selon currentLevel, cases inaccessibles murées
+    walls.reset(boardW, boardH);
+    LevelGenerator generator(rng);
+    generator.generate(walls, layout, levels.level(currentLevel), reserved);
+}
+
+// Case libre pour un danger : ni mur ni corps, à plus de `margin` cases
+// de la tête (bords repliés)
+bool Game::hazardSiteOk(int x, int y, int margin) const
+{
+    if (isPositionObstacle(x, y) || isPositionOnSnake(x, y))
+        return false;
+    int dx = qAbs(x - body.headX()), dy = qAbs(y - body.headY());
+    return qMax(qMin(dx, boardW - dx), qMin(dy, boardH - dy)) > margin;
+}
+
+// Patrouilles par groupes de 1 à 3 de front (murs mobiles), trajet entier
+// vérifié libre ; un quart de poursuivants, deux fois plus lents que le
+// serpent. Aucun tirage sans dangers : les parties classiques ne changent pas.
+void Game::generateHazards(int budget)
+{
+    hazards.reset(boardW, boardH);
+    if (budget <= 0)
+        return;
 
-    for (int i = 0; i < nbObs; ++i)
+    int chasers = budget / 4;
+    int patrols = budget - chasers;
+    for (int tries = 0; patrols > 0 && tries < 100 * budget; ++tries)
     {
-        int x, y;
-        bool ok = false;
-        while (!ok)
+        bool horizontal = rng.bounded(2) != 0;
+        int dx = horizontal ? 1 : 0;
+        int dy = horizontal ? 0 : 1;
+        int span = qMin(rng.bounded(3, 9), qMax(boardW, boardH) - 1);
+        int width = qMin(patrols, rng.bounded(1, 4));
+        int x = rng.bounded(boardW);
+        int y = rng.bounded(boardH);
+
+        bool ok = true;
+        for (int k = 0; ok && k < width; ++k)
         {
-            x = rg->bounded(2, WIDTH - 2);
-            y = rg->bounded(2, HEIGHT - 2);
-            ok = true;
-            if (isPositionOnSnake(x, y))
-                ok = false;
-            if (isPositionObstacle(x, y))
-                ok = false;
-            for (int k = 0; k < FOOD_COUNT; ++k)
+            for (int s = 0; ok && s <= span; ++s)
             {
-                if (food_x[k] == x && food_y[k] == y)
-                {
-                    ok = false;
-                    break;
-                }
+                int cx = (x + k * dy + s * dx) % boardW;
+                int cy = (y + k * dx + s * dy) % boardH;
+                ok = hazardSiteOk(cx, cy, 5) && !hazards.contains(cx, cy);
             }
         }
-        obstacles.push_back({x, y});
+        if (!ok)
+            continue;
+
+        int period = rng.bounded(1, 3);
+        int phase = rng.bounded(period);
+        for (int k = 0; k < width; ++k)
+            hazards.addPatrol((x + k * dy) % boardW, (y + k * dx) % boardH,
+                              dx, dy, span, period, phase);
+        patrols -= width;
     }
-}
-
-int Game::checkCollision()
-{
-    SnakeNode *h = head;
-    if (!h)
-        return 1;
-    if (isPositionObstacle(h->x, h->y))
-        return 1;
-
-    SnakeNode *cur = head;
-    if (cur && cur->next && cur->next->next)
-        cur = cur->next->next;
-    else
-        return 0;
 
-    while (cur)
+    for (int tries = 0; chasers > 0 && tries < 100 * budget; ++tries)
     {
-        if (h->x == cur->x && h->y == cur->y)
-            return 1;
-        cur = cur->next;
+        int x = rng.bounded(boardW);
+        int y = rng.bounded(boardH);
+        if (!hazardSiteOk(x, y, 10) || hazards.contains(x, y))
+            continue;
+        hazards.addChaser(x, y, 2, rng.bounded(2));
+        --chasers;
     }
-    return 0;
+}
+
+// Appelé avant que la nouvelle tête ne soit inscrite dans la grille du
+// corps : la case doit être libre (la queue vient d'être retirée). Le
+// fantôme traverse le corps et les dangers, pas les murs.
+DeathCause Game::checkCollision()
+{
+    int x = body.headX();
+    int y = body.headY();
+    if (isPositionObstacle(x, y))
+        return DEATH_WALL;
+    if (isGhost())
+        return DEATH_NONE;
+    if (isPositionOnSnake(x, y))
+        return DEATH_BODY;
+    return hazards.contains(x, y) ? DEATH_HAZARD : DEATH_NONE;
 }
 
 int Game::checkFoodCollision()
 {
-    if (!head)
-        return -1;
-    for (int i = 0; i < FOOD_COUNT; ++i)
-    {
-        if (head->x == food_x[i] && head->y == food_y[i])
-            return i;
-    }
-    return -1;
+    return foodAt[body.headY() * boardW + body.headX()];
 }
 
 void Game::moveSnake()
 {
     direction = nextDirection;
-    int newX = head->x;
-    int newY = head->y;
+    body.pushHead(direction);  // bords repliés
+
+    // La queue avance avant le test : la tête peut prendre sa case
+    int foodIndex = checkFoodCollision();
+    if (foodIndex != -1)
+        pendingGrowth += itemType(food_type[foodIndex]).growth;
+    if (pendingGrowth > 0)
+        --pendingGrowth;
+    else
+        removeLastSegment();
 
-    switch (direction)
+    DeathCause hit = checkCollision();
+    if (hit != DEATH_NONE)
     {
-    case UP: --newY; break;
-    case DOWN: ++newY; break;
-    case LEFT: --newX; break;
-    case RIGHT: ++newX; break;
+        gameOver = true;
+        cause = hit;
+        return;
     }
+    int cell = body.headY() * boardW + body.headX();
+    bodyStamp[cell] = ++headStamp;
+    space.block(cell);
 
-    if (newX < 0) newX = WIDTH - 1;
-    if (newX >= WIDTH) newX = 0;
-    if (newY < 0) newY = HEIGHT - 1;
-    if (newY >= HEIGHT) newY = 0;
-
-    SnakeNode *newHead = createNode(newX, newY);
-    newHead->next = head;
-    head = newHead;
-    ++length;
-
-    int foodIndex = checkFoodCollision();
     if (foodIndex != -1)
     {
         FruitType ft = food_type[foodIndex];
-        int points = 0;
-        if (ft == APPLE)
-            points = 10;
-        else if (ft == BANANA)
-            points = 15;
-        else if (ft == PINEAPPLE)
-            points = 25;
-
-        score += points;
+        const ItemType &item = itemType(ft);
+
+        score += item.points;
         lastFruitEaten = foodIndex;
+        (this->*effectHandlers[item.effect])(item);
+        if (item.duration > 0)
+            startEffect(item);
 
-        emit fruitEaten(food_x[foodIndex], food_y[foodIndex], points, ft);
+        emit fruitEaten(food_x[foodIndex], food_y[foodIndex], item.points, ft);
 
         generateSingleFood(foodIndex);
     }
-    else
+}
+
+const Game::EffectHandler Game::effectHandlers[EFFECT_COUNT] = {
+    &Game::applyNoEffect,
+    &Game::applyShrink,
+    &Game::applySpeed,
+    &Game::applyGhost
+};
+
+// Un même effet repris avant sa fin repart pour toute sa durée
+void Game::startEffect(const ItemType &item)
+{
+    timers.cancel(effectTimer[item.effect]);
+    effectTimer[item.effect] = timers.schedule(timers.now() + item.duration,
+                                               TIMER_EFFECT_END, item.effect);
+}
+
+void Game::handleTimer(const TimerEvent &event)
+{
+    switch (event.kind)
     {
-        removeLastSegment();
+    case TIMER_EFFECT_END:
+        effectTimer[event.arg] = 0;
+        break;
+    case TIMER_FOOD_EXPIRY:
+        foodTimer[event.arg] = 0;
+        generateSingleFood(event.arg);
+        break;
     }
+}
 
-    if (checkCollision())
-        gameOver = true;
+void Game::applyNoEffect(const ItemType &)
+{
 }
 
+// Ciseaux : la queue raccourcit, sans descendre sous trois segments
+void Game::applyShrink(const ItemType &item)
+{
+    pendingGrowth = 0;
+    for (int i = 0; i < item.effectAmount && body.length() > 3; ++i)
+        removeLastSegment();
+}
+
+// Éclair : pas plus courts, le numéro de pas reste la seule horloge
+void Game::applySpeed(const ItemType &item)
+{
+    speedPercent = qBound(10, item.effectAmount, 100);
+}
+
+// Fantôme : checkCollision ignore le corps tant que la minuterie court
+void Game::applyGhost(const ItemType &)
+{
+}
+
+// Les échéances du pas passent avant le déplacement, puis les dangers,
+// toujours dans le même ordre : une partie rejouée avec la même graine
+// est identique. Un danger qui arrive sur la tête la touche, même si le
+// serpent allait partir vers sa case d'origine.
 void Game::updateGame()
 {
-    if (!gameOver)
-        moveSnake();
+    if (gameOver)
+        return;
+    firedTimers.clear();
+    timers.advance(firedTimers);
+    for (const TimerEvent &event : firedTimers)
+        handleTimer(event);
+
+    if (hazards.count() > 0)
+    {
+        hazards.step(timers.now(), walls, body.headX(), body.headY());
+        if (hazards.contains(body.headX(), body.headY()) && !isGhost())
+        {
+            gameOver = true;
+            cause = DEATH_HAZARD;
+            return;
+        }
+    }
+    moveSnake();
 }
 
 void Game::changeDirection(Direction dir)
@@ -306,16 +500,275 @@ void Game::changeDirection(Direction dir)
 
 void Game::reset()
 {
-    freeSnake();
-    head = createNode(WIDTH / 2, HEIGHT / 2);
-    length = 1;
-    direction = RIGHT;
-    nextDirection = RIGHT;
+    boardW = map ? map->width() : WIDTH;
+    boardH = map ? map->height() : HEIGHT;
+
+    int x = map ? map->spawnX() : boardW / 2;
+    int y = map ? map->spawnY() : boardH / 2;
+    direction = map ? map->spawnDirection() : RIGHT;
+    nextDirection = direction;
+
+    // Le corps part à l'opposé de la direction de départ
+    body.reset(boardW, boardH, x, y);
+    body.pushTail(direction);
+    body.pushTail(direction);
     score = 0;
+    pendingGrowth = 0;
     gameOver = false;
+    cause = DEATH_NONE;
     lastFruitEaten = -1;
-    addSegment(WIDTH / 2 - 1, HEIGHT / 2);
-    addSegment(WIDTH / 2 - 2, HEIGHT / 2);
+
+    timers.reset();
+    for (int i = 0; i < EFFECT_COUNT; ++i)
+        effectTimer[i] = 0;
+    speedPercent = 100;
+
+    // Murs d'abord : les fruits doivent les éviter
+    generateObstacles();  // Génère selon currentLevel (ou la carte)
+    trackSnake();
+
+    int freeCells = 0;
+    for (int cell = 0; cell < boardW * boardH; ++cell)
+        freeCells += !space.isBlocked(cell);
+    generateHazards(qMin(requestedHazards, freeCells / 8));
+    int count = qBound(1, requestedFood, qMax(1, freeCells / 2));
+    food_x.fill(-1, count);
+    food_y.fill(-1, count);
+    food_type.fill(APPLE, count);
+    foodTimer.fill(0, count);
+    foodAt.fill(-1, boardW * boardH);
     generateFood();
-    generateObstacles();  // Génère selon currentLevel
+}
+
+// Les minuteries sont écrites dans leur ordre de programmation : reprises
+// dans cet ordre, celles d'un même pas sortent comme avant
+QByteArray Game::saveState() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    const LevelParams &params = levels.level(currentLevel);
+    out << GAME_STATE_VERSION << qint32(boardW) << qint32(boardH) << !map.isNull()
+        << qint32(currentLevel) << qint32(params.tickMs) << qint32(params.wallsPerThousand)
+        << qint32(params.clusterPercent) << qint32(params.roomPitch)
+        << qint32(params.doorWidth) << qint32(params.mazePitch) << qint32(layout)
+        << qint32(requestedFood) << qint32(requestedHazards) << quint64(timers.now());
+    out << qint32(direction) << qint32(nextDirection) << qint32(score)
+        << qint32(pendingGrowth) << gameOver << qint32(cause) << qint32(speedPercent);
+
+    // Corps : la queue puis les liaisons vers la tête, 2 bits chacune
+    int links = body.length() - 1;
+    QByteArray packed((links + 3) / 4, '\0');
+    for (int i = 0; i < links; ++i)
+        packed[i >> 2] = char(packed[i >> 2] | ((body.linkFromTail(i) - 1) << ((i & 3) * 2)));
+    out << qint32(body.tailX()) << qint32(body.tailY()) << qint32(links) << packed;
+
+    // Une carte est relue depuis son fichier
+    if (!map)
+        out << QByteArray(reinterpret_cast<const char *>(walls.row(0)),
+                          walls.rowBytes() * boardH);
+
+    out << qint32(food_x.size());
+    for (int i = 0; i < food_x.size(); ++i)
+        out << qint32(food_x[i]) << qint32(food_y[i]) << qint32(food_type[i]);
+
+    out << qint32(hazards.count());
+    for (int i = 0; i < hazards.count(); ++i)
+    {
+        const Hazard &hz = hazards.hazard(i);
+        out << qint32(hz.x) << qint32(hz.y) << qint32(hz.kind) << qint32(hz.originX)
+            << qint32(hz.originY) << qint32(hz.dx) << qint32(hz.dy) << qint32(hz.span)
+            << qint32(hz.stepNo) << qint32(hz.period) << qint32(hz.phase);
+    }
+
+    struct PendingTimer
+    {
+        quint64 seq;
+        quint64 due;
+        qint32 kind;
+        qint32 arg;
+    };
+    QVector<PendingTimer> pending;
+    for (int i = 0; i < EFFECT_COUNT; ++i)
+        if (effectTimer[i])
+            pending.append({timers.sequence(effectTimer[i]), timers.dueTick(effectTimer[i]),
+                            TIMER_EFFECT_END, i});
+    for (int i = 0; i < foodTimer.size(); ++i)
+        if (foodTimer[i])
+            pending.append({timers.sequence(foodTimer[i]), timers.dueTick(foodTimer[i]),
+                            TIMER_FOOD_EXPIRY, i});
+    std::sort(pending.begin(), pending.end(),
+              [](const PendingTimer &a, const PendingTimer &b) { return a.seq < b.seq; });
+    out << qint32(pending.size());
+    for (const PendingTimer &t : pending)
+        out << t.due << t.kind << t.arg;
+    return data;
+}
+
+// Tout est vérifié avant usage : le fichier peut venir d'une autre version
+// ou avoir été modifié. Rien n'est modifié avant la fin de la lecture : en
+// cas d'échec, la partie en cours reste intacte.
+bool Game::loadState(const QByteArray &data)
+{
+    QDataStream in(data);
+    quint32 version;
+    qint32 w, h, level, lay, foodsWanted, hazardsWanted;
+    bool onMap;
+    LevelParams params;
+    quint64 tick;
+    in >> version >> w >> h >> onMap >> level >> params.tickMs >> params.wallsPerThousand
+        >> params.clusterPercent >> params.roomPitch >> params.doorWidth >> params.mazePitch
+        >> lay >> foodsWanted >> hazardsWanted >> tick;
+    if (version != GAME_STATE_VERSION || in.status() != QDataStream::Ok || w < 8 || h < 8
+        || qint64(w) * h > (1 << 28) || level < 1 || level > LevelTable::LEVEL_COUNT
+        || !params.isValid() || lay < 0 || lay >= LAYOUT_COUNT)
+        return false;
+    if (onMap != !map.isNull() || (map && (map->width() != w || map->height() != h)))
+        return false;
+    int cells = w * h;
+
+    qint32 dir, nextDir, points, growth, death, speed;
+    bool over;
+    in >> dir >> nextDir >> points >> growth >> over >> death >> speed;
+    if (dir < UP || dir > RIGHT || nextDir < UP || nextDir > RIGHT || growth < 0
+        || death < DEATH_NONE || death > DEATH_ABANDON)
+        return false;
+
+    qint32 tailX, tailY, links;
+    QByteArray packed;
+    in >> tailX >> tailY >> links >> packed;
+    if (tailX < 0 || tailX >= w || tailY < 0 || tailY >= h || links < 0 || links >= cells
+        || packed.size() != (links + 3) / 4)
+        return false;
+
+    QByteArray bits;
+    if (!map)
+    {
+        in >> bits;
+        if (bits.size() != WallGrid::rowBytesFor(w) * h)
+            return false;
+    }
+
+    qint32 count;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 1 || count > cells)
+        return false;
+    QVector<int> foodX(count), foodY(count);
+    QVector<FruitType> foodType(count);
+    QVector<int> foodCell(cells, -1);
+    for (int i = 0; i < count; ++i)
+    {
+        qint32 x, y, type;
+        in >> x >> y >> type;
+        if (x < 0 || x >= w || y < 0 || y >= h || type < 0 || type >= FRUIT_TYPE_COUNT
+            || foodCell[y * w + x] >= 0)
+            return false;
+        foodX[i] = x;
+        foodY[i] = y;
+        foodType[i] = static_cast<FruitType>(type);
+        foodCell[y * w + x] = i;
+    }
+
+    // Une patrouille suit un axe, sur moins d'un tour de plateau, et son
+    // avancement reste dans l'aller-retour ; un poursuivant n'en a pas
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0 || count > cells)
+        return false;
+    QVector<Hazard> hazardList(count);
+    for (Hazard &hz : hazardList)
+    {
+        qint32 kind;
+        in >> hz.x >> hz.y >> kind >> hz.originX >> hz.originY >> hz.dx >> hz.dy >> hz.span
+            >> hz.stepNo >> hz.period >> hz.phase;
+        bool placed = hz.x >= 0 && hz.x < w && hz.y >= 0 && hz.y < h && hz.originX >= 0
+                      && hz.originX < w && hz.originY >= 0 && hz.originY < h
+                      && hz.period >= 1 && hz.phase >= 0 && hz.phase < hz.period;
+        bool patrol = kind == HAZARD_PATROL && qAbs(hz.dx) + qAbs(hz.dy) == 1
+                      && hz.span >= 1 && hz.span < qMax(w, h)
+                      && hz.stepNo >= 0 && hz.stepNo < 2 * hz.span;
+        bool chaser = kind == HAZARD_CHASER && hz.dx == 0 && hz.dy == 0 && hz.span == 0
+                      && hz.stepNo == 0;
+        if (!placed || !(patrol || chaser))
+            return false;
+        hz.kind = static_cast<HazardKind>(kind);
+    }
+
+    struct PendingTimer
+    {
+        quint64 due;
+        qint32 kind;
+        qint32 arg;
+    };
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0 || count > EFFECT_COUNT + foodX.size())
+        return false;
+    QVector<PendingTimer> pending(count);
+    QVector<bool> timed(EFFECT_COUNT + foodX.size(), false);
+    for (PendingTimer &t : pending)
+    {
+        in >> t.due >> t.kind >> t.arg;
+        int slot = -1;
+        if (t.kind == TIMER_EFFECT_END && t.arg >= 0 && t.arg < EFFECT_COUNT)
+            slot = t.arg;
+        else if (t.kind == TIMER_FOOD_EXPIRY && t.arg >= 0 && t.arg < foodX.size())
+            slot = EFFECT_COUNT + t.arg;
+        if (t.due <= tick || slot < 0 || timed[slot])
+            return false;
+        timed[slot] = true;
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    // Flux entièrement valide : la partie est remplacée
+    boardW = w;
+    boardH = h;
+    currentLevel = level;
+    levels.setLevel(currentLevel, params);
+    layout = static_cast<LayoutStyle>(lay);
+    requestedFood = qMax(1, int(foodsWanted));
+    requestedHazards = qMax(0, int(hazardsWanted));
+    direction = static_cast<Direction>(dir);
+    nextDirection = static_cast<Direction>(nextDir);
+    score = points;
+    pendingGrowth = growth;
+    gameOver = over;
+    cause = static_cast<DeathCause>(death);
+    speedPercent = qBound(10, int(speed), 100);
+    lastFruitEaten = -1;
+
+    body.reset(boardW, boardH, tailX, tailY);
+    for (int i = 0; i < links; ++i)
+        body.pushHead(static_cast<Direction>(((uchar(packed[i >> 2]) >> ((i & 3) * 2)) & 3) + 1));
+    if (map)
+    {
+        walls.attach(map->bitmap(), boardW, boardH, map->rowBytes());
+    }
+    else
+    {
+        walls.reset(boardW, boardH);
+        memcpy(walls.mutableRow(0), bits.constData(), size_t(bits.size()));
+    }
+    trackSnake();
+
+    food_x = foodX;
+    food_y = foodY;
+    food_type = foodType;
+    foodAt = foodCell;
+
+    hazards.reset(boardW, boardH);
+    for (const Hazard &hz : hazardList)
+        hazards.restore(hz);
+
+    timers.reset(tick);
+    for (int i = 0; i < EFFECT_COUNT; ++i)
+        effectTimer[i] = 0;
+    foodTimer.fill(0, food_x.size());
+    for (const PendingTimer &t : pending)
+    {
+        TimerWheel::TimerId id = timers.schedule(t.due, t.kind, t.arg);
+        if (t.kind == TIMER_EFFECT_END)
+            effectTimer[t.arg] = id;
+        else
+            foodTimer[t.arg] = id;
+    }
+    return true;
 }
@@ -1,34 +1,34 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <QByteArray>
 #include <QObject>
 #include <QVector>
 #include <QRandomGenerator>
+#include <QSharedPointer>
+#include "direction.h"
+#include "freespace.h"
+#include "hazards.h"
+#include "itemtable.h"
+#include "levelgen.h"
+#include "packedbody.h"
+#include "timerwheel.h"
+#include "wallgrid.h"
+
+class MapFile;
 
 // Dimensions du jeu (en cases)
 #define WIDTH 40
 #define HEIGHT 25
 
-enum Direction
+// Cause de la fin de partie
+enum DeathCause
 {
-    UP = 1,
-    DOWN = 2,
-    LEFT = 3,
-    RIGHT = 4
-};
-
-enum FruitType
-{
-    APPLE,
-    BANANA,
-    PINEAPPLE
-};
-
-struct SnakeNode
-{
-    int x;
-    int y;
-    SnakeNode *next;
+    DEATH_NONE,
+    DEATH_WALL,
+    DEATH_BODY,
+    DEATH_HAZARD,
+    DEATH_ABANDON
 };
 
 struct Obstacle
@@ -42,7 +42,9 @@ class Game : public QObject
     Q_OBJECT
 
 public:
-    static const int FOOD_COUNT = 3;
+    static constexpr int FOOD_COUNT = 3;          // fruits par défaut
+    static constexpr int FRENZY_FOOD_COUNT = 200; // mode frénésie
+    static constexpr int DANGER_HAZARD_COUNT = 12; // mode dangers
 
     explicit Game(QObject *parent = nullptr);
     ~Game();
@@ -54,18 +56,98 @@ public:
     // NOUVEAU : gestion du niveau
     void setLevel(int level);
     int getLevel() const { return currentLevel; }
-    int getSpeed() const;  // Retourne la vitesse selon le niveau
-
-    SnakeNode *snakeHead() const { return head; }
+    int getSpeed() const;  // Retourne la vitesse selon le niveau (et l'éclair)
+    // Réglages des niveaux (voir LevelTable) ; la densité des murs est
+    // prise en compte au prochain reset()
+    void setLevelTable(const LevelTable &table) { levels = table; }
+    const LevelParams &levelParams() const { return levels.level(currentLevel); }
+
+    // Graine du générateur : deux parties de même graine sont identiques
+    void setSeed(quint32 seed) { rng.seed(seed); }
+    // Graine tirée du générateur puis appliquée : l'état interne d'un
+    // QRandomGenerator ne s'enregistre pas, une partie sauvegardée repart
+    // donc d'une graine connue, la même pour elle et pour sa copie
+    quint32 reseed()
+    {
+        quint32 seed = rng.generate();
+        rng.seed(seed);
+        return seed;
+    }
+
+    // État complet de la partie (sauvegarde automatique), sauf le
+    // générateur (voir reseed()) et la carte : loadState() attend la même
+    // carte, déjà ouverte par loadMap(). La grille du corps et les
+    // composantes libres sont reconstruites, en O(cases). Un état refusé
+    // (false) laisse la partie en cours inchangée.
+    QByteArray saveState() const;
+    bool loadState(const QByteArray &data);
+
+    // Disposition des murs sans carte, toujours entièrement accessible ;
+    // prise en compte au prochain reset()
+    void setLayoutStyle(LayoutStyle style) { layout = style; }
+    LayoutStyle layoutStyle() const { return layout; }
+
+    // Carte dessinée (.snkm) à la place des obstacles aléatoires ; prise
+    // en compte au prochain reset()
+    bool loadMap(const QString &path, QString *error = nullptr);
+    void clearMap();
+    bool hasMap() const { return !map.isNull(); }
+    QSharedPointer<MapFile> mapFile() const { return map; }
+
+    int boardWidth() const { return boardW; }
+    int boardHeight() const { return boardH; }
+    bool isWall(int x, int y) const { return walls.isWall(x, y); }
+    const WallGrid &wallGrid() const { return walls; }
+
+    // Corps en 2 bits par segment ; parcours depuis la tête par cursor()
+    const PackedBody &snakeBody() const { return body; }
+    int headX() const { return body.headX(); }
+    int headY() const { return body.headY(); }
     int getScore() const { return score; }
-    int getLength() const { return length; }
+    int getLength() const { return body.length(); }
+    // Nombre de fruits simultanés, pris en compte au prochain reset() ;
+    // borné à la moitié des cases libres
+    void setFoodCount(int count) { requestedFood = qMax(1, count); }
     int foodX(int i) const { return food_x[i]; }
     int foodY(int i) const { return food_y[i]; }
     FruitType foodType(int i) const { return food_type[i]; }
-    int foodCount() const { return FOOD_COUNT; }
+    int foodCount() const { return static_cast<int>(food_x.size()); }
+    int foodIndexAt(int x, int y) const { return foodAt[y * boardW + x]; }  // -1 : aucun
+    int foodTicksLeft(int i) const;  // -1 : objet permanent
+
+    // Dangers mobiles (patrouilles, murs mobiles, poursuivants), placés
+    // au prochain reset() ; les toucher de la tête termine la partie
+    void setHazardCount(int count) { requestedHazards = qMax(0, count); }
+    const HazardField &hazardField() const { return hazards; }
+    bool isHazard(int x, int y) const { return hazards.contains(x, y); }
+
     bool isGameOver() const { return gameOver; }
+    DeathCause deathCause() const { return cause; }
     Direction getDirection() const { return direction; }
-    const QVector<Obstacle> &getObstacles() const { return obstacles; }
+
+    bool isOccupied(int x, int y) const { return bodyStamp[y * boardW + x] != 0; }
+
+    // Pas joués depuis reset() ; les effets et expirations y sont indexés
+    quint64 tickCount() const { return timers.now(); }
+    int effectTicksLeft(ItemEffect effect) const;  // 0 : inactif
+    bool isGhost() const { return effectTimer[EFFECT_GHOST] != 0; }
+
+    // Cases libres accessibles depuis la tête, en O(1) : taille des
+    // composantes libres voisines de la tête, tenues à jour à chaque pas
+    int reachableArea() const;
+    // Partie perdue quoi qu'on joue : la poche accessible sera remplie avant
+    // qu'un segment qui la borde ne se libère. Jamais de faux positif (les
+    // fruits retardent la queue ; un raccourcissement possible dans la
+    // poche ou le mode fantôme interdisent de conclure) ; la détection peut
+    // tarder.
+    bool isDoomed() const;
+    // Termine la partie (lots d'entraînement : parties condamnées)
+    void abandon()
+    {
+        gameOver = true;
+        cause = DEATH_ABANDON;
+    }
+    const FreeSpaceTracker &freeSpace() const { return space; }
 
     int getLastFruitEaten() const { return lastFruitEaten; }
     void clearLastFruitEaten() { lastFruitEaten = -1; }
@@ -74,31 +156,73 @@ signals:
     void fruitEaten(int x, int y, int points, FruitType type);
 
 private:
-    SnakeNode *head;
-    int length;
+    PackedBody body;
     Direction direction;
     Direction nextDirection;
-    int food_x[FOOD_COUNT];
-    int food_y[FOOD_COUNT];
-    FruitType food_type[FOOD_COUNT];
+    QVector<int> food_x;
+    QVector<int> food_y;
+    QVector<FruitType> food_type;
+    QVector<qint32> foodAt;          // case -> index du fruit (-1 = aucun)
+    int requestedFood;
     int score;
+    int pendingGrowth;  // segments encore à gagner (queue immobile)
     bool gameOver;
-    QVector<Obstacle> obstacles;
+    DeathCause cause;
+    int boardW;
+    int boardH;
+    WallGrid walls;                  // grille de collision des murs
+    QSharedPointer<MapFile> map;     // garde la projection de la carte ouverte
+    LayoutStyle layout;
+    HazardField hazards;
+    int requestedHazards;
+    QVector<quint32> bodyStamp;      // par case : rang du dernier segment entré, 0 si hors du corps
+    quint32 headStamp;               // rang de la tête actuelle
+    quint32 tailStamp;               // rang de la queue actuelle
+    FreeSpaceTracker space;          // composantes libres (ni mur ni corps)
+    mutable QVector<quint32> visitMark;
+    mutable QVector<int> visitQueue;
+    mutable quint32 visitEpoch;
     int lastFruitEaten;
+
+    // Effets à durée et objets éphémères : une échéance par minuterie,
+    // rien n'est décompté à chaque pas
+    enum TimerKind
+    {
+        TIMER_EFFECT_END,    // arg : ItemEffect
+        TIMER_FOOD_EXPIRY    // arg : index du fruit
+    };
+    TimerWheel timers;
+    QVector<TimerEvent> firedTimers;
+    QVector<TimerWheel::TimerId> foodTimer;
+    TimerWheel::TimerId effectTimer[EFFECT_COUNT];
+    int speedPercent;
+
     int currentLevel;  // NOUVEAU : niveau actuel (1, 2, ou 3)
+    LevelTable levels;
+    QRandomGenerator rng;  // Générateur propre à la partie (reproductible)
 
-    SnakeNode *createNode(int x, int y);
-    void addSegment(int x, int y);
     void removeLastSegment();
-    void freeSnake();
     void generateFood();
     void generateSingleFood(int index);
     void generateObstacles();
-    bool isPositionObstacle(int x, int y);
-    bool isPositionOnSnake(int x, int y);
-    int checkCollision();
+    void generateHazards(int budget);
+    bool hazardSiteOk(int x, int y, int margin) const;
+    bool isPositionObstacle(int x, int y) const { return walls.isWall(x, y); }
+    bool isPositionOnSnake(int x, int y) const { return isOccupied(x, y); }
+    void trackSnake();
+    DeathCause checkCollision();
     int checkFoodCollision();
     void moveSnake();
+    void handleTimer(const TimerEvent &event);
+    void startEffect(const ItemType &item);
+
+    // Effets des objets, indexés par ItemEffect
+    typedef void (Game::*EffectHandler)(const ItemType &item);
+    static const EffectHandler effectHandlers[EFFECT_COUNT];
+    void applyNoEffect(const ItemType &item);
+    void applyShrink(const ItemType &item);
+    void applySpeed(const ItemType &item);
+    void applyGhost(const ItemType &item);
 };
 
 #endif // GAME_H
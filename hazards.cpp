@@ -0,0 +1,177 @@
+#include "hazards.h"
+
+#include <cstdlib>
+
+static constexpr int MIN_HASH_BITS = 6;
+
+HazardField::HazardField()
+    : w(0),
+    h(0),
+    hashShift(32 - MIN_HASH_BITS)
+{
+    reset(0, 0);
+}
+
+void HazardField::reset(int width, int height)
+{
+    w = width;
+    h = height;
+    hazards.clear();
+    nextInBucket.clear();
+    bucketHead.fill(-1, 1 << MIN_HASH_BITS);
+    hashShift = 32 - MIN_HASH_BITS;
+}
+
+int HazardField::find(int cell) const
+{
+    for (int i = bucketHead[bucketOf(cell)]; i >= 0; i = nextInBucket[i])
+    {
+        if (hazards[i].y * w + hazards[i].x == cell)
+            return i;
+    }
+    return -1;
+}
+
+void HazardField::link(int i)
+{
+    int b = bucketOf(hazards[i].y * w + hazards[i].x);
+    nextInBucket[i] = bucketHead[b];
+    bucketHead[b] = i;
+}
+
+void HazardField::unlink(int i)
+{
+    int *p = &bucketHead[bucketOf(hazards[i].y * w + hazards[i].x)];
+    while (*p != i)
+        p = &nextInBucket[*p];
+    *p = nextInBucket[i];
+}
+
+// Deux seaux par danger au moins : les chaînes restent courtes en moyenne
+void HazardField::rehash(int bits)
+{
+    hashShift = 32 - bits;
+    bucketHead.fill(-1, 1 << bits);
+    for (int i = 0; i < hazards.size(); ++i)
+        link(i);
+}
+
+int HazardField::append(const Hazard &hz)
+{
+    int i = static_cast<int>(hazards.size());
+    hazards.append(hz);
+    nextInBucket.append(-1);
+    if (hazards.size() * 2 > bucketHead.size())
+        rehash(33 - hashShift);
+    else
+        link(i);
+    return i;
+}
+
+int HazardField::addPatrol(int x, int y, int dx, int dy, int span, int period, int phase)
+{
+    Hazard hz;
+    hz.x = x;
+    hz.y = y;
+    hz.kind = HAZARD_PATROL;
+    hz.originX = x;
+    hz.originY = y;
+    hz.dx = dx;
+    hz.dy = dy;
+    hz.span = qMax(1, span);
+    hz.stepNo = 0;
+    hz.period = qMax(1, period);
+    hz.phase = phase;
+    return append(hz);
+}
+
+int HazardField::addChaser(int x, int y, int period, int phase)
+{
+    Hazard hz;
+    hz.x = x;
+    hz.y = y;
+    hz.kind = HAZARD_CHASER;
+    hz.originX = x;
+    hz.originY = y;
+    hz.dx = 0;
+    hz.dy = 0;
+    hz.span = 0;
+    hz.stepNo = 0;
+    hz.period = qMax(1, period);
+    hz.phase = phase;
+    return append(hz);
+}
+
+void HazardField::moveTo(int i, int x, int y)
+{
+    Hazard &hz = hazards[i];
+    if (hz.x == x && hz.y == y)
+        return;
+    int from = bucketOf(hz.y * w + hz.x);
+    int to = bucketOf(y * w + x);
+    if (from == to)
+    {
+        hz.x = x;
+        hz.y = y;
+        return;
+    }
+    unlink(i);
+    hz.x = x;
+    hz.y = y;
+    link(i);
+}
+
+// Position fonction du seul numéro de déplacement : aller puis retour sur
+// `span` cases, trajet vérifié libre à la création
+void HazardField::stepPatrol(int i)
+{
+    Hazard &hz = hazards[i];
+    hz.stepNo = (hz.stepNo + 1) % (2 * hz.span);
+    int t = hz.stepNo;
+    int offset = t <= hz.span ? t : 2 * hz.span - t;
+    moveTo(i, (hz.originX + offset * hz.dx + w) % w, (hz.originY + offset * hz.dy + h) % h);
+}
+
+// Glouton : la case voisine la plus proche de la cible (bords repliés),
+// ni mur ni autre danger ; immobile si aucune ne rapproche
+void HazardField::stepChaser(int i, const WallGrid &walls, int targetX, int targetY)
+{
+    static const int dirs[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    const Hazard &hz = hazards[i];
+    auto distance = [this, targetX, targetY](int x, int y) {
+        int ddx = std::abs(targetX - x), ddy = std::abs(targetY - y);
+        return qMin(ddx, w - ddx) + qMin(ddy, h - ddy);
+    };
+
+    int best = distance(hz.x, hz.y);
+    int bestX = hz.x, bestY = hz.y;
+    for (const int *d : dirs)
+    {
+        int x = (hz.x + d[0] + w) % w;
+        int y = (hz.y + d[1] + h) % h;
+        if (walls.isWall(x, y) || contains(x, y))
+            continue;
+        int dist = distance(x, y);
+        if (dist < best)
+        {
+            best = dist;
+            bestX = x;
+            bestY = y;
+        }
+    }
+    moveTo(i, bestX, bestY);
+}
+
+void HazardField::step(quint64 tick, const WallGrid &walls, int targetX, int targetY)
+{
+    for (int i = 0; i < hazards.size(); ++i)
+    {
+        const Hazard &hz = hazards[i];
+        if ((tick + quint64(hz.phase)) % quint64(hz.period))
+            continue;
+        if (hz.kind == HAZARD_PATROL)
+            stepPatrol(i);
+        else
+            stepChaser(i, walls, targetX, targetY);
+    }
+}
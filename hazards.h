@@ -0,0 +1,72 @@
+#ifndef HAZARDS_H
+#define HAZARDS_H
+
+#include <QVector>
+#include "wallgrid.h"
+
+enum HazardKind
+{
+    HAZARD_PATROL,  // va-et-vient sur un segment (les murs mobiles en alignent plusieurs)
+    HAZARD_CHASER   // se rapproche de la cible, sans traverser de mur
+};
+
+struct Hazard
+{
+    int x;
+    int y;
+    HazardKind kind;
+    int originX;   // patrouille : départ, direction et longueur du trajet
+    int originY;
+    int dx;
+    int dy;
+    int span;
+    int stepNo;
+    int period;    // un déplacement tous les `period` pas
+    int phase;
+};
+
+// Dangers mobiles d'un plateau torique, indexés par case dans une table de
+// hachage : un test de case coûte O(1) en moyenne, quel que soit le nombre
+// de dangers, et la mémoire ne dépend que de ce nombre (pas de grille par
+// case, les cartes projetées pouvant être immenses). Seuls les dangers qui
+// bougent sont retirés puis réinsérés à chaque pas.
+class HazardField
+{
+public:
+    HazardField();
+
+    // Plateau vide ; les dangers sont ensuite ajoutés un par un
+    void reset(int width, int height);
+    int addPatrol(int x, int y, int dx, int dy, int span, int period, int phase);
+    int addChaser(int x, int y, int period, int phase);
+    // Danger repris tel quel, position et avancement compris (sauvegarde)
+    int restore(const Hazard &hz) { return append(hz); }
+
+    int count() const { return static_cast<int>(hazards.size()); }
+    const Hazard &hazard(int i) const { return hazards[i]; }
+    bool contains(int x, int y) const { return find(y * w + x) >= 0; }
+    int hazardAt(int x, int y) const { return find(y * w + x); }  // -1 : aucun
+
+    // Déplacements du pas `tick` ; les poursuivants visent (targetX, targetY)
+    void step(quint64 tick, const WallGrid &walls, int targetX, int targetY);
+
+private:
+    int w;
+    int h;
+    QVector<Hazard> hazards;
+    QVector<int> bucketHead;   // premier danger du seau, -1 si vide
+    QVector<int> nextInBucket;
+    int hashShift;
+
+    int bucketOf(int cell) const { return int((quint32(cell) * 0x9E3779B1u) >> hashShift); }
+    int find(int cell) const;
+    int append(const Hazard &hz);
+    void link(int i);
+    void unlink(int i);
+    void moveTo(int i, int x, int y);
+    void rehash(int bits);
+    void stepPatrol(int i);
+    void stepChaser(int i, const WallGrid &walls, int targetX, int targetY);
+};
+
+#endif // HAZARDS_H
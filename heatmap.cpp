@@ -0,0 +1,162 @@
+#include "heatmap.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+
+static constexpr int HEADER_BYTES = 4 * 4 + 8;
+// Taille d'un QByteArray en Qt 5 (un int), gardée en Qt 6 pour que les
+// fichiers restent lisibles par les deux
+static constexpr qint64 MAX_FILE_BYTES = 0x7FFFFFFF - 64;
+
+void HeatMap::reset(int width, int height)
+{
+    w = width;
+    h = height;
+    visits.fill(0, w * h);
+    deaths.fill(0, w * h);
+    games = 0;
+}
+
+void HeatMap::clear()
+{
+    visits.fill(0);
+    deaths.fill(0);
+    games = 0;
+}
+
+quint32 HeatMap::maxVisits() const
+{
+    return visits.isEmpty() ? 0 : *std::max_element(visits.cbegin(), visits.cend());
+}
+
+quint32 HeatMap::maxDeaths() const
+{
+    return deaths.isEmpty() ? 0 : *std::max_element(deaths.cbegin(), deaths.cend());
+}
+
+static void addSaturated(QVector<quint32> &to, const QVector<quint32> &from)
+{
+    quint32 *t = to.data();
+    const quint32 *f = from.constData();
+    for (int i = 0; i < to.size(); ++i)
+        t[i] = quint32(qMin<quint64>(quint64(t[i]) + f[i], 0xFFFFFFFFu));
+}
+
+bool HeatMap::merge(const HeatMap &other)
+{
+    if (other.w != w || other.h != h)
+        return false;
+    addSaturated(visits, other.visits);
+    addSaturated(deaths, other.deaths);
+    games += other.games;
+    return true;
+}
+
+bool HeatMap::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    QByteArray data = file.readAll();
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    if (data.size() < HEADER_BYTES || qFromLittleEndian<quint32>(p) != HEATMAP_MAGIC
+        || qFromLittleEndian<quint32>(p + 4) != HEATMAP_VERSION)
+    {
+        if (error)
+            *error = "pas une carte de chaleur (.snkh) de cette version";
+        return false;
+    }
+    int width = int(qFromLittleEndian<quint32>(p + 8));
+    int height = int(qFromLittleEndian<quint32>(p + 12));
+    if (width <= 0 || height <= 0 || width > 65536 || height > 65536
+        || data.size() != HEADER_BYTES + qint64(width) * height * 8)
+    {
+        if (error)
+            *error = "carte de chaleur tronquee";
+        return false;
+    }
+    reset(width, height);
+    games = qFromLittleEndian<quint64>(p + 16);
+    p += HEADER_BYTES;
+    for (int i = 0; i < w * h; ++i)
+        visits[i] = qFromLittleEndian<quint32>(p + 4 * i);
+    p += 4 * w * h;
+    for (int i = 0; i < w * h; ++i)
+        deaths[i] = qFromLittleEndian<quint32>(p + 4 * i);
+    return true;
+}
+
+bool HeatMap::save(const QString &path, QString *error) const
+{
+    qint64 bytes = HEADER_BYTES + qint64(w) * h * 8;
+    if (bytes > MAX_FILE_BYTES)
+    {
+        if (error)
+            *error = QString("carte de chaleur trop grande (%1x%2)").arg(w).arg(h);
+        return false;
+    }
+    QByteArray data(int(bytes), '\0');
+    uchar *p = reinterpret_cast<uchar *>(data.data());
+    qToLittleEndian<quint32>(HEATMAP_MAGIC, p);
+    qToLittleEndian<quint32>(HEATMAP_VERSION, p + 4);
+    qToLittleEndian<quint32>(quint32(w), p + 8);
+    qToLittleEndian<quint32>(quint32(h), p + 12);
+    qToLittleEndian<quint64>(games, p + 16);
+    p += HEADER_BYTES;
+    for (int i = 0; i < w * h; ++i)
+        qToLittleEndian<quint32>(visits[i], p + 4 * i);
+    p += 4 * w * h;
+    for (int i = 0; i < w * h; ++i)
+        qToLittleEndian<quint32>(deaths[i], p + 4 * i);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Un fichier d'autres dimensions (carte redessinée) est remplacé ; un
+// fichier illisible ou abîmé est laissé tel quel, les compteurs restant
+// en mémoire jusqu'à l'écriture suivante
+bool HeatMap::flushTo(const QString &path, QString *error)
+{
+    if (isEmpty())
+        return true;
+    HeatMap total;
+    if (QFileInfo::exists(path))
+    {
+        if (!total.load(path, error))
+            return false;
+        if (!total.merge(*this))
+            total = *this;
+    }
+    else
+    {
+        total = *this;
+    }
+    if (!total.save(path, error))
+        return false;
+    clear();
+    return true;
+}
+
+QString HeatMap::fileName(const QString &mapPath, LayoutStyle layout, int level,
+                          int width, int height)
+{
+    static const char *const LAYOUT_NAMES[LAYOUT_COUNT] = {"aleatoire", "amas", "salles",
+                                                           "labyrinthe"};
+    if (!mapPath.isEmpty())
+        return QString("carte-%1.snkh").arg(QFileInfo(mapPath).completeBaseName());
+    return QString("%1-n%2-%3x%4.snkh").arg(LAYOUT_NAMES[layout]).arg(level).arg(width).arg(height);
+}
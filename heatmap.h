@@ -0,0 +1,65 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <QString>
+#include <QVector>
+#include "levelgen.h"
+
+// Carte de chaleur d'un plateau : passages de la tête et morts par case,
+// cumulés sur toutes les parties d'une même configuration (carte, ou
+// disposition + niveau + dimensions). Compteurs de 32 bits, saturés à la
+// fusion ; un pas ne coûte qu'un incrément.
+//
+// Fichier (.snkh, petit-boutiste) : magic | version | largeur | hauteur |
+// parties u64 | passages u32 par case | morts u32 par case. flushTo()
+// ajoute les compteurs en mémoire au fichier puis les remet à zéro : les
+// écritures périodiques ne perdent ni ne comptent deux fois aucune partie.
+
+#define HEATMAP_MAGIC 0x484B4E53u  // "SNKH"
+#define HEATMAP_VERSION 1
+
+class HeatMap
+{
+public:
+    HeatMap() : w(0), h(0), games(0) {}
+    HeatMap(int width, int height) : games(0) { reset(width, height); }
+
+    void reset(int width, int height);   // dimensions, compteurs à zéro
+    void clear();                        // compteurs à zéro
+
+    int width() const { return w; }
+    int height() const { return h; }
+    quint64 gameCount() const { return games; }
+    bool isEmpty() const { return games == 0; }
+
+    void visit(int cell) { ++visits[cell]; }
+    void death(int cell)
+    {
+        ++deaths[cell];
+        ++games;
+    }
+    quint32 visitsAt(int cell) const { return visits[cell]; }
+    quint32 deathsAt(int cell) const { return deaths[cell]; }
+    quint32 maxVisits() const;
+    quint32 maxDeaths() const;
+
+    // Faux si les dimensions diffèrent
+    bool merge(const HeatMap &other);
+
+    bool load(const QString &path, QString *error = nullptr);
+    bool save(const QString &path, QString *error = nullptr) const;
+    bool flushTo(const QString &path, QString *error = nullptr);
+
+    // Nom de fichier (sans dossier) de la configuration
+    static QString fileName(const QString &mapPath, LayoutStyle layout, int level,
+                            int width, int height);
+
+private:
+    int w;
+    int h;
+    quint64 games;
+    QVector<quint32> visits;
+    QVector<quint32> deaths;
+};
+
+#endif // HEATMAP_H
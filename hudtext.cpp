@@ -0,0 +1,79 @@
+#include "hudtext.h"
+
+#include <QFontMetrics>
+
+HudText::HudText(const QFont &font, const QString &format)
+    : font(font),
+    format(format),
+    value(0),
+    second(0),
+    hasValue(false),
+    ascent(QFontMetrics(font).ascent())
+{
+    staticText.setTextFormat(Qt::PlainText);
+    staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+}
+
+void HudText::setText(const QString &text)
+{
+    hasValue = false;
+    if (text == current)
+        return;
+    current = text;
+    staticText.setText(text);
+    staticText.prepare(QTransform(), font);
+}
+
+void HudText::setValue(qint64 v)
+{
+    if (hasValue && v == value)
+        return;
+    setText(format.arg(v));
+    value = v;
+    hasValue = true;
+}
+
+void HudText::setValues(qint64 first, qint64 next)
+{
+    if (hasValue && first == value && next == second)
+        return;
+    setText(format.arg(first).arg(next));
+    value = first;
+    second = next;
+    hasValue = true;
+}
+
+// Comparé en entier à la précision affichée : une mesure qui varie sous
+// l'arrondi ne reformate rien
+void HudText::setValue(double v, int decimals)
+{
+    qint64 rounded = qRound64(v * qPow(10.0, decimals));
+    if (hasValue && rounded == value)
+        return;
+    setText(format.arg(v, 0, 'f', decimals));
+    value = rounded;
+    hasValue = true;
+}
+
+void HudText::setFormat(const QString &f)
+{
+    if (f == format)
+        return;
+    format = f;
+    hasValue = false;
+}
+
+void HudText::draw(QPainter &p, int x, int baseline, const QColor &color) const
+{
+    p.setFont(font);
+    p.setPen(color);
+    p.drawStaticText(x, baseline - ascent, staticText);
+}
+
+void HudText::drawCentered(QPainter &p, const QRect &rect, const QColor &color) const
+{
+    p.setFont(font);
+    p.setPen(color);
+    p.drawStaticText(rect.left() + (rect.width() - width()) / 2,
+                     rect.top() + (rect.height() - height()) / 2, staticText);
+}
@@ -0,0 +1,43 @@
+#ifndef HUDTEXT_H
+#define HUDTEXT_H
+
+#include <QFont>
+#include <QPainter>
+#include <QStaticText>
+#include <QString>
+#include <QtMath>
+
+// Texte d'interface mis en page une seule fois : police et QStaticText
+// gardés d'une image à l'autre, nouvelle mise en page seulement quand le
+// texte change. Pour un champ numérique, setValue() ne formate même rien
+// tant que la valeur reste la même.
+class HudText
+{
+public:
+    explicit HudText(const QFont &font = QFont(), const QString &format = QString());
+
+    void setText(const QString &text);
+    void setValue(qint64 value);                 // remplace %1 dans le format
+    void setValues(qint64 first, qint64 second); // %1 et %2
+    void setValue(double value, int decimals);   // remis en page si l'arrondi change
+    void setFormat(const QString &format);       // la valeur est à redonner
+
+    int width() const { return qCeil(staticText.size().width()); }
+    int height() const { return qCeil(staticText.size().height()); }
+
+    // Même position que QPainter::drawText(x, y, texte) : y est la ligne de base
+    void draw(QPainter &p, int x, int baseline, const QColor &color) const;
+    void drawCentered(QPainter &p, const QRect &rect, const QColor &color) const;
+
+private:
+    QFont font;
+    QString format;
+    QString current;
+    qint64 value;
+    qint64 second;
+    bool hasValue;
+    int ascent;
+    QStaticText staticText;
+};
+
+#endif // HUDTEXT_H
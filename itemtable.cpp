@@ -0,0 +1,73 @@
+#include "itemtable.h"
+
+const ItemType ITEM_TYPES[FRUIT_TYPE_COUNT] = {
+    //  nom         points  poids  croiss.  effet          qté  durée  vie  dessin            couleur
+    { "pomme",      10,     50,    1,       EFFECT_NONE,   0,   0,     0,   SPRITE_APPLE,     0xFF5050 },
+    { "banane",     15,     30,    1,       EFFECT_NONE,   0,   0,     0,   SPRITE_BANANA,    0xFFEB00 },
+    { "ananas",     25,     14,    1,       EFFECT_NONE,   0,   0,     0,   SPRITE_PINEAPPLE, 0xFFA500 },
+    { "cerises",    40,     6,     2,       EFFECT_NONE,   0,   0,     60,  SPRITE_CHERRY,    0xE0204A },
+    { "ciseaux",    5,      4,     0,       EFFECT_SHRINK, 3,   0,     80,  SPRITE_SCISSORS,  0xB478FF },
+    { "eclair",     5,      4,     1,       EFFECT_SPEED,  60,  50,    80,  SPRITE_BOLT,      0x50C8FF },
+    { "fantome",    5,      3,     1,       EFFECT_GHOST,  0,   40,    80,  SPRITE_GHOST,     0xDCDCFF },
+};
+
+AliasSampler::AliasSampler(const QVector<int> &weights)
+{
+    int n = static_cast<int>(weights.size());
+    qint64 total = 0;
+    for (int w : weights)
+        total += qMax(0, w);
+    if (n == 0 || total == 0)
+        return;
+
+    // Probabilités ramenées à une moyenne de 1 : les entrées sous 1 sont
+    // complétées par une entrée au-dessus, qui devient leur alias
+    QVector<double> scaled(n);
+    QVector<int> small, large;
+    for (int i = 0; i < n; ++i)
+    {
+        scaled[i] = double(qMax(0, weights[i])) * n / double(total);
+        (scaled[i] < 1.0 ? small : large).append(i);
+    }
+    threshold.fill(0xFFFFFFFFu, n);
+    alias.resize(n);
+    for (int i = 0; i < n; ++i)
+        alias[i] = i;
+
+    while (!small.isEmpty() && !large.isEmpty())
+    {
+        int s = small.takeLast();
+        int l = large.last();
+        threshold[s] = static_cast<quint32>(scaled[s] * 4294967295.0);
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0)
+        {
+            large.removeLast();
+            small.append(l);
+        }
+    }
+    // Restes (arrondis) : gardés à coup sûr
+}
+
+const AliasSampler &itemSampler()
+{
+    static const AliasSampler sampler([] {
+        QVector<int> weights;
+        for (const ItemType &t : ITEM_TYPES)
+            weights.append(t.spawnWeight);
+        return weights;
+    }());
+    return sampler;
+}
+
+const AliasSampler &fruitSampler()
+{
+    static const AliasSampler sampler([] {
+        QVector<int> weights;
+        for (const ItemType &t : ITEM_TYPES)
+            weights.append(t.effect == EFFECT_NONE ? t.spawnWeight : 0);
+        return weights;
+    }());
+    return sampler;
+}
@@ -0,0 +1,93 @@
+#ifndef ITEMTABLE_H
+#define ITEMTABLE_H
+
+#include <QRandomGenerator>
+#include <QVector>
+
+// Objets ramassables : fruits et bonus. La valeur sert d'index dans
+// ITEM_TYPES, et passe telle quelle dans les observations et sur le réseau.
+enum FruitType
+{
+    APPLE,
+    BANANA,
+    PINEAPPLE,
+    CHERRY,
+    SCISSORS,
+    BOLT,
+    GHOST,
+    FRUIT_TYPE_COUNT
+};
+
+// Effet appliqué en plus des points et de la croissance
+enum ItemEffect
+{
+    EFFECT_NONE,
+    EFFECT_SHRINK,   // retire effectAmount segments de queue
+    EFFECT_SPEED,    // pas ramenés à effectAmount % de leur durée
+    EFFECT_GHOST,    // traverse son propre corps
+    EFFECT_COUNT
+};
+
+// Dessins disponibles (voir SnakeWidget::drawFruit)
+enum ItemSprite
+{
+    SPRITE_APPLE,
+    SPRITE_BANANA,
+    SPRITE_PINEAPPLE,
+    SPRITE_CHERRY,
+    SPRITE_SCISSORS,
+    SPRITE_BOLT,
+    SPRITE_GHOST,
+    SPRITE_COUNT
+};
+
+struct ItemType
+{
+    const char *name;
+    int points;
+    int spawnWeight;   // poids relatif au tirage
+    int growth;        // segments gagnés
+    ItemEffect effect;
+    int effectAmount;
+    int duration;      // pas d'effet, 0 : instantané
+    int lifetime;      // pas avant disparition, 0 : permanent
+    ItemSprite sprite;
+    quint32 color;     // 0xRRGGBB, texte des points gagnés
+};
+
+// Le registre : ajouter un objet, c'est ajouter une ligne ici (et un
+// dessin) ; le jeu n'a aucune branche par type
+extern const ItemType ITEM_TYPES[FRUIT_TYPE_COUNT];
+
+inline const ItemType &itemType(FruitType type) { return ITEM_TYPES[type]; }
+
+// Points rapportés par chaque fruit
+inline int fruitPoints(FruitType type) { return ITEM_TYPES[type].points; }
+
+// Tirage pondéré en O(1), méthode des alias (Walker, construction de
+// Vose) : une entrée tirée uniformément, puis un seuil choisit entre elle
+// et son alias. Un seul tirage 64 bits par échantillon.
+class AliasSampler
+{
+public:
+    AliasSampler() {}
+    explicit AliasSampler(const QVector<int> &weights);
+
+    int sample(QRandomGenerator &rng) const
+    {
+        quint64 r = rng.generate64();
+        int i = static_cast<int>(((r & 0xFFFFFFFFu) * quint64(threshold.size())) >> 32);
+        return quint32(r >> 32) < threshold[i] ? i : alias[i];
+    }
+    bool isEmpty() const { return threshold.isEmpty(); }
+
+private:
+    QVector<quint32> threshold;  // probabilité de garder l'entrée, sur 2^32
+    QVector<int> alias;
+};
+
+// Tous les objets (solo), ou seulement ceux sans effet (arène)
+const AliasSampler &itemSampler();
+const AliasSampler &fruitSampler();
+
+#endif // ITEMTABLE_H
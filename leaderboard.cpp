@@ -0,0 +1,410 @@
+#include "leaderboard.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QPair>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+
+// Journal : magic u32 | score u32 | longueur u32 | date s64 | crc32 u32
+static const quint32 RECORD_MAGIC = 0x524B4E53;  // "SNKR"
+static const int RECORD_SIZE = 24;
+static const quint32 INDEX_MAGIC = 0x494B4E53;   // "SNKI"
+static const quint32 INDEX_VERSION = 1;
+
+// Tous les fruits valent un multiple de 5 : un seau par score possible
+static const int BUCKET_STEP = 5;
+static const int BUCKETS = 16384;
+// L'index est réécrit au plus tous les INDEX_EVERY enregistrements :
+// c'est aussi le plus long morceau de journal relu au démarrage
+static const int INDEX_EVERY = 4096;
+static const int READ_CHUNK = RECORD_SIZE * 65536;
+
+static quint32 crc32(const char *data, int size)
+{
+    static quint32 table[256];
+    static bool ready = false;
+    if (!ready)
+    {
+        for (quint32 i = 0; i < 256; ++i)
+        {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < size; ++i)
+        crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static int bucketOf(int score)
+{
+    return qBound(0, score / BUCKET_STEP, BUCKETS - 1);
+}
+
+// Meilleur score d'abord ; à égalité, la partie la plus ancienne
+static bool ranksBefore(const LeaderboardEntry &a, const LeaderboardEntry &b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.timestamp < b.timestamp;
+}
+
+static bool decodeRecord(const char *p, LeaderboardEntry &e)
+{
+    if (qFromLittleEndian<quint32>(p) != RECORD_MAGIC)
+        return false;
+    if (qFromLittleEndian<quint32>(p + 20) != crc32(p, 20))
+        return false;
+    e.score = static_cast<int>(qFromLittleEndian<quint32>(p + 4));
+    e.length = static_cast<int>(qFromLittleEndian<quint32>(p + 8));
+    e.timestamp = qFromLittleEndian<qint64>(p + 12);
+    return true;
+}
+
+Leaderboard::Leaderboard(const QString &directory)
+    : dir(directory),
+    opened(false)
+{
+    if (dir.isEmpty())
+        dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/leaderboard";
+}
+
+Leaderboard::~Leaderboard()
+{
+    flush();
+}
+
+Leaderboard::Board *Leaderboard::board(int level)
+{
+    return (level >= 1 && level <= LEVELS) ? &boards[level - 1] : nullptr;
+}
+
+const Leaderboard::Board *Leaderboard::board(int level) const
+{
+    return (level >= 1 && level <= LEVELS) ? &boards[level - 1] : nullptr;
+}
+
+QString Leaderboard::logPath(int level) const
+{
+    return QString("%1/level%2.log").arg(dir).arg(level);
+}
+
+QString Leaderboard::indexPath(int level) const
+{
+    return QString("%1/level%2.idx").arg(dir).arg(level);
+}
+
+bool Leaderboard::open()
+{
+    if (opened)
+        return true;
+    if (!QDir().mkpath(dir))
+    {
+        error = "Impossible de creer " + dir;
+        return false;
+    }
+    for (int level = 1; level <= LEVELS; ++level)
+    {
+        if (!openLevel(level))
+            return false;
+    }
+    opened = true;
+    return true;
+}
+
+bool Leaderboard::openLevel(int level)
+{
+    Board &b = boards[level - 1];
+    b.log.setFileName(logPath(level));
+    if (!b.log.open(QIODevice::ReadWrite))
+    {
+        error = b.log.errorString();
+        return false;
+    }
+
+    qint64 size = b.log.size();
+    if (!loadIndex(level, size))
+    {
+        // Index absent ou incohérent : reconstruction complète, une seule fois
+        b.tree.fill(0, BUCKETS + 1);
+        b.best.clear();
+        b.games = 0;
+        b.indexedOffset = 0;
+    }
+
+    // Fin du journal non couverte par l'index
+    qint64 offset = b.indexedOffset;
+    b.log.seek(offset);
+    while (offset < size)
+    {
+        QByteArray chunk = b.log.read(READ_CHUNK);
+        if (chunk.isEmpty())
+            break;
+        int valid = 0;
+        LeaderboardEntry e;
+        while (valid + RECORD_SIZE <= chunk.size() && decodeRecord(chunk.constData() + valid, e))
+        {
+            add(b, e);
+            valid += RECORD_SIZE;
+        }
+        offset += valid;
+        if (valid < chunk.size())
+            break;
+    }
+
+    if (offset < size)
+    {
+        // Enregistrement tronqué ou corrompu (arrêt pendant une écriture) :
+        // on coupe pour que les ajouts suivants restent alignés
+        b.log.resize(offset);
+    }
+    b.log.seek(offset);
+    b.unindexed = static_cast<int>((offset - b.indexedOffset) / RECORD_SIZE);
+    if (b.unindexed >= INDEX_EVERY)
+        saveIndex(level);
+    return true;
+}
+
+bool Leaderboard::loadIndex(int level, qint64 logSize)
+{
+    Board &b = boards[level - 1];
+    QFile file(indexPath(level));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray data = file.readAll();
+    if (data.size() < 4)
+        return false;
+    int payloadSize = static_cast<int>(data.size()) - 4;
+    if (qFromLittleEndian<quint32>(data.constData() + payloadSize) != crc32(data.constData(), payloadSize))
+        return false;
+
+    QDataStream in(data.left(payloadSize));
+    quint32 magic, version, lastCrc;
+    qint32 storedLevel, buckets, count;
+    qint64 offset;
+    quint64 games;
+    in >> magic >> version >> storedLevel >> offset >> lastCrc >> games;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION || storedLevel != level)
+        return false;
+    if (offset < 0 || offset > logSize || offset % RECORD_SIZE != 0)
+        return false;
+
+    // Le dernier enregistrement couvert doit être celui du journal actuel
+    if (offset > 0)
+    {
+        b.log.seek(offset - RECORD_SIZE);
+        QByteArray last = b.log.read(RECORD_SIZE);
+        if (last.size() != RECORD_SIZE || qFromLittleEndian<quint32>(last.constData() + 20) != lastCrc)
+            return false;
+    }
+
+    // Histogramme creux, reconstruit en arbre de Fenwick en O(seaux)
+    b.tree.fill(0, BUCKETS + 1);
+    in >> buckets;
+    for (int i = 0; i < buckets && in.status() == QDataStream::Ok; ++i)
+    {
+        qint32 bucket;
+        quint64 n;
+        in >> bucket >> n;
+        if (bucket < 0 || bucket >= BUCKETS)
+            return false;
+        b.tree[bucket + 1] += n;
+    }
+    for (int i = 1; i <= BUCKETS; ++i)
+    {
+        int parent = i + (i & -i);
+        if (parent <= BUCKETS)
+            b.tree[parent] += b.tree[i];
+    }
+
+    b.best.clear();
+    in >> count;
+    for (int i = 0; i < count && i < TOP_K && in.status() == QDataStream::Ok; ++i)
+    {
+        LeaderboardEntry e;
+        qint32 score, length;
+        in >> score >> length >> e.timestamp;
+        e.score = score;
+        e.length = length;
+        b.best.append(e);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    b.games = games;
+    b.indexedOffset = offset;
+    return true;
+}
+
+bool Leaderboard::saveIndex(int level)
+{
+    Board &b = boards[level - 1];
+    qint64 offset = b.log.pos();
+    quint32 lastCrc = 0;
+    if (offset > 0)
+    {
+        b.log.seek(offset - RECORD_SIZE);
+        QByteArray last = b.log.read(RECORD_SIZE);
+        b.log.seek(offset);
+        if (last.size() != RECORD_SIZE)
+            return false;
+        lastCrc = qFromLittleEndian<quint32>(last.constData() + 20);
+    }
+
+    // Fenwick -> comptes par seau (différences des préfixes)
+    QVector<QPair<qint32, quint64>> counts;
+    quint64 previous = 0;
+    for (int bucket = 0; bucket < BUCKETS; ++bucket)
+    {
+        quint64 upTo = prefix(b, bucket + 1);
+        if (upTo != previous)
+            counts.append(qMakePair(static_cast<qint32>(bucket), upTo - previous));
+        previous = upTo;
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << INDEX_MAGIC << INDEX_VERSION << qint32(level) << offset << lastCrc << b.games;
+    out << qint32(counts.size());
+    for (const auto &c : counts)
+        out << c.first << c.second;
+    out << qint32(b.best.size());
+    for (const LeaderboardEntry &e : b.best)
+        out << qint32(e.score) << qint32(e.length) << e.timestamp;
+
+    char crc[4];
+    qToLittleEndian(crc32(data.constData(), static_cast<int>(data.size())), crc);
+    data.append(crc, 4);
+
+    QSaveFile file(indexPath(level));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    {
+        error = file.errorString();
+        return false;
+    }
+    b.indexedOffset = offset;
+    b.unindexed = 0;
+    return true;
+}
+
+void Leaderboard::add(Board &b, const LeaderboardEntry &e)
+{
+    for (int i = bucketOf(e.score) + 1; i <= BUCKETS; i += i & -i)
+        ++b.tree[i];
+    ++b.games;
+
+    int pos = static_cast<int>(std::upper_bound(b.best.begin(), b.best.end(), e, ranksBefore) - b.best.begin());
+    if (pos < TOP_K)
+    {
+        b.best.insert(pos, e);
+        if (b.best.size() > TOP_K)
+            b.best.removeLast();
+    }
+}
+
+quint64 Leaderboard::prefix(const Board &b, int bucket) const
+{
+    quint64 sum = 0;
+    for (int i = qMin(bucket, BUCKETS); i > 0; i -= i & -i)
+        sum += b.tree[i];
+    return sum;
+}
+
+bool Leaderboard::record(int level, int score, int length)
+{
+    Board *b = board(level);
+    if (!opened || !b)
+        return false;
+
+    LeaderboardEntry e;
+    e.score = qMax(0, score);
+    e.length = qMax(0, length);
+    e.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    char rec[RECORD_SIZE];
+    qToLittleEndian(RECORD_MAGIC, rec);
+    qToLittleEndian(static_cast<quint32>(e.score), rec + 4);
+    qToLittleEndian(static_cast<quint32>(e.length), rec + 8);
+    qToLittleEndian(e.timestamp, rec + 12);
+    qToLittleEndian(crc32(rec, 20), rec + 20);
+
+    if (b->log.write(rec, RECORD_SIZE) != RECORD_SIZE || !b->log.flush())
+    {
+        error = b->log.errorString();
+        return false;
+    }
+    add(*b, e);
+    if (++b->unindexed >= INDEX_EVERY)
+        saveIndex(level);
+    return true;
+}
+
+void Leaderboard::flush()
+{
+    if (!opened)
+        return;
+    for (int level = 1; level <= LEVELS; ++level)
+    {
+        if (boards[level - 1].unindexed > 0)
+            saveIndex(level);
+    }
+}
+
+quint64 Leaderboard::gameCount(int level) const
+{
+    const Board *b = board(level);
+    return b ? b->games : 0;
+}
+
+int Leaderboard::best(int level) const
+{
+    const Board *b = board(level);
+    return (b && !b->best.isEmpty()) ? b->best.first().score : 0;
+}
+
+QVector<LeaderboardEntry> Leaderboard::top(int level, int k) const
+{
+    const Board *b = board(level);
+    if (!b)
+        return QVector<LeaderboardEntry>();
+    return b->best.mid(0, qBound(0, k, TOP_K));
+}
+
+double Leaderboard::percentile(int level, int score) const
+{
+    const Board *b = board(level);
+    if (!b || b->games == 0)
+        return 0.0;
+    return 100.0 * prefix(*b, bucketOf(score)) / b->games;
+}
+
+int Leaderboard::scoreAtPercentile(int level, double p) const
+{
+    const Board *b = board(level);
+    if (!b || b->games == 0)
+        return 0;
+
+    // Descente dans l'arbre : plus grand seau dont le préfixe < cible
+    quint64 target = qMax<quint64>(1, static_cast<quint64>(qBound(0.0, p, 100.0) / 100.0 * b->games + 0.5));
+    int pos = 0;
+    quint64 sum = 0;
+    for (int step = BUCKETS; step > 0; step >>= 1)
+    {
+        int next = pos + step;
+        if (next <= BUCKETS && sum + b->tree[next] < target)
+        {
+            pos = next;
+            sum += b->tree[next];
+        }
+    }
+    return qMin(pos, BUCKETS - 1) * BUCKET_STEP;
+}
@@ -0,0 +1,81 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+struct LeaderboardEntry
+{
+    int score;
+    int length;
+    qint64 timestamp;  // ms depuis l'époque
+};
+
+// Classement persistant, un par niveau (1 à 3).
+//
+// Chaque partie est ajoutée à levelN.log : enregistrements de taille fixe
+// protégés par un CRC, jamais réécrits. Un enregistrement tronqué par un
+// arrêt brutal est détecté puis coupé à l'ouverture.
+//
+// levelN.idx résume le journal jusqu'à un décalage donné : histogramme des
+// scores (arbre de Fenwick, pas de 5 points) et les TOP_K meilleures
+// parties. Il est réécrit atomiquement (QSaveFile) ; à l'ouverture on le
+// charge puis on ne relit que la fin du journal qu'il ne couvre pas.
+class Leaderboard
+{
+public:
+    static constexpr int LEVELS = 3;
+    static constexpr int TOP_K = 100;
+
+    // Dossier vide : AppDataLocation/leaderboard
+    explicit Leaderboard(const QString &directory = QString());
+    ~Leaderboard();
+
+    bool open();
+    bool isOpen() const { return opened; }
+    void flush();  // réécrit les index en retard
+
+    bool record(int level, int score, int length);
+
+    quint64 gameCount(int level) const;
+    int best(int level) const;
+    QVector<LeaderboardEntry> top(int level, int k = TOP_K) const;
+    // Part (0-100) des parties de ce niveau ayant un score strictement inférieur
+    double percentile(int level, int score) const;
+    // Plus petit score atteint ou dépassé par p % des parties les moins bonnes
+    int scoreAtPercentile(int level, double p) const;
+
+    QString directory() const { return dir; }
+    QString errorString() const { return error; }
+
+private:
+    struct Board
+    {
+        QFile log;
+        QVector<quint64> tree;         // Fenwick, indices 1..BUCKETS
+        QVector<LeaderboardEntry> best;  // triés, au plus TOP_K
+        quint64 games = 0;
+        qint64 indexedOffset = 0;      // fin du journal couverte par l'index
+        int unindexed = 0;             // enregistrements depuis la dernière écriture
+    };
+
+    QString dir;
+    QString error;
+    bool opened;
+    Board boards[LEVELS];
+
+    Board *board(int level);
+    const Board *board(int level) const;
+    QString logPath(int level) const;
+    QString indexPath(int level) const;
+
+    bool openLevel(int level);
+    bool loadIndex(int level, qint64 logSize);
+    bool saveIndex(int level);
+    void replay(Board &b, const QByteArray &records);
+    void add(Board &b, const LeaderboardEntry &e);
+    quint64 prefix(const Board &b, int bucket) const;  // parties des seaux < bucket
+};
+
+#endif // LEADERBOARD_H
@@ -0,0 +1,307 @@
+#include "levelgen.h"
+
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <algorithm>
+#include <utility>
+
+LevelGenerator::LevelGenerator(QRandomGenerator &rng)
+    : rng(rng),
+    sealed(0)
+{
+}
+
+int LevelGenerator::generate(WallGrid &walls, LayoutStyle style, const LevelParams &params,
+                             const QVector<int> &reserved)
+{
+    int w = walls.width();
+    int h = walls.height();
+
+    // Si la tête se retrouve dans une poche minoritaire, on recommence :
+    // rare (amas refermés sur le départ), et plus sûr qu'un raccord forcé
+    for (int attempt = 0; attempt < 4; ++attempt)
+    {
+        walls.reset(w, h);
+        switch (style)
+        {
+        case LAYOUT_CLUSTERS: clusters(walls, params.clusterPercent); break;
+        case LAYOUT_ROOMS: rooms(walls, params.roomPitch, params.doorWidth); break;
+        case LAYOUT_MAZE: maze(walls, params.mazePitch); break;
+        default: scatter(walls, params.wallsPerThousand); break;
+        }
+        for (int cell : reserved)
+            walls.setWall(cell % w, cell / w, false);
+        if (reserved.isEmpty())
+            return sealUnreachable(walls, -1);
+
+        int reached = sealUnreachable(walls, reserved.first());
+        if (reached >= sealed)
+            return reached;
+    }
+
+    // Repli : plateau vide
+    walls.reset(w, h);
+    sealed = 0;
+    return w * h;
+}
+
+// Premier indice >= x dont le bit vaut `wall` (w si aucun), 64 cases à la fois
+static int nextCell(const uchar *row, int x, int w, bool wall)
+{
+    while (x < w)
+    {
+        quint64 word = qFromLittleEndian<quint64>(row + (x >> 6) * 8);
+        if (!wall)
+            word = ~word;
+        word &= ~quint64(0) << (x & 63);
+        if (word)
+            return qMin(w, (x & ~63) + int(qCountTrailingZeroBits(word)));
+        x = (x & ~63) + 64;
+    }
+    return w;
+}
+
+int LevelGenerator::sealUnreachable(WallGrid &walls, int startCell)
+{
+    int w = walls.width();
+    int h = walls.height();
+    sealed = 0;
+
+    // Étiquetage par segments : chaque suite horizontale de cases libres est
+    // un nœud d'union-find, uni aux segments qui le touchent dans la rangée
+    // précédente (et de l'autre côté des bords, le plateau est torique).
+    // Bien moins de nœuds que de cases, et les lignes sont lues par mots.
+    runStart.clear();
+    runEnd.clear();
+    rowRuns.resize(h + 1);
+    for (int y = 0; y < h; ++y)
+    {
+        rowRuns[y] = static_cast<int>(runStart.size());
+        const uchar *row = walls.row(y);
+        int x = nextCell(row, 0, w, false);
+        while (x < w)
+        {
+            int end = nextCell(row, x, w, true);
+            runStart.append(x);
+            runEnd.append(end - 1);
+            x = nextCell(row, end, w, false);
+        }
+    }
+    rowRuns[h] = static_cast<int>(runStart.size());
+
+    int runs = rowRuns[h];
+    if (runs == 0)
+        return 0;
+    parent.resize(runs);
+    for (int i = 0; i < runs; ++i)
+        parent[i] = i;
+
+    for (int y = 0; y < h; ++y)
+    {
+        int first = rowRuns[y], last = rowRuns[y + 1] - 1;
+        if (last > first && runStart[first] == 0 && runEnd[last] == w - 1)
+            unite(first, last);
+
+        // Fusion des segments qui se chevauchent avec la rangée du dessus
+        if (y == 0 && h < 2)
+            continue;
+        int py = (y == 0) ? h - 1 : y - 1;
+        int i = rowRuns[py], iEnd = rowRuns[py + 1];
+        int j = first, jEnd = last + 1;
+        while (i < iEnd && j < jEnd)
+        {
+            if (runStart[i] <= runEnd[j] && runStart[j] <= runEnd[i])
+                unite(i, j);
+            if (runEnd[i] < runEnd[j])
+                ++i;
+            else
+                ++j;
+        }
+    }
+
+    int startRun = 0;
+    if (startCell >= 0)
+    {
+        int sx = startCell % w, sy = startCell / w;
+        startRun = -1;
+        for (int r = rowRuns[sy]; r < rowRuns[sy + 1] && startRun < 0; ++r)
+            if (runStart[r] <= sx && sx <= runEnd[r])
+                startRun = r;
+        if (startRun < 0)
+            return 0;  // départ sur un mur
+    }
+
+    // Ce qui est libre et hors de la composante du départ devient mur
+    int root = findRoot(startRun);
+    int reached = 0;
+    for (int y = 0; y < h; ++y)
+    {
+        for (int r = rowRuns[y]; r < rowRuns[y + 1]; ++r)
+        {
+            int len = runEnd[r] - runStart[r] + 1;
+            if (findRoot(r) == root)
+            {
+                reached += len;
+                continue;
+            }
+            uchar *row = walls.mutableRow(y);
+            for (int x = runStart[r]; x <= runEnd[r]; ++x)
+                row[x >> 3] |= uchar(1 << (x & 7));
+            sealed += len;
+        }
+    }
+    return reached;
+}
+
+// Murs isolés : `perThousand` pour 1000 cases (5 / 8 / 12 à l'origine)
+void LevelGenerator::scatter(WallGrid &walls, int perThousand)
+{
+    int w = walls.width();
+    int h = walls.height();
+    qint64 count = qint64(perThousand) * w * h / 1000;
+    for (qint64 i = 0; i < count; ++i)
+        walls.setWall(rng.bounded(2, w - 2), rng.bounded(2, h - 2));
+}
+
+// Amas : marches aléatoires jusqu'à `percent` % de murs (4 / 6 / 8 à
+// l'origine), plus longues quand la densité monte
+void LevelGenerator::clusters(WallGrid &walls, int percent)
+{
+    int w = walls.width();
+    int h = walls.height();
+    qint64 target = qint64(w) * h * percent / 100;
+    qint64 placed = 0;
+    while (placed < target)
+    {
+        int x = rng.bounded(w);
+        int y = rng.bounded(h);
+        int steps = rng.bounded(4, 4 + 2 * percent);
+        for (int s = 0; s < steps; ++s, ++placed)
+        {
+            walls.setWall(x, y);
+            switch (rng.bounded(4))
+            {
+            case 0: x = (x + 1) % w; break;
+            case 1: x = (x + w - 1) % w; break;
+            case 2: y = (y + 1) % h; break;
+            default: y = (y + h - 1) % h; break;
+            }
+        }
+    }
+}
+
+void LevelGenerator::rooms(WallGrid &walls, int pitch, int doorWidth)
+{
+    // Salles de pitch - 1 cases (11 / 9 / 7 à l'origine), portes de 3 / 2 / 1
+    // cases, un quart de portes en plus de l'arbre pour éviter les culs-de-sac
+    partition(walls, pitch, doorWidth, 4);
+}
+
+void LevelGenerator::maze(WallGrid &walls, int pitch)
+{
+    // Couloirs de pitch - 1 cases (3 / 2 / 1 à l'origine) ; une ouverture
+    // sur seize en plus de l'arbre couvrant crée quelques boucles
+    partition(walls, pitch, pitch, 16);
+}
+
+// Quadrillage de murs tous les `pitch` cases, puis Kruskal sur les cellules
+// (union-find) : chaque arête retenue ouvre une porte, donc toutes les
+// cellules sont reliées. Une arête refusée est ouverte avec une chance sur
+// extraChance.
+void LevelGenerator::partition(WallGrid &walls, int pitch, int doorWidth, int extraChance)
+{
+    int w = walls.width();
+    int h = walls.height();
+    // Une ligne pleine et un motif de colonnes, recopiés octet par octet
+    int stride = walls.rowBytes();
+    QVector<uchar> full(stride, 0), columns(stride, 0);
+    for (int x = 0; x < w; ++x)
+    {
+        full[x >> 3] |= uchar(1 << (x & 7));
+        if (x % pitch == 0)
+            columns[x >> 3] |= uchar(1 << (x & 7));
+    }
+    for (int y = 0; y < h; ++y)
+    {
+        const QVector<uchar> &src = (y % pitch == 0) ? full : columns;
+        std::copy(src.constBegin(), src.constEnd(), walls.mutableRow(y));
+    }
+
+    // Cellule (cx, cy) : intérieur [c * pitch + 1, min(c * pitch + pitch - 1, bord)]
+    int cols = (w - 2) / pitch + 1;
+    int rows = (h - 2) / pitch + 1;
+    parent.resize(cols * rows);
+    for (int i = 0; i < parent.size(); ++i)
+        parent[i] = i;
+
+    // Arêtes : 2 * cellule (+1 pour la voisine du dessous)
+    QVector<int> edges;
+    edges.reserve(cols * rows * 2);
+    for (int cy = 0; cy < rows; ++cy)
+    {
+        for (int cx = 0; cx < cols; ++cx)
+        {
+            int c = cy * cols + cx;
+            if (cx + 1 < cols)
+                edges.append(c * 2);
+            if (cy + 1 < rows)
+                edges.append(c * 2 + 1);
+        }
+    }
+    // Un tirage par arête : xorshift local, amorcé par le générateur de la
+    // partie (reproductible, et bien moins coûteux que Mersenne Twister)
+    quint64 seed = rng.generate64() | 1;
+    auto draw = [&seed](int bound) {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        return int(((seed * 0x2545F4914F6CDD1DULL) >> 32) * quint64(bound) >> 32);
+    };
+    for (int i = static_cast<int>(edges.size()) - 1; i > 0; --i)
+        std::swap(edges[i], edges[draw(i + 1)]);
+
+    for (int e : edges)
+    {
+        int c = e / 2;
+        bool down = e & 1;
+        int cx = c % cols, cy = c / cols;
+        int other = down ? c + cols : c + 1;
+        if (!unite(c, other) && draw(extraChance) != 0)
+            continue;
+
+        // La porte est percée dans la ligne de murs commune
+        int lo = (down ? cx : cy) * pitch + 1;
+        int hi = qMin(lo + pitch - 2, (down ? w : h) - 1);
+        int span = hi - lo + 1;
+        int dw = qMin(doorWidth, span);
+        int start = lo + draw(span - dw + 1);
+        int line = ((down ? cy : cx) + 1) * pitch;
+        for (int i = start; i < start + dw; ++i)
+        {
+            if (down)
+                walls.setWall(i, line, false);
+            else
+                walls.setWall(line, i, false);
+        }
+    }
+}
+
+int LevelGenerator::findRoot(int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+bool LevelGenerator::unite(int a, int b)
+{
+    a = findRoot(a);
+    b = findRoot(b);
+    if (a == b)
+        return false;
+    parent[a] = b;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef LEVELGEN_H
+#define LEVELGEN_H
+
+#include <QRandomGenerator>
+#include <QVector>
+#include "leveltable.h"
+#include "wallgrid.h"
+
+enum LayoutStyle
+{
+    LAYOUT_SCATTER,   // murs isolés (disposition d'origine)
+    LAYOUT_CLUSTERS,  // amas de murs
+    LAYOUT_ROOMS,     // salles reliées par des portes
+    LAYOUT_MAZE,      // labyrinthe à couloirs
+    LAYOUT_COUNT
+};
+
+// Génération procédurale des murs. Chaque disposition est suivie d'un
+// unique étiquetage des composantes libres (plateau torique) : toute case
+// libre non reliée à la tête est murée, si bien que chaque case libre restante,
+// donc chaque fruit, est accessible. O(cases) au total.
+class LevelGenerator
+{
+public:
+    explicit LevelGenerator(QRandomGenerator &rng);
+
+    // reserved : cases du serpent de départ et devant lui, toujours libres ;
+    // la première est la tête. La densité est celle de `params` (voir
+    // LevelTable). Retourne le nombre de cases libres.
+    int generate(WallGrid &walls, LayoutStyle style, const LevelParams &params,
+                 const QVector<int> &reserved);
+
+    // Mure les cases libres inaccessibles depuis startCell ; retourne le
+    // nombre de cases libres atteintes
+    int sealUnreachable(WallGrid &walls, int startCell);
+
+    int lastSealed() const { return sealed; }
+
+private:
+    QRandomGenerator &rng;
+    QVector<int> parent;    // union-find (cellules, puis segments libres)
+    QVector<int> runStart;  // segments libres, rangée par rangée
+    QVector<int> runEnd;
+    QVector<int> rowRuns;   // premier segment de chaque rangée
+    int sealed;
+
+    void scatter(WallGrid &walls, int perThousand);
+    void clusters(WallGrid &walls, int percent);
+    void rooms(WallGrid &walls, int pitch, int doorWidth);
+    void maze(WallGrid &walls, int pitch);
+    void partition(WallGrid &walls, int pitch, int doorWidth, int extraChance);
+    int findRoot(int i);
+    bool unite(int a, int b);
+};
+
+#endif // LEVELGEN_H
@@ -0,0 +1,128 @@
+#include "leveltable.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QStringList>
+
+// Valeurs choisies à la main à l'origine : 200 / 140 / 90 ms, puis les
+// densités de LevelGenerator
+static const LevelParams STANDARD_LEVELS[LevelTable::LEVEL_COUNT] = {
+    {200, 5, 4, 12, 3, 4},
+    {140, 8, 6, 10, 2, 3},
+    {90, 12, 8, 8, 1, 2},
+};
+
+bool LevelParams::isValid() const
+{
+    return tickMs >= 20 && tickMs <= 2000
+        && wallsPerThousand >= 0 && wallsPerThousand <= 300
+        && clusterPercent >= 0 && clusterPercent <= 40
+        && roomPitch >= 4 && roomPitch <= 64
+        && doorWidth >= 1 && doorWidth <= roomPitch - 2
+        && mazePitch >= 2 && mazePitch <= 16;
+}
+
+LevelTable::LevelTable()
+{
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+        levels[i] = STANDARD_LEVELS[i];
+}
+
+const LevelParams &LevelTable::level(int level) const
+{
+    if (level < 1 || level > LEVEL_COUNT)
+        level = 2;
+    return levels[level - 1];
+}
+
+void LevelTable::setLevel(int level, const LevelParams &params)
+{
+    if (level >= 1 && level <= LEVEL_COUNT && params.isValid())
+        levels[level - 1] = params;
+}
+
+// Les niveaux absents du texte gardent leurs réglages
+bool LevelTable::parse(const QString &text, QString *error)
+{
+    LevelParams parsed[LEVEL_COUNT];
+    bool seen[LEVEL_COUNT] = {};
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+        parsed[i] = levels[i];
+
+    const QStringList lines = text.split('\n');
+    for (int lineNo = 0; lineNo < lines.size(); ++lineNo)
+    {
+        QString line = lines[lineNo].trimmed();
+        if (line.isEmpty() || line.startsWith(";"))
+            continue;
+        QStringList f = line.split(' ', Qt::SkipEmptyParts);
+        int v[7] = {};
+        bool ok = f.size() == 7;
+        for (int i = 0; ok && i < 7; ++i)
+            v[i] = f[i].toInt(&ok);
+        // Paramètres construits seulement sur une ligne entièrement lue
+        LevelParams p = {};
+        if (ok)
+        {
+            p = {v[1], v[2], v[3], v[4], v[5], v[6]};
+            ok = v[0] >= 1 && v[0] <= LEVEL_COUNT && p.isValid() && !seen[v[0] - 1];
+        }
+        if (!ok)
+        {
+            if (error)
+                *error = QString("ligne %1 : niveau pas_ms murs_1000 amas_% salle porte "
+                                 "couloir attendus, dans les bornes").arg(lineNo + 1);
+            return false;
+        }
+        seen[v[0] - 1] = true;
+        parsed[v[0] - 1] = p;
+    }
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+        levels[i] = parsed[i];
+    return true;
+}
+
+QString LevelTable::toText() const
+{
+    QString text = "; niveau pas_ms murs_1000 amas_% salle porte couloir\n";
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+    {
+        const LevelParams &p = levels[i];
+        text += QString("%1 %2 %3 %4 %5 %6 %7\n")
+                    .arg(i + 1).arg(p.tickMs).arg(p.wallsPerThousand).arg(p.clusterPercent)
+                    .arg(p.roomPitch).arg(p.doorWidth).arg(p.mazePitch);
+    }
+    return text;
+}
+
+bool LevelTable::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return parse(QString::fromUtf8(file.readAll()), error);
+}
+
+bool LevelTable::save(const QString &path, const QString &comment, QString *error) const
+{
+    QString text;
+    if (!comment.isEmpty())
+    {
+        for (const QString &line : comment.split('\n'))
+            text += "; " + line + "\n";
+    }
+    QByteArray data = (text + toText()).toUtf8();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || file.write(data) != data.size()
+        || !file.commit())
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
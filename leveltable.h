@@ -0,0 +1,57 @@
+#ifndef LEVELTABLE_H
+#define LEVELTABLE_H
+
+#include <QString>
+
+// Réglages d'un niveau : durée d'un pas et densité des murs de chaque
+// disposition (l'arène suit celle des murs isolés)
+struct LevelParams
+{
+    int tickMs;            // durée d'un pas
+    int wallsPerThousand;  // murs isolés pour 1000 cases
+    int clusterPercent;    // amas : part de murs
+    int roomPitch;         // salles : pas du quadrillage
+    int doorWidth;         // salles : largeur des portes
+    int mazePitch;         // labyrinthe : couloirs de mazePitch - 1 cases
+
+    bool operator==(const LevelParams &o) const
+    {
+        return tickMs == o.tickMs && wallsPerThousand == o.wallsPerThousand
+            && clusterPercent == o.clusterPercent && roomPitch == o.roomPitch
+            && doorWidth == o.doorWidth && mazePitch == o.mazePitch;
+    }
+    bool operator!=(const LevelParams &o) const { return !(*this == o); }
+
+    // Faux si une valeur sort des bornes que la génération accepte
+    bool isValid() const;
+};
+
+// Réglages des niveaux 1 à 3 : ceux d'origine par défaut, ou une table
+// produite par snake_calibrate. Fichier texte, une ligne par niveau :
+//
+//   ; commentaire
+//   niveau pas_ms murs_1000 amas_% salle porte couloir
+//   1 200 5 4 12 3 4
+class LevelTable
+{
+public:
+    static constexpr int LEVEL_COUNT = 3;
+
+    LevelTable();
+
+    // Niveau hors bornes : le niveau 2
+    const LevelParams &level(int level) const;
+    void setLevel(int level, const LevelParams &params);
+
+    bool load(const QString &path, QString *error = nullptr);
+    // comment : lignes ajoutées en tête du fichier, en commentaire
+    bool save(const QString &path, const QString &comment = QString(),
+              QString *error = nullptr) const;
+    bool parse(const QString &text, QString *error = nullptr);
+    QString toText() const;
+
+private:
+    LevelParams levels[LEVEL_COUNT];
+};
+
+#endif // LEVELTABLE_H
@@ -1,65 +1,151 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFileInfo>
 #include <QStackedWidget>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QPalette>
 #include "menuwidget.h"
 #include "snakewidget.h"
+#include "startupprofile.h"
 
 int main(int argc, char *argv[])
 {
+    StartupProfile::begin();
     QApplication a(argc, argv);
     a.setStyle("Fusion");
+    StartupProfile::mark("application creee");
+
+    // Carte dessinée optionnelle pour le mode solo : Snake --map fichier.snkm
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption mapOpt("map", "Carte .snkm (voir snake_mapconv).", "fichier");
+    QCommandLineOption profileOpt("profile-startup",
+                                  "Affiche les etapes du demarrage (ms depuis le lancement).");
+    QCommandLineOption exitOpt("startup-exit",
+                               "Quitte apres la preparation de l'ecran de jeu (mesures repetees).");
+    QCommandLineOption spectateOpt("spectate",
+                                   "Arene de bots seulement, a regarder (T : turbo).", "bots");
+    QCommandLineOption levelsOpt("levels", "Table de niveaux (voir snake_calibrate).", "fichier");
+    parser.addOptions({mapOpt, profileOpt, exitOpt, spectateOpt, levelsOpt});
+    parser.process(a);
+    if (parser.isSet(profileOpt) || parser.isSet(exitOpt))
+        StartupProfile::enable();
 
     QStackedWidget *mainStack = new QStackedWidget();
     mainStack->setWindowTitle("Snake - GI3");
     mainStack->resize(800, 600);
 
     MenuWidget *menu = new MenuWidget();
-    SnakeWidget *game = new SnakeWidget();
+    mainStack->addWidget(menu);
+    StartupProfile::mark("menu construit");
 
-    QWidget *gameContainer = new QWidget();
-    gameContainer->setStyleSheet("background-color: rgb(15, 15, 30);");
-    QVBoxLayout *vLayout = new QVBoxLayout(gameContainer);
-    QHBoxLayout *hLayout = new QHBoxLayout();
+    // Écran de jeu construit au repos, après la première image du menu, ou
+    // tout de suite si une partie est lancée avant
+    SnakeWidget *game = nullptr;
+    QWidget *gameContainer = nullptr;
+    auto ensureGameScreen = [&]() {
+        if (game)
+            return;
+        game = new SnakeWidget();
+        if (parser.isSet(mapOpt))
+        {
+            QString error;
+            if (!game->loadMap(parser.value(mapOpt), &error))
+                qWarning() << "Carte ignoree :" << error;
+        }
+        if (parser.isSet(levelsOpt))
+        {
+            LevelTable levels;
+            QString error;
+            if (levels.load(parser.value(levelsOpt), &error))
+                game->setLevelTable(levels);
+            else
+                qWarning() << "Table de niveaux ignoree :" << error;
+        }
 
-    hLayout->addStretch();
-    hLayout->addWidget(game);
-    hLayout->addStretch();
+        // Fond uni par la palette : une feuille de style imposerait le
+        // style à feuilles de style à tout l'écran de jeu
+        gameContainer = new QWidget();
+        QPalette background = gameContainer->palette();
+        background.setColor(QPalette::Window, QColor(15, 15, 30));
+        gameContainer->setPalette(background);
+        gameContainer->setAutoFillBackground(true);
+        QVBoxLayout *vLayout = new QVBoxLayout(gameContainer);
+        QHBoxLayout *hLayout = new QHBoxLayout();
 
-    vLayout->addStretch();
-    vLayout->addLayout(hLayout);
-    vLayout->addStretch();
-    vLayout->setContentsMargins(0, 0, 0, 0);
-    vLayout->setSpacing(0);
+        hLayout->addStretch();
+        hLayout->addWidget(game);
+        hLayout->addStretch();
 
-    mainStack->addWidget(menu);
-    mainStack->addWidget(gameContainer);
+        vLayout->addStretch();
+        vLayout->addLayout(hLayout);
+        vLayout->addStretch();
+        vLayout->setContentsMargins(0, 0, 0, 0);
+        vLayout->setSpacing(0);
+
+        mainStack->addWidget(gameContainer);
+
+        QObject::connect(game, &SnakeWidget::backToMenu, mainStack,
+                         [menu, mainStack]() {
+                             mainStack->setCurrentWidget(menu);
+                             menu->setFocus();
+                         });
+
+        QObject::connect(game, &SnakeWidget::requestFullscreen, mainStack,
+                         [mainStack](bool fullscreen) {
+                             if (fullscreen) {
+                                 mainStack->showFullScreen();
+                             } else {
+                                 mainStack->showNormal();
+                             }
+                         });
+
+        QObject::connect(game, &SnakeWidget::firstFramePainted, mainStack, []() {
+            StartupProfile::mark("premiere image de jeu");
+        });
+        StartupProfile::mark("ecran de jeu construit");
+    };
+
+    QObject::connect(menu, &MenuWidget::firstFramePainted, mainStack, [&]() {
+        StartupProfile::mark("premiere image du menu");
+        QTimer::singleShot(0, mainStack, [&]() {
+            ensureGameScreen();
+            QTimer::singleShot(0, mainStack, [&]() {
+                game->warmUp();
+                StartupProfile::mark("ecran de jeu prechauffe");
+                if (parser.isSet(exitOpt))
+                    a.quit();
+            });
+        });
+    });
 
     // MODIFIÉ : passe le niveau au jeu
     QObject::connect(menu, &MenuWidget::startGame, mainStack,
-                     [game, gameContainer, mainStack](int level) {
+                     [&](int level, int layout, int foods, int hazards) {
+                         ensureGameScreen();
                          game->setLevel(level);  // NOUVEAU : définir le niveau
+                         game->setLayoutStyle(static_cast<LayoutStyle>(layout));
+                         game->setFoodCount(foods);
+                         game->setHazardCount(hazards);
                          game->startGameDirectly();
                          mainStack->setCurrentWidget(gameContainer);
                          game->setFocus();
                      });
 
-    QObject::connect(menu, &MenuWidget::quitGame, mainStack, &QWidget::close);
-
-    QObject::connect(game, &SnakeWidget::backToMenu, mainStack,
-                     [menu, mainStack]() {
-                         mainStack->setCurrentWidget(menu);
-                         menu->setFocus();
+    // Arène : deux joueurs locaux et six bots
+    QObject::connect(menu, &MenuWidget::startArena, mainStack,
+                     [&](int level) {
+                         ensureGameScreen();
+                         game->setLevel(level);
+                         game->startArena(2, 6);
+                         mainStack->setCurrentWidget(gameContainer);
+                         game->setFocus();
                      });
 
-    QObject::connect(game, &SnakeWidget::requestFullscreen, mainStack,
-                     [mainStack](bool fullscreen) {
-                         if (fullscreen) {
-                             mainStack->showFullScreen();
-                         } else {
-                             mainStack->showNormal();
-                         }
-                     });
+    QObject::connect(menu, &MenuWidget::quitGame, mainStack, &QWidget::close);
 
     QObject::connect(menu, &MenuWidget::requestFullscreen, mainStack,
                      [mainStack](bool fullscreen) {
@@ -70,6 +156,32 @@ int main(int argc, char *argv[])
                          }
                      });
 
+    // Spectateur : arène de bots ouverte tout de suite, sans le menu
+    if (parser.isSet(spectateOpt))
+    {
+        ensureGameScreen();
+        game->startArena(0, qBound(2, parser.value(spectateOpt).toInt(), 16));
+        mainStack->setCurrentWidget(gameContainer);
+        game->setFocus();
+    }
+    // Partie interrompue à la dernière fermeture : reprise tout de suite, en pause
+    else if (QFileInfo::exists(SnakeWidget::autosavePath()))
+    {
+        ensureGameScreen();
+        if (game->resumeSavedGame())
+        {
+            mainStack->setCurrentWidget(gameContainer);
+            game->setFocus();
+        }
+    }
+
+    // Fermeture de la fenêtre : la partie en cours est écrite avant la sortie
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, [&]() {
+        if (game)
+            game->shutdown();
+    });
+
     mainStack->show();
+    StartupProfile::mark("fenetre affichee");
     return a.exec();
 }
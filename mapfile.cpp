@@ -0,0 +1,126 @@
+#include "mapfile.h"
+
+#include <QSaveFile>
+
+MapFile::MapFile()
+    : data(nullptr),
+    header(nullptr),
+    zones(nullptr)
+{
+}
+
+MapFile::~MapFile()
+{
+    close();
+}
+
+void MapFile::close()
+{
+    if (data)
+        file.unmap(data);
+    file.close();
+    data = nullptr;
+    header = nullptr;
+    zones = nullptr;
+}
+
+bool MapFile::fail(const QString &message)
+{
+    close();
+    error = message;
+    return false;
+}
+
+bool MapFile::open(const QString &path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+
+    qint64 size = file.size();
+    if (size < static_cast<qint64>(sizeof(MapHeader)))
+        return fail("Fichier de carte trop court");
+    data = file.map(0, size);
+    if (!data)
+        return fail("Projection en memoire impossible : " + file.errorString());
+
+    // Vérifications en O(1) (+ une par zone) : aucune lecture de la bitmap
+    const MapHeader *h = reinterpret_cast<const MapHeader *>(data);
+    if (h->magic != MAP_MAGIC)
+        return fail("Ce n'est pas une carte Snake");
+    if (h->version != MAP_VERSION || h->headerSize != sizeof(MapHeader))
+        return fail(QString("Version de carte non prise en charge : %1").arg(h->version));
+    if (h->width < 8 || h->height < 8 || h->width > MAP_MAX_SIZE || h->height > MAP_MAX_SIZE)
+        return fail("Dimensions de carte invalides");
+    if (h->rowBytes < static_cast<uint32_t>(WallGrid::rowBytesFor(h->width)) || h->rowBytes % 8 != 0)
+        return fail("Largeur de ligne invalide");
+    // Tailles comparées à ce qui reste après chaque décalage : une somme
+    // décalage + taille pourrait déborder. Les produits tiennent en 64 bits.
+    if (h->fileSize != static_cast<uint64_t>(size) || h->bitmapOffset % 64 != 0 ||
+        h->zonesOffset % alignof(MapZone) != 0 ||
+        h->bitmapOffset > h->fileSize || h->zonesOffset > h->fileSize ||
+        uint64_t(h->rowBytes) * h->height > h->fileSize - h->bitmapOffset ||
+        uint64_t(h->zoneCount) * sizeof(MapZone) > h->fileSize - h->zonesOffset)
+        return fail("Carte tronquee ou incoherente");
+    if (h->spawnX >= h->width || h->spawnY >= h->height ||
+        h->spawnDirection < UP || h->spawnDirection > RIGHT)
+        return fail("Point de depart invalide");
+
+    const MapZone *z = reinterpret_cast<const MapZone *>(data + h->zonesOffset);
+    for (uint32_t i = 0; i < h->zoneCount; ++i)
+    {
+        if (z[i].width == 0 || z[i].height == 0 ||
+            uint64_t(z[i].x) + z[i].width > h->width || uint64_t(z[i].y) + z[i].height > h->height)
+            return fail(QString("Zone de fruits %1 hors de la carte").arg(i));
+    }
+
+    header = h;
+    zones = z;
+    error.clear();
+    return true;
+}
+
+bool MapFile::save(const QString &path, const WallGrid &walls,
+                   int spawnX, int spawnY, Direction spawnDirection,
+                   const QVector<MapZone> &zones, QString *error)
+{
+    MapHeader h = MapHeader();
+    h.magic = MAP_MAGIC;
+    h.version = MAP_VERSION;
+    h.headerSize = sizeof(MapHeader);
+    h.width = static_cast<uint32_t>(walls.width());
+    h.height = static_cast<uint32_t>(walls.height());
+    h.rowBytes = static_cast<uint32_t>(WallGrid::rowBytesFor(walls.width()));
+    h.spawnX = static_cast<uint32_t>(spawnX);
+    h.spawnY = static_cast<uint32_t>(spawnY);
+    h.spawnDirection = static_cast<uint32_t>(spawnDirection);
+    h.zoneCount = static_cast<uint32_t>(zones.size());
+    h.bitmapOffset = 64;
+    h.zonesOffset = h.bitmapOffset + uint64_t(h.rowBytes) * h.height;
+    h.fileSize = h.zonesOffset + uint64_t(h.zoneCount) * sizeof(MapZone);
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly))
+    {
+        if (error)
+            *error = out.errorString();
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    for (int y = 0; y < walls.height(); ++y)
+    {
+        // La grille source peut avoir des lignes plus larges
+        out.write(reinterpret_cast<const char *>(walls.row(y)), h.rowBytes);
+    }
+    if (!zones.isEmpty())
+        out.write(reinterpret_cast<const char *>(zones.constData()), zones.size() * sizeof(MapZone));
+
+    if (!out.commit())
+    {
+        if (error)
+            *error = out.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+// Format binaire des cartes (.snkm), lu par projection mémoire sans
+// aucune analyse : l'en-tête est vérifié, la bitmap est utilisée telle
+// quelle comme grille de collision (voir WallGrid).
+//
+//   MapHeader (64 octets)
+//   bitmap des murs : height lignes de rowBytes octets, à bitmapOffset
+//   zones d'apparition des fruits : zoneCount MapZone, à zonesOffset
+//
+// Entiers petit-boutistes ; bitmapOffset est aligné sur 64 octets.
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+#include "game.h"
+#include "wallgrid.h"
+
+#define MAP_MAGIC 0x4D4B4E53u  // "SNKM"
+#define MAP_VERSION 1
+#define MAP_MAX_SIZE 16384
+
+struct MapHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowBytes;
+    uint32_t spawnX;         // tête du serpent au départ
+    uint32_t spawnY;
+    uint32_t spawnDirection; // Direction
+    uint32_t zoneCount;      // 0 : fruits n'importe où
+    uint32_t reserved;
+    uint64_t bitmapOffset;
+    uint64_t zonesOffset;
+    uint64_t fileSize;
+};
+
+struct MapZone
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+static_assert(sizeof(MapHeader) == 64, "MapHeader : disposition fixe");
+static_assert(sizeof(MapZone) == 16, "MapZone : disposition fixe");
+
+class MapFile
+{
+public:
+    MapFile();
+    ~MapFile();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+    QString errorString() const { return error; }
+
+    int width() const { return static_cast<int>(header->width); }
+    int height() const { return static_cast<int>(header->height); }
+    int rowBytes() const { return static_cast<int>(header->rowBytes); }
+    const uchar *bitmap() const { return data + header->bitmapOffset; }
+    int spawnX() const { return static_cast<int>(header->spawnX); }
+    int spawnY() const { return static_cast<int>(header->spawnY); }
+    Direction spawnDirection() const { return static_cast<Direction>(header->spawnDirection); }
+    int zoneCount() const { return static_cast<int>(header->zoneCount); }
+    const MapZone &zone(int i) const { return zones[i]; }
+
+    static bool save(const QString &path, const WallGrid &walls,
+                     int spawnX, int spawnY, Direction spawnDirection,
+                     const QVector<MapZone> &zones, QString *error = nullptr);
+
+private:
+    QFile file;
+    uchar *data;
+    const MapHeader *header;
+    const MapZone *zones;
+    QString error;
+
+    bool fail(const QString &message);
+};
+
+#endif // MAPFILE_H
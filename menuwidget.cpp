@@ -1,4 +1,5 @@
 #include "menuwidget.h"
+#include "game.h"
 #include <QPainter>
 #include <QVBoxLayout>
 #include <QFont>
@@ -6,7 +7,7 @@
 #include <QKeyEvent>
 
 MenuWidget::MenuWidget(QWidget *parent)
-    : QWidget(parent), currentLevel(1), isFullscreen(false)
+    : QWidget(parent), currentLevel(1), currentLayout(LAYOUT_SCATTER), currentMode(MODE_SOLO), isFullscreen(false), framePainted(false)
 {
     setMinimumSize(800, 600);
     setFocusPolicy(Qt::StrongFocus);
@@ -17,42 +18,61 @@ void MenuWidget::setupUI()
 {
     playButton = new QPushButton("JOUER", this);
     levelButton = new QPushButton("LEVEL : 1", this);
+    modeButton = new QPushButton("MODE : SOLO", this);
+    layoutButton = new QPushButton("TERRAIN : ALEATOIRE", this);
     quitButton = new QPushButton("QUITTER", this);
 
     QString playStyle = getButtonStyle("rgb(0, 220, 120)", "rgb(0, 255, 150)");
     QString levelStyle = getButtonStyle("rgb(0, 160, 200)", "rgb(0, 200, 240)");
+    QString modeStyle = getButtonStyle("rgb(150, 90, 220)", "rgb(180, 120, 250)");
+    QString layoutStyle = getButtonStyle("rgb(200, 140, 40)", "rgb(230, 170, 70)");
     QString quitStyle = getButtonStyle("rgb(220, 60, 60)", "rgb(255, 90, 90)");
 
     playButton->setStyleSheet(playStyle);
     levelButton->setStyleSheet(levelStyle);
+    modeButton->setStyleSheet(modeStyle);
+    layoutButton->setStyleSheet(layoutStyle);
     quitButton->setStyleSheet(quitStyle);
 
     QFont buttonFont("Consolas", 18, QFont::Bold);
     playButton->setFont(buttonFont);
     levelButton->setFont(buttonFont);
+    modeButton->setFont(buttonFont);
+    layoutButton->setFont(buttonFont);
     quitButton->setFont(buttonFont);
 
-    playButton->setFixedSize(300, 70);
-    levelButton->setFixedSize(300, 70);
-    quitButton->setFixedSize(300, 70);
+    playButton->setFixedSize(300, 60);
+    levelButton->setFixedSize(300, 60);
+    modeButton->setFixedSize(300, 60);
+    layoutButton->setFixedSize(300, 60);
+    quitButton->setFixedSize(300, 60);
 
     playButton->setCursor(Qt::PointingHandCursor);
     levelButton->setCursor(Qt::PointingHandCursor);
+    modeButton->setCursor(Qt::PointingHandCursor);
+    layoutButton->setCursor(Qt::PointingHandCursor);
     quitButton->setCursor(Qt::PointingHandCursor);
 
     QVBoxLayout *layout = new QVBoxLayout();
     layout->setAlignment(Qt::AlignCenter);
+    layout->addSpacing(100);  // sous le titre
     layout->addStretch();
     layout->addWidget(playButton, 0, Qt::AlignCenter);
-    layout->addSpacing(20);
+    layout->addSpacing(15);
     layout->addWidget(levelButton, 0, Qt::AlignCenter);
-    layout->addSpacing(20);
+    layout->addSpacing(15);
+    layout->addWidget(modeButton, 0, Qt::AlignCenter);
+    layout->addSpacing(15);
+    layout->addWidget(layoutButton, 0, Qt::AlignCenter);
+    layout->addSpacing(15);
     layout->addWidget(quitButton, 0, Qt::AlignCenter);
     layout->addStretch();
     setLayout(layout);
 
     connect(playButton, &QPushButton::clicked, this, &MenuWidget::onPlayClicked);
     connect(levelButton, &QPushButton::clicked, this, &MenuWidget::onLevelClicked);
+    connect(modeButton, &QPushButton::clicked, this, &MenuWidget::onModeClicked);
+    connect(layoutButton, &QPushButton::clicked, this, &MenuWidget::onLayoutClicked);
     connect(quitButton, &QPushButton::clicked, this, &MenuWidget::onQuitClicked);
 }
 
@@ -102,6 +122,12 @@ void MenuWidget::paintEvent(QPaintEvent *event)
     p.setPen(QColor(150, 150, 150));
     p.setFont(QFont("Consolas", 10));
     p.drawText(rect().adjusted(0, 0, -20, -20), Qt::AlignRight | Qt::AlignBottom, "F11 : Plein ecran");
+
+    if (!framePainted)
+    {
+        framePainted = true;
+        emit firstFramePainted();
+    }
 }
 
 void MenuWidget::resizeEvent(QResizeEvent *event)
@@ -128,7 +154,12 @@ void MenuWidget::toggleFullscreen()
 
 void MenuWidget::onPlayClicked()
 {
-    emit startGame(currentLevel);
+    if (currentMode == MODE_ARENA)
+        emit startArena(currentLevel);
+    else
+        emit startGame(currentLevel, currentLayout,
+                       currentMode == MODE_FRENZY ? Game::FRENZY_FOOD_COUNT : Game::FOOD_COUNT,
+                       currentMode == MODE_DANGER ? Game::DANGER_HAZARD_COUNT : 0);
 }
 
 void MenuWidget::onLevelClicked()
@@ -137,6 +168,20 @@ void MenuWidget::onLevelClicked()
     levelButton->setText(QString("LEVEL : %1").arg(currentLevel));
 }
 
+void MenuWidget::onModeClicked()
+{
+    static const char *names[MODE_COUNT] = { "SOLO", "FRENESIE", "DANGERS", "ARENE" };
+    currentMode = (currentMode + 1) % MODE_COUNT;
+    modeButton->setText(QString("MODE : %1").arg(names[currentMode]));
+}
+
+void MenuWidget::onLayoutClicked()
+{
+    static const char *names[LAYOUT_COUNT] = { "ALEATOIRE", "AMAS", "SALLES", "LABYRINTHE" };
+    currentLayout = (currentLayout + 1) % LAYOUT_COUNT;
+    layoutButton->setText(QString("TERRAIN : %1").arg(names[currentLayout]));
+}
+
 void MenuWidget::onQuitClicked()
 {
     emit quitGame();
@@ -12,16 +12,31 @@ public:
     explicit MenuWidget(QWidget *parent = nullptr);
 
 signals:
-    void startGame(int level);
+    void startGame(int level, int layout, int foods, int hazards);
+    void startArena(int level);
     void quitGame();
     void requestFullscreen(bool fullscreen);
+    void firstFramePainted();   // profil de démarrage
 
 private:
     QPushButton *playButton;
     QPushButton *levelButton;
+    QPushButton *modeButton;
+    QPushButton *layoutButton;
     QPushButton *quitButton;
     int currentLevel;
+    int currentLayout;  // LayoutStyle
+    enum Mode
+    {
+        MODE_SOLO,
+        MODE_FRENZY,  // solo, des centaines de fruits
+        MODE_DANGER,  // solo, dangers mobiles
+        MODE_ARENA,
+        MODE_COUNT
+    };
+    int currentMode;
     bool isFullscreen;
+    bool framePainted;
 
     void setupUI();
     QString getButtonStyle(const QString &color, const QString &hoverColor);
@@ -35,6 +50,8 @@ protected:
 private slots:
     void onPlayClicked();
     void onLevelClicked();
+    void onModeClicked();
+    void onLayoutClicked();
     void onQuitClicked();
 };
 
@@ -0,0 +1,172 @@
+#include "netclient.h"
+
+NetClient::NetClient(QObject *parent)
+    : QObject(parent),
+    ready(false),
+    ownId(-1),
+    tickMs(0),
+    nextSeq(0),
+    predicted(RIGHT),
+    bytesIn(0),
+    bytesOut(0),
+    deltas(0),
+    predictions(0),
+    mispredictions(0),
+    resyncs(0),
+    stats()
+{
+    connect(&socket, &QTcpSocket::connected, this, [this]() {
+        socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    });
+    connect(&socket, &QTcpSocket::readyRead, this, &NetClient::onReadyRead);
+    connect(&socket, &QTcpSocket::disconnected, this, [this]() {
+        ready = false;
+        emit disconnected();
+    });
+}
+
+void NetClient::connectTo(const QString &host, quint16 port)
+{
+    ready = false;
+    reader.clear();
+    pending.clear();
+    socket.connectToHost(host, port);
+}
+
+void NetClient::disconnectFrom()
+{
+    socket.disconnectFromHost();
+}
+
+void NetClient::send(NetMessageType type, const QByteArray &payload)
+{
+    QByteArray frame;
+    netAppendFrame(frame, type, payload);
+    socket.write(frame);
+    bytesOut += frame.size();
+}
+
+void NetClient::sendDirection(Direction dir)
+{
+    if (!ready)
+        return;
+    PendingInput input;
+    input.seq = ++nextSeq;
+    input.dir = dir;
+    pending.append(input);
+    send(NET_INPUT, netEncodeInput(input.seq, dir));
+
+    // Appliquée tout de suite, avec la règle du serveur (pas de demi-tour)
+    const ArenaSnake &s = mirror.snake(ownId);
+    if (dir != oppositeDirection(s.direction))
+        predicted = dir;
+}
+
+int NetClient::predictedHeadCell() const
+{
+    if (!ready || ownId < 0 || ownId >= mirror.snakeCount() || !mirror.snake(ownId).alive)
+        return -1;
+    return mirror.stepCell(mirror.snake(ownId).headCell(), predicted);
+}
+
+void NetClient::reconcile(quint32 ack)
+{
+    int acked = 0;
+    while (acked < pending.size() && pending[acked].seq <= ack)
+        ++acked;
+    pending.remove(0, acked);
+
+    // État du serveur, puis entrées qu'il n'a pas encore vues
+    const ArenaSnake &s = mirror.snake(ownId);
+    predicted = s.direction;
+    for (const PendingInput &input : pending)
+    {
+        if (input.dir != oppositeDirection(s.direction))
+            predicted = input.dir;
+    }
+}
+
+void NetClient::onReadyRead()
+{
+    QByteArray data = socket.readAll();
+    bytesIn += data.size();
+    reader.append(data);
+
+    NetMessageType type;
+    QByteArray payload;
+    while (reader.next(type, payload))
+        handleMessage(type, payload);
+
+    if (reader.hasError())
+        socket.abort();
+}
+
+void NetClient::handleMessage(NetMessageType type, const QByteArray &payload)
+{
+    switch (type)
+    {
+    case NET_WELCOME:
+    {
+        NetWelcome w;
+        if (!netDecodeWelcome(payload, w) || w.version != NET_PROTOCOL_VERSION)
+        {
+            socket.abort();
+            return;
+        }
+        ownId = w.snakeId;
+        tickMs = w.tickMs;
+        break;
+    }
+    case NET_SNAPSHOT:
+    {
+        bool first = !ready && deltas == 0;
+        ready = mirror.loadState(payload) && ownId >= 0 && ownId < mirror.snakeCount();
+        if (!ready)
+            return;
+        pending.clear();
+        predicted = mirror.snake(ownId).direction;
+        if (first)
+            emit joined();
+        emit updated();
+        break;
+    }
+    case NET_DELTA:
+    {
+        if (!ready)
+            return;
+        quint32 ack;
+        ArenaTickDelta d;
+        if (!netDecodeDelta(payload, ack, d))
+            return;
+        ++deltas;
+
+        int expected = predictedHeadCell();
+        bool applied = d.tick == mirror.tickCount() + 1 && mirror.applyDelta(d);
+        if (!applied)
+        {
+            // Copie divergente : on attend un SNAPSHOT complet
+            ++resyncs;
+            ready = false;
+            send(NET_RESYNC, QByteArray());
+            return;
+        }
+
+        const ArenaSnake &s = mirror.snake(ownId);
+        if (expected >= 0 && s.alive)
+        {
+            ++predictions;
+            if (s.headCell() != expected)
+                ++mispredictions;
+        }
+        reconcile(ack);
+        emit updated();
+        break;
+    }
+    case NET_STATS:
+        if (netDecodeStats(payload, stats))
+            emit statsReceived();
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef NETCLIENT_H
+#define NETCLIENT_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QVector>
+#include "arena.h"
+#include "netprotocol.h"
+
+// Client du mode réseau. Garde une copie de l'arène tenue à jour par les
+// DELTA du serveur et prédit localement son propre serpent : chaque
+// direction envoyée est appliquée tout de suite à la tête prévue, puis
+// rejouée au-dessus de l'état du serveur tant qu'elle n'est pas acquittée.
+class NetClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NetClient(QObject *parent = nullptr);
+
+    void connectTo(const QString &host, quint16 port = NET_DEFAULT_PORT);
+    void disconnectFrom();
+    void sendDirection(Direction dir);
+
+    bool isReady() const { return ready; }
+    int snakeId() const { return ownId; }
+    int tickInterval() const { return tickMs; }
+    const Arena &arena() const { return mirror; }
+
+    // Case que la tête doit occuper au prochain tick (-1 si mort)
+    int predictedHeadCell() const;
+    Direction predictedDirection() const { return predicted; }
+
+    qint64 bytesReceived() const { return bytesIn; }
+    qint64 bytesSent() const { return bytesOut; }
+    quint32 deltaCount() const { return deltas; }
+    quint32 predictionCount() const { return predictions; }
+    quint32 mispredictionCount() const { return mispredictions; }
+    quint32 resyncCount() const { return resyncs; }
+    const NetStats &serverStats() const { return stats; }
+
+signals:
+    void joined();           // WELCOME et premier SNAPSHOT reçus
+    void updated();          // après chaque SNAPSHOT ou DELTA
+    void statsReceived();
+    void disconnected();
+
+private slots:
+    void onReadyRead();
+
+private:
+    struct PendingInput
+    {
+        quint32 seq;
+        Direction dir;
+    };
+
+    QTcpSocket socket;
+    NetFrameReader reader;
+    Arena mirror;
+    bool ready;
+    int ownId;
+    int tickMs;
+    quint32 nextSeq;
+    QVector<PendingInput> pending;   // envoyées, pas encore acquittées
+    Direction predicted;
+
+    qint64 bytesIn;
+    qint64 bytesOut;
+    quint32 deltas;
+    quint32 predictions;
+    quint32 mispredictions;
+    quint32 resyncs;
+    NetStats stats;
+
+    void handleMessage(NetMessageType type, const QByteArray &payload);
+    void reconcile(quint32 ack);
+    void send(NetMessageType type, const QByteArray &payload);
+};
+
+#endif // NETCLIENT_H
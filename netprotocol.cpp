@@ -0,0 +1,238 @@
+#include "netprotocol.h"
+
+#include <QtEndian>
+
+static void putU8(QByteArray &out, quint8 v)
+{
+    out.append(static_cast<char>(v));
+}
+
+static void putU16(QByteArray &out, quint16 v)
+{
+    char b[2];
+    qToLittleEndian(v, b);
+    out.append(b, 2);
+}
+
+static void putU32(QByteArray &out, quint32 v)
+{
+    char b[4];
+    qToLittleEndian(v, b);
+    out.append(b, 4);
+}
+
+// Lecture bornée d'une charge utile : ok passe à false au premier débordement
+struct PayloadReader
+{
+    const QByteArray &data;
+    int pos;
+    bool ok;
+
+    explicit PayloadReader(const QByteArray &d) : data(d), pos(0), ok(true) {}
+
+    bool has(int n)
+    {
+        if (pos + n > data.size())
+            ok = false;
+        return ok;
+    }
+    quint8 u8()
+    {
+        if (!has(1))
+            return 0;
+        return static_cast<quint8>(data[pos++]);
+    }
+    quint16 u16()
+    {
+        if (!has(2))
+            return 0;
+        quint16 v = qFromLittleEndian<quint16>(data.constData() + pos);
+        pos += 2;
+        return v;
+    }
+    quint32 u32()
+    {
+        if (!has(4))
+            return 0;
+        quint32 v = qFromLittleEndian<quint32>(data.constData() + pos);
+        pos += 4;
+        return v;
+    }
+};
+
+void netAppendFrame(QByteArray &out, NetMessageType type, const QByteArray &payload)
+{
+    putU32(out, static_cast<quint32>(payload.size() + 1));
+    putU8(out, type);
+    out.append(payload);
+}
+
+QByteArray netEncodeWelcome(const NetWelcome &w)
+{
+    QByteArray p;
+    putU16(p, w.version);
+    putU16(p, w.snakeId);
+    putU16(p, w.tickMs);
+    return p;
+}
+
+bool netDecodeWelcome(const QByteArray &payload, NetWelcome &w)
+{
+    PayloadReader r(payload);
+    w.version = r.u16();
+    w.snakeId = r.u16();
+    w.tickMs = r.u16();
+    return r.ok;
+}
+
+QByteArray netEncodeDeltaBody(const ArenaTickDelta &d)
+{
+    QByteArray p;
+    p.reserve(12 + d.deaths.size() * 2 + d.moves.size() +
+              d.foodRemoved.size() * 4 + d.foodAdded.size() * 5);
+    putU32(p, d.tick);
+    putU16(p, static_cast<quint16>(d.deaths.size()));
+    for (quint16 id : d.deaths)
+        putU16(p, id);
+    putU16(p, static_cast<quint16>(d.moves.size()));
+    p.append(reinterpret_cast<const char *>(d.moves.constData()), d.moves.size());
+    putU16(p, static_cast<quint16>(d.foodRemoved.size()));
+    for (int cell : d.foodRemoved)
+        putU32(p, static_cast<quint32>(cell));
+    putU16(p, static_cast<quint16>(d.foodAdded.size()));
+    for (const ArenaFood &f : d.foodAdded)
+    {
+        putU32(p, static_cast<quint32>(f.cell));
+        putU8(p, static_cast<quint8>(f.type));
+    }
+    return p;
+}
+
+void netAppendDeltaFrame(QByteArray &out, quint32 ack, const QByteArray &body)
+{
+    putU32(out, static_cast<quint32>(body.size() + 5));
+    putU8(out, NET_DELTA);
+    putU32(out, ack);
+    out.append(body);
+}
+
+bool netDecodeDelta(const QByteArray &payload, quint32 &ack, ArenaTickDelta &d)
+{
+    PayloadReader r(payload);
+    d.clear();
+    ack = r.u32();
+    d.tick = r.u32();
+
+    int n = r.u16();
+    for (int i = 0; i < n && r.ok; ++i)
+        d.deaths.append(r.u16());
+
+    n = r.u16();
+    if (r.has(n))
+    {
+        d.moves.resize(n);
+        for (int i = 0; i < n; ++i)
+            d.moves[i] = r.u8();
+    }
+
+    n = r.u16();
+    for (int i = 0; i < n && r.ok; ++i)
+        d.foodRemoved.append(static_cast<int>(r.u32()));
+
+    n = r.u16();
+    for (int i = 0; i < n && r.ok; ++i)
+    {
+        ArenaFood f;
+        f.cell = static_cast<int>(r.u32());
+        f.type = static_cast<FruitType>(qMin<int>(r.u8(), FRUIT_TYPE_COUNT - 1));
+        d.foodAdded.append(f);
+    }
+    return r.ok;
+}
+
+QByteArray netEncodeStats(const NetStats &s)
+{
+    QByteArray p;
+    putU16(p, s.clients);
+    putU32(p, s.ticks);
+    putU32(p, s.tickP50Us);
+    putU32(p, s.tickP99Us);
+    putU32(p, s.tickMaxUs);
+    putU32(p, s.bytesOut);
+    return p;
+}
+
+bool netDecodeStats(const QByteArray &payload, NetStats &s)
+{
+    PayloadReader r(payload);
+    s.clients = r.u16();
+    s.ticks = r.u32();
+    s.tickP50Us = r.u32();
+    s.tickP99Us = r.u32();
+    s.tickMaxUs = r.u32();
+    s.bytesOut = r.u32();
+    return r.ok;
+}
+
+QByteArray netEncodeInput(quint32 seq, Direction dir)
+{
+    QByteArray p;
+    putU32(p, seq);
+    putU8(p, static_cast<quint8>(dir));
+    return p;
+}
+
+bool netDecodeInput(const QByteArray &payload, quint32 &seq, Direction &dir)
+{
+    PayloadReader r(payload);
+    seq = r.u32();
+    int d = r.u8();
+    if (!r.ok || d < UP || d > RIGHT)
+        return false;
+    dir = static_cast<Direction>(d);
+    return true;
+}
+
+NetFrameReader::NetFrameReader()
+    : offset(0),
+    error(false)
+{
+}
+
+void NetFrameReader::append(const QByteArray &data)
+{
+    // Compactage paresseux : on ne décale le tampon que lorsqu'il est
+    // consommé à plus de moitié
+    if (offset > 0 && offset * 2 >= buffer.size())
+    {
+        buffer.remove(0, offset);
+        offset = 0;
+    }
+    buffer.append(data);
+}
+
+bool NetFrameReader::next(NetMessageType &type, QByteArray &payload)
+{
+    if (error || buffer.size() - offset < 5)
+        return false;
+    quint32 length = qFromLittleEndian<quint32>(buffer.constData() + offset);
+    if (length == 0 || length > NET_MAX_FRAME)
+    {
+        error = true;
+        return false;
+    }
+    if (buffer.size() - offset < 4 + static_cast<int>(length))
+        return false;
+
+    type = static_cast<NetMessageType>(static_cast<quint8>(buffer[offset + 4]));
+    payload = buffer.mid(offset + 5, length - 1);
+    offset += 4 + length;
+    return true;
+}
+
+void NetFrameReader::clear()
+{
+    buffer.clear();
+    offset = 0;
+    error = false;
+}
@@ -0,0 +1,88 @@
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+// Protocole du mode réseau (TCP, Nagle désactivé). Chaque message :
+//   longueur u32 | type u8 | charge utile
+// en petit-boutiste, la longueur comptant le type et la charge.
+//
+// Serveur -> client : WELCOME puis SNAPSHOT (état complet) à la connexion
+// et à chaque nouvelle manche, un DELTA par tick, des STATS chaque seconde.
+// Client -> serveur : INPUT (numéro de séquence + direction), RESYNC pour
+// redemander un SNAPSHOT si la copie locale a divergé.
+//
+// DELTA : acquittement u32 (dernier INPUT appliqué) | tick u32
+//         | morts u16 + ids u16
+//         | déplacements u16 + un octet par survivant (ArenaTickDelta::moves)
+//         | fruits retirés u16 + cases u32 | fruits ajoutés u16 + (case u32, type u8)
+// Un corps n'est jamais retransmis : un serpent coûte un octet par tick.
+
+#include <QByteArray>
+#include "arena.h"
+
+#define NET_PROTOCOL_VERSION 1
+#define NET_DEFAULT_PORT 7777
+#define NET_MAX_FRAME (4 * 1024 * 1024)
+
+enum NetMessageType : quint8
+{
+    NET_WELCOME = 1,
+    NET_SNAPSHOT = 2,
+    NET_DELTA = 3,
+    NET_STATS = 4,
+    NET_INPUT = 16,
+    NET_RESYNC = 17
+};
+
+struct NetWelcome
+{
+    quint16 version;
+    quint16 snakeId;
+    quint16 tickMs;
+};
+
+// Mesures du serveur sur la dernière seconde
+struct NetStats
+{
+    quint16 clients;
+    quint32 ticks;
+    quint32 tickP50Us;   // coût d'un tick : simulation + encodage + envoi
+    quint32 tickP99Us;
+    quint32 tickMaxUs;
+    quint32 bytesOut;    // tous clients confondus
+};
+
+void netAppendFrame(QByteArray &out, NetMessageType type, const QByteArray &payload);
+
+QByteArray netEncodeWelcome(const NetWelcome &w);
+bool netDecodeWelcome(const QByteArray &payload, NetWelcome &w);
+
+// Corps commun à tous les clients ; l'acquittement est ajouté par client
+QByteArray netEncodeDeltaBody(const ArenaTickDelta &d);
+void netAppendDeltaFrame(QByteArray &out, quint32 ack, const QByteArray &body);
+bool netDecodeDelta(const QByteArray &payload, quint32 &ack, ArenaTickDelta &d);
+
+QByteArray netEncodeStats(const NetStats &s);
+bool netDecodeStats(const QByteArray &payload, NetStats &s);
+
+QByteArray netEncodeInput(quint32 seq, Direction dir);
+bool netDecodeInput(const QByteArray &payload, quint32 &seq, Direction &dir);
+
+// Découpe un flux TCP en messages
+class NetFrameReader
+{
+public:
+    NetFrameReader();
+
+    void append(const QByteArray &data);
+    // false : aucun message complet pour l'instant
+    bool next(NetMessageType &type, QByteArray &payload);
+    bool hasError() const { return error; }
+    void clear();
+
+private:
+    QByteArray buffer;
+    int offset;
+    bool error;
+};
+
+#endif // NETPROTOCOL_H
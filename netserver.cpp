@@ -0,0 +1,211 @@
+#include "netserver.h"
+
+#include <algorithm>
+
+// Un client qui n'absorbe plus ses messages est déconnecté plutôt que
+// de laisser grossir sa file d'envoi
+static const qint64 MAX_PENDING_BYTES = 1024 * 1024;
+
+NetServer::NetServer(QObject *parent)
+    : QObject(parent),
+    playerSlots(0),
+    tickMs(0),
+    bytesOut(0)
+{
+    tickTimer.setTimerType(Qt::PreciseTimer);
+    connect(&tickTimer, &QTimer::timeout, this, &NetServer::onTick);
+    connect(&server, &QTcpServer::newConnection, this, &NetServer::onNewConnection);
+    configure(16, 0, WIDTH, HEIGHT, 2);
+}
+
+NetServer::~NetServer()
+{
+    for (Client *c : clients)
+    {
+        c->socket->abort();
+        delete c->socket;
+        delete c;
+    }
+}
+
+void NetServer::configure(int maxClients, int bots, int width, int height, int level, int tick)
+{
+    playerSlots = qBound(1, maxClients, static_cast<int>(Arena::MAX_SNAKES));
+    arena.setup(playerSlots, bots, width, height);
+    arena.setLevel(level);
+    tickMs = (tick > 0) ? tick : arena.getSpeed();
+
+    // Emplacements libres pilotés par le bot jusqu'à l'arrivée d'un client
+    slotTaken.fill(0, playerSlots);
+    for (int id = 0; id < playerSlots; ++id)
+        arena.setBotControlled(id, true);
+}
+
+bool NetServer::listen(quint16 port)
+{
+    if (!server.listen(QHostAddress::Any, port))
+        return false;
+    startRound();
+    statsClock.start();
+    tickTimer.start(tickMs);
+    return true;
+}
+
+void NetServer::startRound()
+{
+    arena.reset();
+
+    QByteArray frame;
+    netAppendFrame(frame, NET_SNAPSHOT, arena.saveState());
+    for (Client *c : clients)
+    {
+        c->socket->write(frame);
+        bytesOut += frame.size();
+    }
+}
+
+void NetServer::sendSnapshot(Client *c)
+{
+    NetWelcome w;
+    w.version = NET_PROTOCOL_VERSION;
+    w.snakeId = static_cast<quint16>(c->snakeId);
+    w.tickMs = static_cast<quint16>(tickMs);
+
+    QByteArray frame;
+    netAppendFrame(frame, NET_WELCOME, netEncodeWelcome(w));
+    netAppendFrame(frame, NET_SNAPSHOT, arena.saveState());
+    c->socket->write(frame);
+    bytesOut += frame.size();
+}
+
+void NetServer::onNewConnection()
+{
+    while (server.hasPendingConnections())
+    {
+        QTcpSocket *socket = server.nextPendingConnection();
+        int slot = static_cast<int>(std::find(slotTaken.begin(), slotTaken.end(), 0) - slotTaken.begin());
+        if (slot >= playerSlots)
+        {
+            // Serveur complet
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        Client *c = new Client;
+        c->socket = socket;
+        c->snakeId = slot;
+        c->lastSeq = 0;
+        clients.append(c);
+        slotTaken[slot] = 1;
+        // Rejoint en cours de manche : il reprend le serpent du bot
+        arena.setBotControlled(slot, false);
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, c]() { readClient(c); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, c]() { dropClient(c); });
+        sendSnapshot(c);
+    }
+}
+
+void NetServer::readClient(Client *c)
+{
+    c->reader.append(c->socket->readAll());
+
+    NetMessageType type;
+    QByteArray payload;
+    while (c->reader.next(type, payload))
+    {
+        quint32 seq;
+        Direction dir;
+        if (type == NET_INPUT && netDecodeInput(payload, seq, dir) && seq > c->lastSeq)
+        {
+            arena.changeDirection(c->snakeId, dir);
+            c->lastSeq = seq;
+        }
+        else if (type == NET_RESYNC)
+        {
+            QByteArray frame;
+            netAppendFrame(frame, NET_SNAPSHOT, arena.saveState());
+            c->socket->write(frame);
+            bytesOut += frame.size();
+        }
+    }
+    if (c->reader.hasError())
+        dropClient(c);
+}
+
+void NetServer::dropClient(Client *c)
+{
+    int index = clients.indexOf(c);
+    if (index < 0)
+        return;
+    clients.remove(index);
+    slotTaken[c->snakeId] = 0;
+    arena.setBotControlled(c->snakeId, true);
+
+    c->socket->disconnect(this);
+    c->socket->abort();
+    c->socket->deleteLater();
+    delete c;
+}
+
+void NetServer::onTick()
+{
+    QElapsedTimer cost;
+    cost.start();
+
+    if (arena.isOver())
+    {
+        startRound();
+    }
+    else
+    {
+        arena.tick();
+        QByteArray body = netEncodeDeltaBody(arena.lastDelta());
+        QByteArray frame;
+        frame.reserve(body.size() + 9);
+
+        // Copie : dropClient() modifie la liste
+        const QVector<Client *> targets = clients;
+        for (Client *c : targets)
+        {
+            if (c->socket->bytesToWrite() > MAX_PENDING_BYTES)
+            {
+                dropClient(c);
+                continue;
+            }
+            frame.resize(0);
+            netAppendDeltaFrame(frame, c->lastSeq, body);
+            c->socket->write(frame);
+            bytesOut += frame.size();
+        }
+    }
+
+    tickCosts.append(static_cast<quint32>(cost.nsecsElapsed() / 1000));
+    if (statsClock.elapsed() >= 1000)
+        broadcastStats();
+}
+
+void NetServer::broadcastStats()
+{
+    std::sort(tickCosts.begin(), tickCosts.end());
+    int n = tickCosts.size();
+
+    NetStats s;
+    s.clients = static_cast<quint16>(clients.size());
+    s.ticks = static_cast<quint32>(n);
+    s.tickP50Us = n ? tickCosts[n / 2] : 0;
+    s.tickP99Us = n ? tickCosts[qMin(n - 1, n * 99 / 100)] : 0;
+    s.tickMaxUs = n ? tickCosts[n - 1] : 0;
+    s.bytesOut = bytesOut;
+
+    QByteArray frame;
+    netAppendFrame(frame, NET_STATS, netEncodeStats(s));
+    for (Client *c : clients)
+        c->socket->write(frame);
+
+    tickCosts.clear();
+    bytesOut = 0;
+    statsClock.restart();
+}
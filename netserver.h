@@ -0,0 +1,63 @@
+#ifndef NETSERVER_H
+#define NETSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include "arena.h"
+#include "netprotocol.h"
+
+// Serveur faisant autorité pour le mode réseau : une Arena dont chaque
+// emplacement de joueur est piloté par un client TCP, ou par le bot
+// intégré tant qu'aucun client ne l'occupe. Un seul encodage du delta par
+// tick, partagé par tous les clients.
+class NetServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NetServer(QObject *parent = nullptr);
+    ~NetServer();
+
+    // tickMs = 0 : vitesse du niveau
+    void configure(int maxClients, int bots, int width, int height, int level, int tickMs = 0);
+    bool listen(quint16 port = NET_DEFAULT_PORT);
+    QString errorString() const { return server.errorString(); }
+    int clientCount() const { return clients.size(); }
+
+private slots:
+    void onNewConnection();
+    void onTick();
+
+private:
+    struct Client
+    {
+        QTcpSocket *socket;
+        int snakeId;
+        quint32 lastSeq;   // dernier INPUT appliqué, renvoyé dans chaque DELTA
+        NetFrameReader reader;
+    };
+
+    QTcpServer server;
+    QTimer tickTimer;
+    Arena arena;
+    int playerSlots;
+    int tickMs;
+    QVector<Client *> clients;
+    QVector<char> slotTaken;
+
+    QElapsedTimer statsClock;
+    QVector<quint32> tickCosts;  // µs, depuis les dernières STATS
+    quint32 bytesOut;
+
+    void startRound();
+    void sendSnapshot(Client *c);
+    void readClient(Client *c);
+    void dropClient(Client *c);
+    void broadcastStats();
+};
+
+#endif // NETSERVER_H
@@ -0,0 +1,278 @@
+#include "replay.h"
+
+#include <QFile>
+#include <QtEndian>
+#include <QSaveFile>
+
+bool Replay::save(const QString &path, QString *error) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(toBytes()) < 0 || !file.commit())
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Disposition de QDataStream en petit-boutiste, écrite et lue sur place :
+// une chaîne est sa longueur en octets (0xFFFFFFFF : chaîne nulle) puis
+// son UTF-16
+static constexpr qint64 REPLAY_FIXED_BYTES = 11 * 4;   // champs de 32 bits
+static constexpr int REPLAY_INPUT_BYTES = 5;
+static constexpr qint64 REPLAY_LEVEL_BYTES = 6 * 4;    // version 2
+static constexpr int REPLAY_RESEED_BYTES = 8;          // version 3
+
+static quint32 readU32(const uchar *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+static LevelParams playedParams(const Replay &replay)
+{
+    if (replay.levelParams.isValid())
+        return replay.levelParams;
+    return LevelTable().level(replay.level);
+}
+
+QByteArray Replay::toBytes() const
+{
+    qint64 pathBytes = mapPath.isNull() ? 0 : qint64(mapPath.size()) * 2;
+    QByteArray bytes(int(REPLAY_FIXED_BYTES + pathBytes
+                         + qint64(inputs.size()) * REPLAY_INPUT_BYTES + REPLAY_LEVEL_BYTES
+                         + 4 + qint64(reseeds.size()) * REPLAY_RESEED_BYTES),
+                     '\0');
+    uchar *p = reinterpret_cast<uchar *>(bytes.data());
+    auto put = [&p](quint32 v) {
+        qToLittleEndian<quint32>(v, p);
+        p += 4;
+    };
+    put(REPLAY_MAGIC);
+    put(REPLAY_VERSION);
+    put(seed);
+    put(quint32(level));
+    put(quint32(layout));
+    put(quint32(foods));
+    put(quint32(hazards));
+    put(mapPath.isNull() ? 0xFFFFFFFFu : quint32(pathBytes));
+    for (int i = 0; i < mapPath.size(); ++i)
+    {
+        qToLittleEndian<quint16>(mapPath.at(i).unicode(), p);
+        p += 2;
+    }
+    put(ticks);
+    put(quint32(finalScore));
+    put(quint32(inputs.size()));
+    for (const ReplayInput &input : inputs)
+    {
+        put(input.tick);
+        *p++ = quint8(input.dir);
+    }
+    LevelParams params = playedParams(*this);
+    put(quint32(params.tickMs));
+    put(quint32(params.wallsPerThousand));
+    put(quint32(params.clusterPercent));
+    put(quint32(params.roomPitch));
+    put(quint32(params.doorWidth));
+    put(quint32(params.mazePitch));
+    put(quint32(reseeds.size()));
+    for (const ReplayReseed &reseed : reseeds)
+    {
+        put(reseed.tick);
+        put(reseed.seed);
+    }
+    return bytes;
+}
+
+qint64 Replay::recordSize(const uchar *data, qint64 size)
+{
+    if (size < 8 * 4 || readU32(data) != REPLAY_MAGIC)
+        return -1;
+    quint32 version = readU32(data + 4);
+    if (version < 1 || version > REPLAY_VERSION)
+        return -1;
+    quint32 pathBytes = readU32(data + 7 * 4);
+    if (pathBytes == 0xFFFFFFFFu)
+        pathBytes = 0;
+    if ((pathBytes & 1) || pathBytes > size || REPLAY_FIXED_BYTES + pathBytes > size)
+        return -1;
+    quint32 count = readU32(data + REPLAY_FIXED_BYTES - 4 + pathBytes);
+    qint64 total = REPLAY_FIXED_BYTES + pathBytes + qint64(count) * REPLAY_INPUT_BYTES
+                 + (version >= 2 ? REPLAY_LEVEL_BYTES : 0);
+    if (version >= 3)
+    {
+        if (total + 4 > size)
+            return -1;
+        total += 4 + qint64(readU32(data + total)) * REPLAY_RESEED_BYTES;
+    }
+    return total <= size ? total : -1;
+}
+
+qint64 Replay::read(const uchar *data, qint64 size, QString *error)
+{
+    qint64 total = recordSize(data, size);
+    if (total < 0)
+    {
+        if (error)
+            *error = "pas une partie enregistree (.snkp) de cette version, ou tronquee";
+        return -1;
+    }
+    qint32 lay = qint32(readU32(data + 4 * 4));
+    if (lay < 0 || lay >= LAYOUT_COUNT)
+    {
+        if (error)
+            *error = "en-tete invalide";
+        return -1;
+    }
+    seed = readU32(data + 2 * 4);
+    level = qint32(readU32(data + 3 * 4));
+    layout = static_cast<LayoutStyle>(lay);
+    foods = qint32(readU32(data + 5 * 4));
+    hazards = qint32(readU32(data + 6 * 4));
+
+    quint32 pathBytes = readU32(data + 7 * 4);
+    const uchar *p = data + 8 * 4;
+    if (pathBytes == 0xFFFFFFFFu)
+    {
+        mapPath.clear();
+    }
+    else
+    {
+        mapPath.resize(int(pathBytes / 2));
+        for (int i = 0; i < mapPath.size(); ++i)
+            mapPath[i] = QChar(qFromLittleEndian<quint16>(p + 2 * i));
+        p += pathBytes;
+    }
+    ticks = readU32(p);
+    finalScore = qint32(readU32(p + 4));
+    int count = int(readU32(p + 8));
+    p += 12;
+
+    // La capacité est conservée : relire des parties à la suite dans le
+    // même objet n'alloue plus une fois la plus longue passée
+    inputs.resize(count);
+    for (ReplayInput &input : inputs)
+    {
+        quint8 dir = p[4];
+        if (dir < UP || dir > RIGHT)
+        {
+            if (error)
+                *error = "entrees invalides";
+            return -1;
+        }
+        input.tick = readU32(p);
+        input.dir = static_cast<Direction>(dir);
+        p += REPLAY_INPUT_BYTES;
+    }
+
+    levelParams = LevelTable().level(level);
+    if (readU32(data + 4) >= 2)
+    {
+        LevelParams recorded;
+        recorded.tickMs = qint32(readU32(p));
+        recorded.wallsPerThousand = qint32(readU32(p + 4));
+        recorded.clusterPercent = qint32(readU32(p + 8));
+        recorded.roomPitch = qint32(readU32(p + 12));
+        recorded.doorWidth = qint32(readU32(p + 16));
+        recorded.mazePitch = qint32(readU32(p + 20));
+        if (!recorded.isValid())
+        {
+            if (error)
+                *error = "reglages du niveau invalides";
+            return -1;
+        }
+        levelParams = recorded;
+        p += REPLAY_LEVEL_BYTES;
+    }
+
+    reseeds.resize(0);
+    if (readU32(data + 4) >= 3)
+    {
+        reseeds.resize(int(readU32(p)));
+        p += 4;
+        for (ReplayReseed &reseed : reseeds)
+        {
+            reseed.tick = readU32(p);
+            reseed.seed = readU32(p + 4);
+            p += REPLAY_RESEED_BYTES;
+        }
+    }
+    return total;
+}
+
+bool Replay::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    qint64 size = file.size();
+    const uchar *data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data)
+    {
+        if (error)
+            *error = size > 0 ? file.errorString() : QString("fichier vide");
+        return false;
+    }
+    bool ok = read(data, size, error) >= 0;
+    file.unmap(const_cast<uchar *>(data));
+    return ok;
+}
+
+bool Replay::setup(Game &game, QString *error) const
+{
+    if (mapPath.isEmpty())
+        game.clearMap();
+    else if (!game.loadMap(mapPath, error))
+        return false;
+    LevelTable levels;
+    levels.setLevel(level, playedParams(*this));
+    game.setLevelTable(levels);
+    game.setLevel(level);
+    game.setLayoutStyle(layout);
+    game.setFoodCount(foods);
+    game.setHazardCount(hazards);
+    game.setSeed(seed);
+    game.reset();
+    return true;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay &replay)
+    : recording(replay),
+    nextInput(0),
+    nextReseed(0)
+{
+}
+
+bool ReplayPlayer::start(QString *error)
+{
+    nextInput = 0;
+    nextReseed = 0;
+    return recording.setup(replayed, error);
+}
+
+// Les entrées d'un pas sont appliquées juste avant lui, comme sur le
+// thread de jeu où elles arrivent entre deux pas ; les sauvegardes aussi
+bool ReplayPlayer::step()
+{
+    if (replayed.isGameOver())
+        return false;
+    while (nextReseed < recording.reseeds.size()
+           && recording.reseeds[nextReseed].tick <= replayed.tickCount())
+        replayed.setSeed(recording.reseeds[nextReseed++].seed);
+    while (nextInput < recording.inputs.size()
+           && recording.inputs[nextInput].tick <= replayed.tickCount())
+        replayed.changeDirection(recording.inputs[nextInput++].dir);
+    replayed.updateGame();
+    return true;
+}
+
+bool ReplayPlayer::matchesRecording() const
+{
+    return replayed.isGameOver() && replayed.tickCount() == recording.ticks
+        && replayed.getScore() == recording.finalScore;
+}
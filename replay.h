@@ -0,0 +1,93 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "game.h"
+
+// Partie enregistrée (.snkp) : graine et réglages de la partie, puis chaque
+// changement de direction avec le pas où il a été demandé. Game étant
+// déterministe pour une graine donnée, rejouer ces entrées redonne la même
+// partie, pas pour pas ; quelques octets par virage suffisent.
+//
+//   en-tête (u32 petit-boutiste, disposition de QDataStream) :
+//       magic | version | graine | niveau | disposition | fruits |
+//       dangers | carte (octets u32 + UTF-16) | pas | score | entrées
+//   entrées : pas u32 | direction u8
+//   réglages du niveau (version 2) : pas_ms | murs | amas | salle | porte
+//       | couloir, en u32 (voir LevelTable)
+//   nouvelles graines (version 3) : nombre u32, puis pas u32 | graine u32
+//
+// Une partie de version 1 se rejoue avec les réglages d'origine du niveau.
+// Chaque sauvegarde automatique change la graine de la partie (voir
+// Game::reseed()) ; elle est rejouée au même pas.
+
+#define REPLAY_MAGIC 0x504B4E53u  // "SNKP"
+#define REPLAY_VERSION 3
+
+struct ReplayInput
+{
+    quint32 tick;    // Game::tickCount() au moment de la demande
+    Direction dir;
+};
+
+struct ReplayReseed
+{
+    quint32 tick;    // Game::tickCount() au moment du changement
+    quint32 seed;
+};
+
+struct Replay
+{
+    quint32 seed = 0;
+    int level = 1;
+    LevelParams levelParams = {};   // invalide : réglages d'origine du niveau
+    LayoutStyle layout = LAYOUT_SCATTER;
+    int foods = Game::FOOD_COUNT;
+    int hazards = 0;
+    QString mapPath;     // vide : pas de carte
+    quint32 ticks = 0;   // pas joués jusqu'à la fin de la partie
+    int finalScore = 0;
+    QVector<ReplayInput> inputs;
+    QVector<ReplayReseed> reseeds;
+
+    bool save(const QString &path, QString *error = nullptr) const;
+    QByteArray toBytes() const;
+    bool load(const QString &path, QString *error = nullptr);
+
+    // Partie lue en mémoire (fichier projeté ; des parties mises bout à
+    // bout se lisent à la suite). Renvoie les octets lus, -1 si invalide.
+    qint64 read(const uchar *data, qint64 size, QString *error = nullptr);
+    // Taille de la partie qui commence en `data`, sans la décoder ; -1 si
+    // l'en-tête est invalide ou la partie tronquée
+    static qint64 recordSize(const uchar *data, qint64 size);
+
+    // Réglages, graine et reset() : `game` est au pas 0 de la partie.
+    // Échoue si la carte enregistrée ne s'ouvre plus.
+    bool setup(Game &game, QString *error = nullptr) const;
+};
+
+// Relecture pas à pas d'une partie enregistrée
+class ReplayPlayer
+{
+public:
+    explicit ReplayPlayer(const Replay &replay);
+
+    bool start(QString *error = nullptr);
+    bool step();   // un pas ; false une fois la partie finie
+    bool atEnd() const { return replayed.isGameOver(); }
+    const Game &game() const { return replayed; }
+
+    // Même fin que l'enregistrement : faux si la logique de jeu a changé
+    // depuis (la partie rejouée diverge alors de l'originale)
+    bool matchesRecording() const;
+
+private:
+    const Replay &recording;
+    Game replayed;
+    int nextInput;
+    int nextReseed;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,106 @@
+#include "savegame.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+QByteArray SaveGame::toBytes() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << SAVEGAME_MAGIC << quint32(SAVEGAME_VERSION) << recording.toBytes() << game << screen;
+    return data;
+}
+
+bool SaveGame::fromBytes(const QByteArray &data, QString *error)
+{
+    QDataStream in(data);
+    quint32 magic, version;
+    QByteArray replay;
+    in >> magic >> version >> replay >> game >> screen;
+    if (magic != SAVEGAME_MAGIC || version != SAVEGAME_VERSION || in.status() != QDataStream::Ok)
+    {
+        if (error)
+            *error = "pas une sauvegarde (.snks) de cette version, ou tronquee";
+        return false;
+    }
+    if (recording.read(reinterpret_cast<const uchar *>(replay.constData()), replay.size(),
+                       error) < 0)
+        return false;
+    if (recording.reseeds.isEmpty())
+    {
+        if (error)
+            *error = "graine de l'etat sauvegarde absente";
+        return false;
+    }
+    return true;
+}
+
+bool SaveGame::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return fromBytes(file.readAll(), error);
+}
+
+SaveWriter::SaveWriter(QObject *parent)
+    : QThread(parent),
+    stopping(false)
+{
+}
+
+SaveWriter::~SaveWriter()
+{
+    if (isRunning())
+        finish();
+}
+
+void SaveWriter::submit(const QString &path, const QByteArray &data)
+{
+    Request &request = requests.writeBuffer();
+    request.path = path;
+    request.data = data;
+    requests.publish();
+    wake.release();
+}
+
+void SaveWriter::finish()
+{
+    stopping = true;
+    wake.release();
+    wait();
+    stopping = false;
+}
+
+// Un réveil peut trouver la sauvegarde déjà prise au réveil précédent ;
+// la dernière déposée avant finish() est relue après la boucle
+void SaveWriter::run()
+{
+    while (!stopping)
+    {
+        wake.acquire();
+        if (requests.update())
+            write(requests.readBuffer());
+    }
+    if (requests.update())
+        write(requests.readBuffer());
+}
+
+// Une écriture ratée (disque plein, dossier absent) n'interrompt pas la
+// partie : la sauvegarde suivante retente
+void SaveWriter::write(const Request &request)
+{
+    if (request.data.isEmpty())
+    {
+        QFile::remove(request.path);
+        return;
+    }
+    QSaveFile file(request.path);
+    if (file.open(QIODevice::WriteOnly) && file.write(request.data) == request.data.size())
+        file.commit();
+}
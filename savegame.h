@@ -0,0 +1,71 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <QByteArray>
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include "replay.h"
+#include "triplebuffer.h"
+
+// Partie solo interrompue (.snks), reprise au lancement suivant. Le
+// fichier est toujours remplacé d'un bloc (QSaveFile, renommage atomique) :
+// un arrêt brutal laisse l'ancienne sauvegarde ou la nouvelle, jamais un
+// mélange des deux.
+//
+//   magic u32 | version u32 | enregistrement | état du jeu | affichage
+//   (tableaux d'octets de QDataStream : longueur u32 puis les octets)
+//
+// L'enregistrement (Replay::toBytes()) couvre la partie depuis le pas 0 ;
+// sa dernière nouvelle graine est celle de l'état sauvegardé, la partie
+// reprise reste donc rejouable en entier.
+
+#define SAVEGAME_MAGIC 0x534B4E53u  // "SNKS"
+#define SAVEGAME_VERSION 1
+
+struct SaveGame
+{
+    Replay recording;
+    QByteArray game;     // Game::saveState()
+    QByteArray screen;   // propre à l'affichage (SnakeWidget), éventuellement vide
+
+    QByteArray toBytes() const;
+    bool fromBytes(const QByteArray &data, QString *error = nullptr);
+    bool load(const QString &path, QString *error = nullptr);
+};
+
+// Écriture des sauvegardes sur son propre thread : le thread de jeu ne
+// fait que déposer les octets dans un tampon triple, sans verrou ni
+// attente, et aucun pas n'attend le disque. Une sauvegarde pas encore
+// écrite est remplacée par la suivante ; seule la dernière compte.
+class SaveWriter : public QThread
+{
+public:
+    explicit SaveWriter(QObject *parent = nullptr);
+    ~SaveWriter();
+
+    // Toujours depuis le même thread ; des octets vides suppriment le fichier
+    void submit(const QString &path, const QByteArray &data);
+    // Écrit la dernière sauvegarde déposée puis arrête le thread ; à
+    // appeler depuis le thread qui dépose
+    void finish();
+
+protected:
+    void run() override;
+
+private:
+    struct Request
+    {
+        QString path;
+        QByteArray data;
+    };
+
+    TripleBuffer<Request> requests;
+    QSemaphore wake;
+    std::atomic<bool> stopping;
+
+    void write(const Request &request);
+};
+
+#endif // SAVEGAME_H
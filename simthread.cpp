@@ -0,0 +1,360 @@
+#include "simthread.h"
+
+#include <QElapsedTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+SimThread::SimThread(QObject *parent)
+    : QThread(parent),
+    gameId(0),
+    periodMs(0),
+    running(false),
+    quitting(false),
+    lastSaveNs(0)
+{
+    // Connexion directe : émis et reçu sur le thread de jeu
+    connect(&game, &Game::fruitEaten, this,
+            [this](int x, int y, int points, FruitType type) {
+                events.push({gameId, x, y, points, type});
+            },
+            Qt::DirectConnection);
+}
+
+SimThread::~SimThread()
+{
+    shutdown();
+}
+
+void SimThread::shutdown()
+{
+    if (isRunning())
+    {
+        send(CMD_QUIT);
+        wait();
+    }
+}
+
+// Une commande perdue fausserait la partie : on attend une place libre,
+// le thread de jeu vide la file à chaque réveil
+void SimThread::push(const Command &cmd)
+{
+    while (!commands.push(cmd))
+        QThread::yieldCurrentThread();
+    wake.release();
+}
+
+void SimThread::send(CommandType type, int arg)
+{
+    Command cmd;
+    cmd.type = type;
+    cmd.arg = arg;
+    push(cmd);
+}
+
+void SimThread::startGame(const SimSettings &settings, quint32 id)
+{
+    Command cmd;
+    cmd.type = CMD_START;
+    cmd.arg = static_cast<int>(id);
+    cmd.settings = settings;
+    push(cmd);
+}
+
+void SimThread::restoreGame(const SimSettings &settings, const QSharedPointer<const SaveGame> &save,
+                            quint32 id)
+{
+    Command cmd;
+    cmd.type = CMD_RESTORE;
+    cmd.arg = static_cast<int>(id);
+    cmd.settings = settings;
+    cmd.save = save;
+    push(cmd);
+}
+
+void SimThread::saveGame(const QByteArray &screen)
+{
+    Command cmd;
+    cmd.type = CMD_SAVE;
+    cmd.arg = 0;
+    cmd.screen = screen;
+    push(cmd);
+}
+
+void SimThread::configure(const SimSettings &settings)
+{
+    if (settings.mapPath != mapPath)
+    {
+        mapPath = settings.mapPath;
+        if (mapPath.isEmpty() || !game.loadMap(mapPath))
+            game.clearMap();
+    }
+    game.setLevelTable(settings.levels);
+    game.setLevel(settings.level);
+    game.setLayoutStyle(settings.layout);
+    game.setFoodCount(settings.foods);
+    game.setHazardCount(settings.hazards);
+    periodMs = settings.periodMs;
+    savePath = settings.savePath;
+}
+
+// Graine tirée ici et gardée : la partie peut être rejouée
+void SimThread::newGame(const SimSettings &settings)
+{
+    recording = QSharedPointer<Replay>::create();
+    recording->seed = QRandomGenerator::global()->generate();
+    recording->level = settings.level;
+    recording->levelParams = game.levelParams();
+    recording->layout = settings.layout;
+    recording->foods = settings.foods;
+    recording->hazards = settings.hazards;
+    recording->mapPath = game.hasMap() ? mapPath : QString();
+    game.setSeed(recording->seed);
+    game.reset();
+}
+
+// Quelques microsecondes sur le thread de jeu : l'état tient en quelques
+// Ko et le disque est l'affaire de SaveWriter. Deux sauvegardes d'un même
+// pas (pause puis menu) gardent la même graine.
+void SimThread::writeSave(const QByteArray &screen, qint64 nowNs)
+{
+    lastSaveNs = nowNs;
+    if (savePath.isEmpty() || gameId == 0 || !recording || game.isGameOver())
+        return;
+    quint32 tick = static_cast<quint32>(game.tickCount());
+    if (recording->reseeds.isEmpty() || recording->reseeds.last().tick != tick)
+        recording->reseeds.append({tick, game.reseed()});
+
+    SaveGame save;
+    save.recording = *recording;
+    save.game = game.saveState();
+    save.screen = screen;
+    saves.submit(savePath, save.toBytes());
+}
+
+void SimThread::drainCommands(qint64 nowNs, qint64 &deadlineNs)
+{
+    Command cmd;
+    while (commands.pop(cmd))
+    {
+        switch (cmd.type)
+        {
+        case CMD_START:
+            configure(cmd.settings);
+            gameId = static_cast<quint32>(cmd.arg);
+            newGame(cmd.settings);
+            startHeat(cmd.settings.heatMapDir);
+            running = true;
+            lastSaveNs = nowNs;
+            deadlineNs = nowNs + period() * 1000000LL;
+            publish();
+            break;
+        case CMD_RESTORE:
+            // L'état reprend avec la graine tirée à la sauvegarde
+            configure(cmd.settings);
+            gameId = static_cast<quint32>(cmd.arg);
+            recording = QSharedPointer<Replay>::create(cmd.save->recording);
+            if (game.loadState(cmd.save->game)
+                && recording->reseeds.last().tick == game.tickCount())
+                game.setSeed(recording->reseeds.last().seed);
+            else
+            {
+                configure(cmd.settings);   // l'état a pu être repris sans sa graine
+                newGame(cmd.settings);
+            }
+            startHeat(cmd.settings.heatMapDir);
+            running = false;
+            lastSaveNs = nowNs;
+            publish();
+            break;
+        case CMD_SAVE:
+            writeSave(cmd.screen, nowNs);
+            break;
+        case CMD_PAUSE:
+        case CMD_STOP:
+            running = false;
+            break;
+        case CMD_RESUME:
+            if (gameId != 0 && !game.isGameOver())
+            {
+                running = true;
+                deadlineNs = nowNs + period() * 1000000LL;
+            }
+            break;
+        case CMD_DIRECTION:
+            game.changeDirection(static_cast<Direction>(cmd.arg));
+            if (recording && !game.isGameOver())
+                recording->inputs.append({static_cast<quint32>(game.tickCount()),
+                                          static_cast<Direction>(cmd.arg)});
+            break;
+        case CMD_QUIT:
+            quitting = true;
+            break;
+        }
+    }
+}
+
+// Attente en trois temps (voir WAKE_US). La boucle active reste courte :
+// sur une machine à un cœur, elle prendrait le processeur au rendu sans
+// rien gagner. Les échéances se suivent à période fixe, sans cumuler les
+// retards.
+void SimThread::run()
+{
+#ifdef Q_OS_WIN
+    timeBeginPeriod(1);  // réveils à la milliseconde au lieu de ~15,6 ms
+#endif
+    QElapsedTimer clock;
+    clock.start();
+    qint64 deadline = 0;
+    saves.start(QThread::LowPriority);
+
+    while (!quitting)
+    {
+        drainCommands(clock.nsecsElapsed(), deadline);
+        if (quitting)
+            break;
+        if (!running)
+        {
+            wake.acquire();
+            continue;
+        }
+
+        qint64 left = deadline - clock.nsecsElapsed();
+        if (left > WAKE_US * 1000LL)
+        {
+            // Une commande réveille le thread tout de suite
+            wake.tryAcquire(1, static_cast<int>((left - WAKE_US * 1000LL) / 1000000));
+            continue;
+        }
+        if (left > SPIN_US * 1000LL)
+            QThread::usleep(static_cast<unsigned long>((left - SPIN_US * 1000LL) / 1000));
+        while (clock.nsecsElapsed() < deadline)
+        {
+        }
+
+        // Entrées arrivées pendant la boucle active : jouées dans ce pas
+        qint64 now = clock.nsecsElapsed();
+        drainCommands(now, deadline);
+        if (!running || quitting || deadline > now)
+            continue;
+
+        qint64 late = now - deadline;
+        ++timing.ticks;
+        timing.totalLateNs += late;
+        timing.maxLateNs = qMax(timing.maxLateNs, late);
+        if (late > 1000000)
+            ++timing.lateTicks;
+
+        game.updateGame();
+        int headCell = game.headY() * game.boardWidth() + game.headX();
+        if (game.isGameOver())
+        {
+            running = false;
+            recording->ticks = static_cast<quint32>(game.tickCount());
+            recording->finalScore = game.getScore();
+            if (!savePath.isEmpty())
+                saves.submit(savePath, QByteArray());   // plus rien à reprendre
+            if (!heatPath.isEmpty())
+            {
+                heat.death(headCell);
+                flushHeat();   // avant la publication : l'affichage relit le fichier
+            }
+        }
+        else if (!heatPath.isEmpty())
+        {
+            heat.visit(headCell);
+        }
+        publish();
+        if (running && now - lastSaveNs >= AUTOSAVE_MS * 1000000LL)
+            writeSave(QByteArray(), now);
+
+        // Après une longue suspension (veille, débogueur), on repart de
+        // maintenant plutôt que d'enchaîner les pas en retard
+        deadline += period() * 1000000LL;
+        if (clock.nsecsElapsed() > deadline)
+            deadline = clock.nsecsElapsed() + period() * 1000000LL;
+    }
+
+    flushHeat();
+    saves.finish();
+
+#ifdef Q_OS_WIN
+    timeEndPeriod(1);
+#endif
+}
+
+// Une carte de chaleur par configuration (HeatMap::fileName) ; les
+// compteurs d'une autre configuration sont écrits avant d'en changer
+void SimThread::startHeat(const QString &directory)
+{
+    QString path;
+    if (!directory.isEmpty())
+        path = directory + "/" + HeatMap::fileName(game.hasMap() ? mapPath : QString(),
+                                                   game.layoutStyle(), game.getLevel(),
+                                                   game.boardWidth(), game.boardHeight());
+    if (path != heatPath)
+    {
+        flushHeat();
+        heatPath = path;
+        heat.reset(game.boardWidth(), game.boardHeight());
+    }
+    if (!heatPath.isEmpty())
+        heat.visit(game.headY() * game.boardWidth() + game.headX());
+}
+
+// Fin de partie ou arrêt : le thread ne joue aucun pas pendant l'écriture
+void SimThread::flushHeat()
+{
+    if (!heatPath.isEmpty())
+        heat.flushTo(heatPath);
+}
+
+// Les vecteurs de chaque tampon gardent leur capacité d'un pas à l'autre :
+// en régime établi, publier n'alloue rien
+void fillSnapshot(SimSnapshot &s, const Game &game)
+{
+    s.tick = game.tickCount();
+    s.boardW = game.boardWidth();
+    s.boardH = game.boardHeight();
+    s.walls = game.wallGrid();
+    s.map = game.mapFile();
+
+    s.snake.resize(game.getLength());
+    int k = 0;
+    for (PackedBody::Cursor c = game.snakeBody().cursor(); c.valid(); c.next())
+        s.snake[k++] = c.cell();
+    s.direction = game.getDirection();
+
+    s.foods.resize(game.foodCount());
+    for (int i = 0; i < s.foods.size(); ++i)
+        s.foods[i] = {game.foodX(i), game.foodY(i), game.foodType(i), game.foodTicksLeft(i)};
+    const HazardField &field = game.hazardField();
+    s.hazards.resize(field.count());
+    for (int i = 0; i < s.hazards.size(); ++i)
+        s.hazards[i] = {field.hazard(i).x, field.hazard(i).y, field.hazard(i).kind};
+
+    s.score = game.getScore();
+    s.length = game.getLength();
+    s.level = game.getLevel();
+    s.gameOver = game.isGameOver();
+    s.cause = game.deathCause();
+    s.ghost = game.isGhost();
+    s.speedTicksLeft = game.effectTicksLeft(EFFECT_SPEED);
+    s.ghostTicksLeft = game.effectTicksLeft(EFFECT_GHOST);
+}
+
+// L'enregistrement n'est transmis qu'une fois la partie finie : il n'est
+// plus modifié ensuite, le thread graphique peut le lire sans verrou
+void SimThread::publish()
+{
+    SimSnapshot &s = snapshots.writeBuffer();
+    fillSnapshot(s, game);
+    s.gameId = gameId;
+    s.timing = timing;
+    s.replay = game.isGameOver() ? recording : QSharedPointer<Replay>();
+
+    snapshots.publish();
+    emit snapshotReady();
+}
@@ -0,0 +1,198 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include <QThread>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QString>
+#include "game.h"
+#include "heatmap.h"
+#include "replay.h"
+#include "savegame.h"
+#include "spscqueue.h"
+#include "triplebuffer.h"
+
+// Réglages d'une partie solo, appliqués au lancement
+struct SimSettings
+{
+    int level = 1;
+    LayoutStyle layout = LAYOUT_SCATTER;
+    int foods = Game::FOOD_COUNT;
+    int hazards = 0;
+    QString mapPath;    // vide : pas de carte
+    int periodMs = 0;   // 0 : vitesse du jeu ; sinon période fixe (bancs d'essai)
+    QString heatMapDir; // vide : pas de carte de chaleur
+    LevelTable levels;  // vitesse et densité de chaque niveau
+    QString savePath;   // vide : pas de sauvegarde automatique
+};
+
+struct SimFood
+{
+    int x;
+    int y;
+    FruitType type;
+    int ticksLeft;   // -1 : objet permanent
+};
+
+struct SimHazard
+{
+    int x;
+    int y;
+    HazardKind kind;
+};
+
+// Régularité des pas : retard de chaque pas sur son échéance
+struct SimTiming
+{
+    quint64 ticks = 0;
+    qint64 totalLateNs = 0;
+    qint64 maxLateNs = 0;
+    quint64 lateTicks = 0;   // plus d'une milliseconde de retard
+};
+
+// État complet d'un pas, tout ce que l'affichage lit. Les murs sont une
+// copie implicite de la grille du jeu (elle ne change qu'au lancement) :
+// la recopier à chaque pas ne coûte qu'un compteur de références.
+struct SimSnapshot
+{
+    quint32 gameId = 0;    // 0 : aucune partie lancée
+    quint64 tick = 0;
+    int boardW = WIDTH;
+    int boardH = HEIGHT;
+    WallGrid walls;
+    QSharedPointer<MapFile> map;   // garde la projection lue par `walls`
+    QVector<int> snake;            // cases, tête d'abord
+    Direction direction = RIGHT;
+    QVector<SimFood> foods;
+    QVector<SimHazard> hazards;
+    int score = 0;
+    int length = 0;
+    int level = 1;
+    bool gameOver = false;
+    DeathCause cause = DEATH_NONE;
+    bool ghost = false;
+    int speedTicksLeft = 0;
+    int ghostTicksLeft = 0;
+    SimTiming timing;
+    QSharedPointer<const Replay> replay;   // partie finie : son enregistrement
+};
+
+// Copie l'état de `game` dans `s` (hors gameId, mesures et enregistrement)
+void fillSnapshot(SimSnapshot &s, const Game &game);
+
+// Fruit mangé, transmis à part pour qu'aucun ne se perde entre deux états
+struct SimEvent
+{
+    quint32 gameId;
+    int x;
+    int y;
+    int points;
+    FruitType type;
+};
+
+// Partie solo jouée sur son propre thread, cadencée par une horloge
+// monotone : le rendu (plein écran, redimensionnement) ne retarde plus
+// les pas. Le thread graphique envoie ses commandes par une file SPSC et
+// lit l'état du dernier pas dans un tampon triple, sans verrou ni attente
+// dans un sens comme dans l'autre.
+//
+// Toutes les méthodes publiques sont à appeler depuis le thread graphique.
+class SimThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit SimThread(QObject *parent = nullptr);
+    ~SimThread();
+
+    void startGame(const SimSettings &settings, quint32 gameId);
+    // Partie sauvegardée reprise en pause ; une sauvegarde illisible donne
+    // une nouvelle partie aux mêmes réglages
+    void restoreGame(const SimSettings &settings, const QSharedPointer<const SaveGame> &save,
+                     quint32 gameId);
+    void pauseGame() { send(CMD_PAUSE); }
+    void resumeGame() { send(CMD_RESUME); }
+    void stopGame() { send(CMD_STOP); }
+    void changeDirection(Direction dir) { send(CMD_DIRECTION, dir); }
+    // Sauvegarde de la partie en cours, avec l'état de l'affichage
+    void saveGame(const QByteArray &screen);
+    // Traite les commandes déjà envoyées, écrit la dernière sauvegarde et
+    // arrête le thread (fermeture de l'application)
+    void shutdown();
+
+    // Prend le dernier état publié ; snapshot() reste stable jusqu'à l'appel suivant
+    bool updateSnapshot() { return snapshots.update(); }
+    const SimSnapshot &snapshot() const { return snapshots.readBuffer(); }
+    bool nextEvent(SimEvent &event) { return events.pop(event); }
+
+signals:
+    // Émis par le thread de jeu après chaque publication
+    void snapshotReady();
+
+protected:
+    void run() override;
+
+private:
+    enum CommandType
+    {
+        CMD_START,
+        CMD_RESTORE,
+        CMD_SAVE,
+        CMD_PAUSE,
+        CMD_RESUME,
+        CMD_STOP,
+        CMD_DIRECTION,
+        CMD_QUIT
+    };
+
+    struct Command
+    {
+        CommandType type;
+        int arg;
+        SimSettings settings;   // CMD_START, CMD_RESTORE
+        QSharedPointer<const SaveGame> save;   // CMD_RESTORE
+        QByteArray screen;      // CMD_SAVE
+    };
+
+    // Attente d'un pas : sommeil interruptible par les commandes jusqu'à
+    // WAKE_US avant l'échéance (le réveil du sémaphore est imprécis), sommeil
+    // court jusqu'à SPIN_US avant, puis boucle active
+    static constexpr int WAKE_US = 2000;
+    static constexpr int SPIN_US = 200;
+    // Sauvegarde automatique en cours de partie, en plus de la pause et du
+    // retour au menu
+    static constexpr int AUTOSAVE_MS = 5000;
+
+    SpscQueue<Command, 64> commands;
+    SpscQueue<SimEvent, 256> events;
+    TripleBuffer<SimSnapshot> snapshots;
+    QSemaphore wake;
+
+    // Propres au thread de jeu
+    Game game;
+    quint32 gameId;
+    QString mapPath;
+    int periodMs;
+    bool running;
+    bool quitting;
+    SimTiming timing;
+    QSharedPointer<Replay> recording;   // figé une fois publié
+    HeatMap heat;                       // depuis la dernière écriture
+    QString heatPath;                   // vide : pas de carte de chaleur
+    SaveWriter saves;
+    QString savePath;                   // vide : pas de sauvegarde
+    qint64 lastSaveNs;
+
+    void send(CommandType type, int arg = 0);
+    void push(const Command &cmd);
+    void drainCommands(qint64 nowNs, qint64 &deadlineNs);
+    void configure(const SimSettings &settings);
+    void newGame(const SimSettings &settings);
+    void writeSave(const QByteArray &screen, qint64 nowNs);
+    int period() const { return periodMs > 0 ? periodMs : game.getSpeed(); }
+    void publish();
+    void startHeat(const QString &directory);
+    void flushHeat();
+};
+
+#endif // SIMTHREAD_H
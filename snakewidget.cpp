@@ -1,23 +1,60 @@
 #include "snakewidget.h"
+#include "heatmap.h"
+#include "mapfile.h"
 #include <QPainter>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
 #include <QKeyEvent>
 #include <QTime>
 #include <QResizeEvent>
+#include <QStandardPaths>
 #include <QRadialGradient>
 #include <QLinearGradient>
 #include <QPainterPath>
+#include <QFontMetrics>
+#include <QtMath>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QtConcurrent>
 #include <cmath>
+#include <algorithm>
 
 SnakeWidget::SnakeWidget(QWidget *parent)
     : QWidget(parent),
+    sceneMode(false),
+    gameId(0),
+    gameOverShown(false),
+    showTiming(false),
+    lastPaintNs(0),
+    arenaMode(false),
+    turboFactor(1),
+    turboDebt(0.0),
+    turboTicks(0),
+    ticksPerSecond(0.0),
+    autopilot(false),
     cellSize(25),
     isFullscreen(false),
     bestScore(0),
     waitingStart(true),
     lastScore(0),
-    isPaused(false)
+    isPaused(false),
+    framePainted(false),
+    restartButton(nullptr),
+    menuButton(nullptr),
+    pauseResumeButton(nullptr),
+    pauseRestartButton(nullptr),
+    pauseMenuButton(nullptr),
+    atlasCellSize(0),
+    tiledRendering(true),
+    tileCols(0),
+    tileRows(0),
+    tileCellSize(0),
+    tileDetail(DETAIL_FULL),
+    tileDpr(1.0),
+    heatMode(HEAT_OFF)
 {
     setFocusPolicy(Qt::StrongFocus);
     int preferredWidth = WIDTH * cellSize;
@@ -26,13 +63,41 @@ SnakeWidget::SnakeWidget(QWidget *parent)
     resize(preferredWidth, preferredHeight);
     connect(&timer, &QTimer::timeout, this, &SnakeWidget::gameLoop);
 
+    // Ne tourne que tant qu'un gain de points reste affiché
     connect(&popupTimer, &QTimer::timeout, this, &SnakeWidget::updateScorePopups);
-    popupTimer.start(30);
 
-    game.reset();
     timer.stop();
 
-    connect(&game, &Game::fruitEaten, this, &SnakeWidget::onFruitEaten);
+    // Pas du mode solo : thread de jeu, un état publié par pas
+    connect(&sim, &SimThread::snapshotReady, this, &SnakeWidget::onSnapshotReady);
+    sim.start(QThread::HighPriority);
+
+    setupHudTexts();
+
+    // Cartes de chaleur cumulées par le thread de jeu, une par configuration
+    settings.heatMapDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                          + "/heatmaps";
+    QDir().mkpath(settings.heatMapDir);
+    settings.savePath = autosavePath();
+
+    // Classement persistant : le meilleur score survit à la fermeture
+    leaderboard.open();
+    bestScore = leaderboard.best(settings.level);
+    // En turbo, des centaines de gains par image : aucun n'est affiché
+    connect(&arena, &Arena::fruitEaten, this,
+            [this](int snakeId, int x, int y, int points, FruitType type) {
+                Q_UNUSED(snakeId);
+                if (turboFactor == 1)
+                    onFruitEaten(x, y, points, type);
+            });
+}
+
+// Boutons de fin de partie et de pause, créés à leur premier affichage
+// ou par warmUp() : leurs feuilles de style coûtent cher à appliquer
+void SnakeWidget::createButtons()
+{
+    if (restartButton)
+        return;
 
     // BOUTONS GAME OVER
     restartButton = new QPushButton("REJOUER", this);
@@ -57,8 +122,6 @@ SnakeWidget::SnakeWidget(QWidget *parent)
     connect(restartButton, &QPushButton::clicked, this, &SnakeWidget::onRestartClicked);
     connect(menuButton, &QPushButton::clicked, this, &SnakeWidget::onMenuClicked);
 
-    hideGameOverButtons();
-
     // BOUTONS PAUSE
     pauseResumeButton = new QPushButton("REPRENDRE", this);
     pauseRestartButton = new QPushButton("RECOMMENCER", this);
@@ -88,12 +151,204 @@ SnakeWidget::SnakeWidget(QWidget *parent)
     connect(pauseRestartButton, &QPushButton::clicked, this, &SnakeWidget::onPauseRestartClicked);
     connect(pauseMenuButton, &QPushButton::clicked, this, &SnakeWidget::onPauseMenuClicked);
 
+    hideGameOverButtons();
     hidePauseButtons();
 }
 
+// Travail repoussé après la première image du menu : boutons stylés,
+// atlas des fruits
+void SnakeWidget::warmUp()
+{
+    createButtons();
+    for (QPushButton *button : {restartButton, menuButton, pauseResumeButton,
+                                pauseRestartButton, pauseMenuButton})
+        button->ensurePolished();
+    if (atlasCellSize != cellSize)
+        buildFruitAtlas();
+}
+
+// Scène figée : plus aucun état du thread de jeu n'est lu, la taille de
+// case est imposée et le widget prend juste la taille du plateau
+void SnakeWidget::showScene(const RenderScene &scene)
+{
+    sceneMode = true;
+    frozenState = scene.state;
+    gameId = scene.state.gameId;
+    gameOverShown = true;
+    arenaMode = false;
+    waitingStart = false;
+    isPaused = scene.paused;
+    bestScore = scene.bestScore;
+    scorePopups = scene.popups;
+    cellSize = scene.cellSize;
+
+    int w = qMax(frozenState.boardW * cellSize, 800);
+    int h = (frozenState.boardH + 3) * cellSize + 120;
+    setMinimumSize(w, h);
+    resize(w, h);
+
+    // Boutons posés comme en jeu : render() les dessine aussi
+    if (isOver())
+        setupGameOverButtons();
+    else
+        hideGameOverButtons();
+    if (isPaused)
+        setupPauseButtons();
+    else
+        hidePauseButtons();
+}
+
+void SnakeWidget::setupHudTexts()
+{
+    QFont hudFont("Consolas", 16, QFont::Bold);
+    QFont smallFont("Consolas", 10);
+    QFont lineFont("Consolas", 14);
+    hud.score = HudText(hudFont, "Score : %1");
+    hud.length = HudText(hudFont, "Longueur : %1");
+    hud.best = HudText(hudFont, "Best : %1");
+    hud.level = HudText(hudFont);
+    hud.levelShown = -1;
+    hud.help = HudText(smallFont);
+    hud.help.setText("P : pause | H : chaleur | F3 : mesures | F11 : plein ecran | ESC : menu | Fleches : direction");
+    hud.speedEffect = HudText(smallFont, "ECLAIR %1");
+    hud.ghostEffect = HudText(smallFont, "FANTOME %1");
+
+    hud.arenaScores = QVector<HudText>(6, HudText(QFont("Consolas", 14, QFont::Bold)));
+    hud.arenaScoreIds.fill(-1, hud.arenaScores.size());
+    hud.alive = HudText(QFont("Consolas", 14, QFont::Bold), "Vivants : %1/%2");
+    hud.arenaHelp = HudText(smallFont);
+    hud.arenaHelp.setText("J1 : fleches | J2 : ZQSD | P : pause | T : turbo | B : pilote auto | F11 : plein ecran | ESC : menu");
+    hud.turbo = HudText(QFont("Consolas", 14, QFont::Bold), "TURBO x%1 : %2 pas/s");
+    hud.turboMax = HudText(QFont("Consolas", 14, QFont::Bold), "TURBO max : %1 pas/s");
+
+    hud.pauseTitle = HudText(QFont("Consolas", 48, QFont::Bold));
+    hud.pauseTitle.setText("PAUSE");
+    hud.pauseScore = HudText(QFont("Consolas", 20), "Score : %1");
+    hud.pauseHint = HudText(QFont("Consolas", 12));
+    hud.pauseHint.setText("Appuie sur P pour reprendre");
+
+    hud.overTitle = HudText(QFont("Consolas", 42, QFont::Bold));
+    hud.overTitle.setText("GAME OVER");
+    hud.winner = HudText(QFont("Consolas", 22, QFont::Bold));
+    hud.winnerId = -2;
+    hud.record = HudText(QFont("Consolas", 18, QFont::Bold));
+    hud.record.setText("NOUVEAU RECORD !");
+    hud.finalScore = HudText(QFont("Consolas", 22), "Score final : %1");
+    hud.cause = HudText(lineFont);
+    hud.cause.setText("Touche par un danger");
+    hud.unrankedFrenzy = HudText(lineFont, "Frenesie (%1 fruits) : partie non classee");
+    hud.unrankedHazards = HudText(lineFont, "Dangers (%1) : partie non classee");
+    hud.bestLine = HudText(QFont("Consolas", 18), "Meilleur score : %1");
+    hud.rank = HudText(lineFont);
+
+    hud.startTitle = HudText(QFont("Consolas", 28, QFont::Bold));
+    hud.startTitle.setText("SNAKE PRO");
+    hud.startPrompt = HudText(QFont("Consolas", 16));
+    hud.startPrompt.setText("Appuie sur ENTRER pour commencer");
+    // Une ligne par objet du registre, dans sa couleur (voir paintEvent)
+    for (const ItemType &item : ITEM_TYPES)
+    {
+        QString name = QString::fromLatin1(item.name);
+        name[0] = name[0].toUpper();
+        hud.startFruits.append(HudText(QFont("Consolas", 12)));
+        hud.startFruits.last().setText(QString("%1 = %2 pts").arg(name).arg(item.points));
+    }
+
+    hud.timing = {HudText(smallFont, "Pas : %1"), HudText(smallFont, "Retard moyen : %1 ms"),
+                  HudText(smallFont, "Retard max : %1 ms"), HudText(smallFont, "> 1 ms : %1"),
+                  HudText(smallFont, "Rendu : %1 ms")};
+}
+
+int SnakeWidget::boardWidth() const
+{
+    return arenaMode ? arena.boardWidth() : view().boardW;
+}
+
+int SnakeWidget::boardHeight() const
+{
+    return arenaMode ? arena.boardHeight() : view().boardH;
+}
+
+void SnakeWidget::updateCellSize()
+{
+    if (sceneMode)
+        return;
+    // Plateau standard : cases de 25 px en fenêtre ; sinon le plateau tient dans le widget
+    if (isFullscreen || boardWidth() != WIDTH || boardHeight() != HEIGHT) {
+        cellSize = qMin(width() / boardWidth(), (height() - 50) / boardHeight());
+        if (cellSize < 5) cellSize = 5;
+    } else {
+        cellSize = 25;
+    }
+}
+
+// Vérifiée ici pour signaler l'erreur tout de suite ; le thread de jeu
+// rouvre la carte au lancement de la partie
+bool SnakeWidget::loadMap(const QString &path, QString *error)
+{
+    MapFile map;
+    if (!map.open(path))
+    {
+        if (error)
+            *error = map.errorString();
+        return false;
+    }
+    settings.mapPath = path;
+    return true;
+}
+
 void SnakeWidget::setLevel(int level)
 {
-    game.setLevel(level);
+    if (level >= 1 && level <= 3)
+        settings.level = level;
+    bestScore = leaderboard.best(settings.level);
+}
+
+void SnakeWidget::setLevelTable(const LevelTable &table)
+{
+    settings.levels = table;
+    arena.setLevelTable(table);
+}
+
+// Frénésie et dangers : scores hors classement
+bool SnakeWidget::isRanked() const
+{
+    return !arenaMode && view().foods.size() <= Game::FOOD_COUNT && view().hazards.isEmpty();
+}
+
+void SnakeWidget::recordGame()
+{
+    if (!isRanked())
+        return;
+    const SimSnapshot &s = view();
+    // Part des parties précédentes battues, affichée à l'écran de fin
+    double percentile = leaderboard.percentile(s.level, s.score);
+    leaderboard.record(s.level, s.score, s.length);
+    hud.rank.setText(QString("Mieux que %1 % des %2 parties precedentes")
+                         .arg(percentile, 0, 'f', 1)
+                         .arg(leaderboard.gameCount(s.level) - 1));
+}
+
+// Dernières parties solo, à rejouer ou exporter (snake_replay_export) ;
+// les noms commencent par la date, les plus anciens partent en premier
+void SnakeWidget::saveReplay()
+{
+    QSharedPointer<const Replay> replay = view().replay;
+    if (!replay)
+        return;
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/replays");
+    if (!dir.mkpath("."))
+        return;
+    QString name = QString("%1-%2.snkp")
+                       .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"))
+                       .arg(replay->finalScore);
+    QString error;
+    if (!replay->save(dir.filePath(name), &error))
+        qWarning() << "Partie non enregistree :" << error;
+
+    QStringList files = dir.entryList({"*.snkp"}, QDir::Files, QDir::Name);
+    for (int i = 0; i + REPLAYS_KEPT < files.size(); ++i)
+        dir.remove(files[i]);
 }
 
 QString SnakeWidget::getButtonStyle(const QString &color, const QString &hoverColor)
@@ -118,15 +373,16 @@ QString SnakeWidget::getButtonStyle(const QString &color, const QString &hoverCo
 
 void SnakeWidget::setupGameOverButtons()
 {
-    int gameWidth = WIDTH * cellSize;
-    int gameHeight = HEIGHT * cellSize;
+    int gameWidth = boardWidth() * cellSize;
+    int gameHeight = boardHeight() * cellSize;
     int offsetX = (width() - gameWidth) / 2;
-    int offsetY = (height() - (HEIGHT + 3) * cellSize) / 2;
+    int offsetY = (height() - (boardHeight() + 3) * cellSize) / 2;
     if (offsetY < 0) offsetY = 0;
 
     int centerX = offsetX + gameWidth / 2;
     int centerY = offsetY + gameHeight / 2;
 
+    createButtons();
     restartButton->move(centerX - 220, centerY + 120);
     menuButton->move(centerX + 20, centerY + 120);
 
@@ -137,21 +393,24 @@ void SnakeWidget::setupGameOverButtons()
 
 void SnakeWidget::hideGameOverButtons()
 {
+    if (!restartButton)
+        return;
     restartButton->hide();
     menuButton->hide();
 }
 
 void SnakeWidget::setupPauseButtons()
 {
-    int gameWidth = WIDTH * cellSize;
-    int gameHeight = HEIGHT * cellSize;
+    int gameWidth = boardWidth() * cellSize;
+    int gameHeight = boardHeight() * cellSize;
     int offsetX = (width() - gameWidth) / 2;
-    int offsetY = (height() - (HEIGHT + 3) * cellSize) / 2;
+    int offsetY = (height() - (boardHeight() + 3) * cellSize) / 2;
     if (offsetY < 0) offsetY = 0;
 
     int centerX = offsetX + gameWidth / 2;
     int centerY = offsetY + gameHeight / 2;
 
+    createButtons();
     pauseResumeButton->move(centerX - 125, centerY + 30);
     pauseRestartButton->move(centerX - 125, centerY + 100);
     pauseMenuButton->move(centerX - 125, centerY + 170);
@@ -164,19 +423,49 @@ void SnakeWidget::setupPauseButtons()
 
 void SnakeWidget::hidePauseButtons()
 {
+    if (!pauseResumeButton)
+        return;
     pauseResumeButton->hide();
     pauseRestartButton->hide();
     pauseMenuButton->hide();
 }
 
+bool SnakeWidget::isOver() const
+{
+    return arenaMode ? arena.isOver() : view().gameId == gameId && view().gameOver;
+}
+
+void SnakeWidget::restartCurrentMode()
+{
+    if (arenaMode)
+    {
+        arena.reset();
+        applyAutopilot();
+        turboClock.start();
+        timer.start(loopInterval());
+    }
+    else
+    {
+        startSolo();
+    }
+}
+
+// Les états d'une partie précédente encore en route sont ignorés
+void SnakeWidget::startSolo()
+{
+    gameOverShown = false;
+    sim.startGame(settings, ++gameId);
+    if (heatMode != HEAT_OFF)
+        loadHeatMap();
+}
+
 void SnakeWidget::onRestartClicked()
 {
     hideGameOverButtons();
     waitingStart = false;
     isPaused = false;
     scorePopups.clear();
-    game.reset();
-    timer.start(game.getSpeed());
+    restartCurrentMode();
     setFocus();
     update();
 }
@@ -184,7 +473,8 @@ void SnakeWidget::onRestartClicked()
 void SnakeWidget::onMenuClicked()
 {
     hideGameOverButtons();
-    timer.stop();
+    stopArenaLoop();
+    sim.stopGame();
     scorePopups.clear();
     emit backToMenu();
 }
@@ -200,8 +490,7 @@ void SnakeWidget::onPauseRestartClicked()
     isPaused = false;
     waitingStart = false;
     scorePopups.clear();
-    game.reset();
-    timer.start(game.getSpeed());
+    restartCurrentMode();
     setFocus();
     update();
 }
@@ -210,7 +499,8 @@ void SnakeWidget::onPauseMenuClicked()
 {
     hidePauseButtons();
     isPaused = false;
-    timer.stop();
+    stopArenaLoop();
+    sim.stopGame();
     scorePopups.clear();
     emit backToMenu();
 }
@@ -225,6 +515,8 @@ void SnakeWidget::onFruitEaten(int x, int y, int points, FruitType type)
     popup.offsetY = 0;
     popup.fruitType = type;
     scorePopups.append(popup);
+    if (!popupTimer.isActive())
+        popupTimer.start(30);
 }
 
 void SnakeWidget::updateScorePopups()
@@ -244,15 +536,37 @@ void SnakeWidget::updateScorePopups()
     {
         update();
     }
+    else
+    {
+        popupTimer.stop();
+        update();  // efface le dernier
+    }
 }
 
 void SnakeWidget::startGameDirectly()
 {
+    arenaMode = false;
+    waitingStart = false;
+    isPaused = false;
+    scorePopups.clear();
+    timer.stop();
+    startSolo();
+    update();
+}
+
+void SnakeWidget::startArena(int players, int bots)
+{
+    arenaMode = true;
     waitingStart = false;
     isPaused = false;
     scorePopups.clear();
-    game.reset();
-    timer.start(game.getSpeed());
+    sim.stopGame();
+    arena.setup(players, bots);
+    arena.setLevel(settings.level);
+    hud.arenaScoreIds.fill(-1);   // libellés J/B selon le nombre de joueurs
+    hud.winnerId = -2;
+    updateCellSize();
+    restartCurrentMode();
     update();
 }
 
@@ -264,37 +578,135 @@ void SnakeWidget::toggleFullscreen()
 
 void SnakeWidget::togglePause()
 {
-    if (waitingStart || game.isGameOver())
+    if (waitingStart || isOver())
         return;
 
     isPaused = !isPaused;
 
     if (isPaused)
     {
-        timer.stop();
+        if (arenaMode)
+        {
+            timer.stop();
+        }
+        else
+        {
+            sim.pauseGame();
+            sim.saveGame(screenState());
+        }
         setupPauseButtons();
     }
     else
     {
         hidePauseButtons();
-        timer.start(game.getSpeed());
+        if (arenaMode)
+        {
+            turboClock.start();   // la pause ne compte pas dans les pas dus
+            timer.start(loopInterval());
+        }
+        else
+        {
+            sim.resumeGame();
+        }
         setFocus();
     }
 
     update();
 }
 
+QString SnakeWidget::autosavePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/autosave.snks";
+}
+
+// Partie solo en cours mise en pause et sauvegardée (retour au menu,
+// fermeture) ; l'écriture se fait hors du thread graphique
+void SnakeWidget::suspendSolo()
+{
+    if (sceneMode || arenaMode || waitingStart || gameId == 0 || isOver())
+        return;
+    sim.pauseGame();
+    sim.saveGame(screenState());
+}
+
+void SnakeWidget::shutdown()
+{
+    suspendSolo();
+    sim.shutdown();
+}
+
+// Une partie reprise attend toujours le joueur, en pause : la sauvegarde
+// n'a pas à garder cet état. Ses réglages remplacent ceux du menu, pour
+// que RECOMMENCER rejoue la même configuration.
+bool SnakeWidget::resumeSavedGame()
+{
+    if (!QFile::exists(settings.savePath))
+        return false;
+    QSharedPointer<SaveGame> save = QSharedPointer<SaveGame>::create();
+    QString error;
+    if (!save->load(settings.savePath, &error))
+    {
+        qWarning() << "Sauvegarde ignoree :" << error;
+        return false;
+    }
+    const Replay &recording = save->recording;
+    setLevel(recording.level);
+    settings.layout = recording.layout;
+    settings.foods = recording.foods;
+    settings.hazards = recording.hazards;
+    settings.mapPath = recording.mapPath;
+
+    arenaMode = false;
+    waitingStart = false;
+    timer.stop();
+    hideGameOverButtons();
+    gameOverShown = false;
+    sim.restoreGame(settings, save, ++gameId);
+    restoreScreen(save->screen);
+    isPaused = true;
+    setupPauseButtons();
+    if (heatMode != HEAT_OFF)
+        loadHeatMap();
+    update();
+    return true;
+}
+
+// Gains de points encore affichés, repris là où ils en étaient
+QByteArray SnakeWidget::screenState() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << qint32(scorePopups.size());
+    for (const ScorePopup &popup : scorePopups)
+        out << qint32(popup.x) << qint32(popup.y) << qint32(popup.points) << qint32(popup.alpha)
+            << qint32(popup.offsetY) << qint32(popup.fruitType);
+    return data;
+}
+
+void SnakeWidget::restoreScreen(const QByteArray &data)
+{
+    scorePopups.clear();
+    QDataStream in(data);
+    qint32 count = 0;
+    in >> count;
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        qint32 x, y, points, alpha, offsetY, type;
+        in >> x >> y >> points >> alpha >> offsetY >> type;
+        if (in.status() != QDataStream::Ok || type < 0 || type >= FRUIT_TYPE_COUNT)
+            break;
+        scorePopups.append({x, y, points, alpha, offsetY, static_cast<FruitType>(type)});
+    }
+    if (!scorePopups.isEmpty())
+        popupTimer.start(30);
+}
+
 void SnakeWidget::resizeEvent(QResizeEvent *event)
 {
     QWidget::resizeEvent(event);
-    if (isFullscreen) {
-        cellSize = qMin(width() / WIDTH, (height() - 50) / HEIGHT);
-        if (cellSize < 5) cellSize = 5;
-    } else {
-        cellSize = 25;
-    }
+    updateCellSize();
 
-    if (game.isGameOver()) {
+    if (isOver()) {
         setupGameOverButtons();
     }
 
@@ -303,8 +715,74 @@ void SnakeWidget::resizeEvent(QResizeEvent *event)
     }
 }
 
+SnakeWidget::DetailLevel SnakeWidget::detailLevel() const
+{
+    if (cellSize >= DETAIL_FULL_MIN)
+        return DETAIL_FULL;
+    return cellSize >= DETAIL_SIMPLE_MIN ? DETAIL_SIMPLE : DETAIL_PIXEL;
+}
+
+void SnakeWidget::drawSnake(QPainter &p, int offsetX, int offsetY, DetailLevel detail)
+{
+    const SimSnapshot &state = view();
+    int totalLength = static_cast<int>(state.snake.size());
+    if (totalLength == 0)
+        return;
+    if (state.ghost)
+        p.setOpacity(0.5);
+
+    outlineRects.clear();
+    for (int segmentIndex = 0; segmentIndex < totalLength; ++segmentIndex)
+    {
+        int cell = state.snake[segmentIndex];
+        QRect r(offsetX + (cell % state.boardW) * cellSize,
+                offsetY + (cell / state.boardW) * cellSize,
+                cellSize, cellSize);
+        bool isHead = (segmentIndex == 0);
+        float segmentRatio = static_cast<float>(segmentIndex) / totalLength;
+        if (detail == DETAIL_FULL)
+        {
+            drawSnakeSegment(p, r, isHead, segmentRatio, state.direction);
+        }
+        else
+        {
+            p.fillRect(r.adjusted(1, 1, -1, -1), segmentColor(isHead, segmentRatio, QColor()));
+            outlineRects.append(r.adjusted(1, 1, -2, -2));
+        }
+    }
+    drawOutlines(p, QColor(0, 90, 60));
+    p.setOpacity(1.0);
+}
+
+// Teinte unie d'un segment (niveaux réduits) : la couleur médiane du
+// dégradé du niveau complet, qui fonce de même vers la queue
+QColor SnakeWidget::segmentColor(bool isHead, float segmentRatio, const QColor &tint)
+{
+    if (isHead)
+        return tint.isValid() ? tint.lighter(115) : QColor(0, 235, 130);
+    if (tint.isValid())
+        return tint.darker(120 + static_cast<int>(segmentRatio * 60));
+    int green = 190 - static_cast<int>(segmentRatio * 70);
+    return QColor(0, green, green * 0.55);
+}
+
+// Tous les contours accumulés en un seul appel, sans anticrénelage
+void SnakeWidget::drawOutlines(QPainter &p, const QColor &color)
+{
+    if (outlineRects.isEmpty())
+        return;
+    p.save();
+    p.setRenderHint(QPainter::Antialiasing, false);
+    p.setBrush(Qt::NoBrush);
+    p.setPen(QPen(color, 1));
+    p.drawRects(outlineRects.constData(), static_cast<int>(outlineRects.size()));
+    p.restore();
+    outlineRects.clear();
+}
+
 void SnakeWidget::drawSnakeSegment(QPainter &p, const QRect &rect, bool isHead,
-                                   float segmentRatio, Direction dir)
+                                   float segmentRatio, Direction dir,
+                                   const QColor &tint)
 {
     QRect shadowRect = rect.adjusted(3, 3, 3, 3);
     p.setBrush(QColor(0, 0, 0, 40));
@@ -313,16 +791,29 @@ void SnakeWidget::drawSnakeSegment(QPainter &p, const QRect &rect, bool isHead,
 
     if (isHead)
     {
+        // Sans teinte : le vert d'origine du serpent solo
+        QColor light(0, 255, 140), mid(0, 220, 120), dark(0, 180, 100);
+        QColor border(0, 150, 90), shine(100, 255, 200, 100);
+        if (tint.isValid())
+        {
+            light = tint.lighter(125);
+            mid = tint;
+            dark = tint.darker(125);
+            border = tint.darker(150);
+            shine = tint.lighter(160);
+            shine.setAlpha(100);
+        }
+
         QRadialGradient gradient(rect.center(), cellSize * 0.6);
-        gradient.setColorAt(0, QColor(0, 255, 140));
-        gradient.setColorAt(0.7, QColor(0, 220, 120));
-        gradient.setColorAt(1, QColor(0, 180, 100));
+        gradient.setColorAt(0, light);
+        gradient.setColorAt(0.7, mid);
+        gradient.setColorAt(1, dark);
         p.setBrush(gradient);
-        p.setPen(QPen(QColor(0, 150, 90), 2));
+        p.setPen(QPen(border, 2));
         p.drawRoundedRect(rect.adjusted(1, 1, -1, -1), 8, 8);
 
         p.setBrush(Qt::NoBrush);
-        p.setPen(QPen(QColor(100, 255, 200, 100), 1));
+        p.setPen(QPen(shine, 1));
         p.drawRoundedRect(rect.adjusted(3, 3, -3, -3), 6, 6);
 
         int eyeSize = cellSize / 6;
@@ -370,17 +861,34 @@ void SnakeWidget::drawSnakeSegment(QPainter &p, const QRect &rect, bool isHead,
         int baseGreen = 220 - (segmentRatio * 80);
         int darkGreen = 140 - (segmentRatio * 60);
 
+        QColor start(0, baseGreen, baseGreen * 0.55);
+        QColor mid(0, darkGreen, darkGreen * 0.55);
+        QColor end(0, baseGreen - 20, (baseGreen - 20) * 0.55);
+        QColor border(0, darkGreen - 20, (darkGreen - 20) * 0.5);
+        QColor scales(0, baseGreen + 20, (baseGreen + 20) * 0.6, 60);
+        if (tint.isValid())
+        {
+            // Le corps fonce vers la queue, comme le vert d'origine
+            int fade = 100 + static_cast<int>(segmentRatio * 60);
+            start = tint.darker(fade);
+            mid = tint.darker(fade + 40);
+            end = tint.darker(fade + 10);
+            border = tint.darker(fade + 70);
+            scales = tint.lighter(130);
+            scales.setAlpha(60);
+        }
+
         QLinearGradient gradient(rect.topLeft(), rect.bottomRight());
-        gradient.setColorAt(0, QColor(0, baseGreen, baseGreen * 0.55));
-        gradient.setColorAt(0.5, QColor(0, darkGreen, darkGreen * 0.55));
-        gradient.setColorAt(1, QColor(0, baseGreen - 20, (baseGreen - 20) * 0.55));
+        gradient.setColorAt(0, start);
+        gradient.setColorAt(0.5, mid);
+        gradient.setColorAt(1, end);
 
         p.setBrush(gradient);
-        p.setPen(QPen(QColor(0, darkGreen - 20, (darkGreen - 20) * 0.5), 1.5));
+        p.setPen(QPen(border, 1.5));
         p.drawRoundedRect(rect.adjusted(2, 2, -2, -2), 5, 5);
 
         p.setBrush(Qt::NoBrush);
-        p.setPen(QPen(QColor(0, baseGreen + 20, (baseGreen + 20) * 0.6, 60), 1));
+        p.setPen(QPen(scales, 1));
         int scaleSize = cellSize / 3;
         for (int sx = 0; sx < 2; ++sx)
         {
@@ -402,398 +910,1043 @@ void SnakeWidget::drawSnakeSegment(QPainter &p, const QRect &rect, bool isHead,
     }
 }
 
-void SnakeWidget::drawFruit(QPainter &p, const QRect &rect, FruitType type)
+// ============= MUR DE BÉTON GRIS 🏗️ - CLAIR ET VISIBLE =============
+// Niveau simplifié : aplat gris et contour, tout le plateau en deux appels
+void SnakeWidget::drawWalls(QPainter &p, int offsetX, int offsetY, DetailLevel detail)
 {
-    QPoint center = rect.center();
+    if (detail == DETAIL_PIXEL)
+        return;  // dans drawPixelLayer
+
+    outlineRects.clear();
+    auto wallAt = [&](int x, int y) {
+        QRect r(offsetX + x * cellSize, offsetY + y * cellSize, cellSize, cellSize);
+        if (detail == DETAIL_FULL)
+            drawWall(p, r);
+        else
+            outlineRects.append(r.adjusted(0, 0, -1, -1));
+    };
 
-    switch (type)
+    if (arenaMode)
     {
-    case APPLE:
+        for (const Obstacle &o : arena.getObstacles())
+            wallAt(o.x, o.y);
+    }
+    else
     {
-        QRadialGradient appleGrad(center, cellSize * 0.6);
-        appleGrad.setColorAt(0, QColor(255, 80, 80));
-        appleGrad.setColorAt(0.6, QColor(220, 30, 30));
-        appleGrad.setColorAt(1, QColor(180, 20, 20));
-        p.setBrush(appleGrad);
-        p.setPen(QPen(QColor(200, 40, 40), 2));
-        p.drawEllipse(rect.adjusted(2, 2, -2, -2));
-
-        p.setBrush(QColor(255, 255, 255, 150));
-        p.setPen(Qt::NoPen);
-        p.drawEllipse(center.x() - cellSize/4, center.y() - cellSize/3,
-                      cellSize/3, cellSize/3);
-
-        p.setPen(QPen(QColor(100, 60, 20), 2));
-        p.drawLine(center.x(), center.y() - cellSize/3,
-                   center.x(), center.y() - cellSize/2);
-
-        p.setBrush(QColor(50, 150, 50));
-        p.setPen(Qt::NoPen);
-        QPoint leaf[3] = {
-            QPoint(center.x(), center.y() - cellSize/2),
-            QPoint(center.x() + cellSize/5, center.y() - cellSize/2.5),
-            QPoint(center.x() + cellSize/6, center.y() - cellSize/3)
-        };
-        p.drawPolygon(leaf, 3);
+        // Grille de collision lue octet par octet : 8 cases vides sautées d'un coup
+        const WallGrid &walls = view().walls;
+        for (int y = 0; y < walls.height(); ++y)
+        {
+            const uchar *row = walls.row(y);
+            for (int x = 0; x < walls.width(); ++x)
+            {
+                if ((x & 7) == 0 && !row[x >> 3])
+                {
+                    x += 7;
+                    continue;
+                }
+                if (walls.isWall(x, y))
+                    wallAt(x, y);
+            }
+        }
     }
-    break;
-
-    case BANANA:
-    {
-        QPainterPath bananaBody;
-        bananaBody.moveTo(center.x() - cellSize/3, center.y() + cellSize/5);
-        bananaBody.cubicTo(
-            center.x() - cellSize/2.5, center.y() - cellSize/8,
-            center.x() - cellSize/6, center.y() - cellSize/2.5,
-            center.x() + cellSize/4, center.y() - cellSize/3
-            );
-        bananaBody.lineTo(center.x() + cellSize/3, center.y() - cellSize/4);
-        bananaBody.cubicTo(
-            center.x() + cellSize/5, center.y() - cellSize/2.2,
-            center.x() - cellSize/8, center.y() - cellSize/6,
-            center.x() - cellSize/3.5, center.y() + cellSize/4
-            );
-        bananaBody.closeSubpath();
-
-        QLinearGradient bananaGrad(
-            center.x() - cellSize/3, center.y(),
-            center.x() + cellSize/3, center.y()
-            );
-        bananaGrad.setColorAt(0, QColor(240, 210, 70));
-        bananaGrad.setColorAt(0.3, QColor(255, 235, 100));
-        bananaGrad.setColorAt(0.5, QColor(255, 245, 120));
-        bananaGrad.setColorAt(0.7, QColor(255, 230, 80));
-        bananaGrad.setColorAt(1, QColor(230, 195, 50));
-        p.setBrush(bananaGrad);
-        p.setPen(Qt::NoPen);
-        p.drawPath(bananaBody);
 
-        p.setBrush(Qt::NoBrush);
-        p.setPen(QPen(QColor(180, 140, 30), 2));
-        p.drawPath(bananaBody);
-    }
-    break;
+    if (outlineRects.isEmpty())
+        return;
+    p.save();
+    p.setRenderHint(QPainter::Antialiasing, false);
+    p.setBrush(QColor(115, 115, 115));
+    p.setPen(QPen(QColor(60, 60, 60), 1));
+    p.drawRects(outlineRects.constData(), static_cast<int>(outlineRects.size()));
+    p.restore();
+    outlineRects.clear();
+}
 
-    case PINEAPPLE:
+// Niveau pixel : murs, dangers et serpents écrits directement dans une
+// image d'un pixel par case, agrandie sans lissage sur le plateau. Le
+// coût ne dépend plus de la taille des cases, et chaque case ne coûte
+// qu'une écriture mémoire.
+void SnakeWidget::drawPixelLayer(QPainter &p, const QRect &gameRect)
+{
+    int w = boardWidth();
+    int h = boardHeight();
+    if (pixelLayer.width() != w || pixelLayer.height() != h)
+        pixelLayer = QImage(w, h, QImage::Format_ARGB32_Premultiplied);
+    pixelLayer.fill(Qt::transparent);
+    auto put = [this](int x, int y, QRgb color) {
+        reinterpret_cast<QRgb *>(pixelLayer.scanLine(y))[x] = color;
+    };
+
+    QRgb wall = qRgb(115, 115, 115);
+    if (arenaMode)
     {
-        QLinearGradient pineGrad(rect.topLeft(), rect.bottomRight());
-        pineGrad.setColorAt(0, QColor(255, 200, 50));
-        pineGrad.setColorAt(0.5, QColor(240, 160, 0));
-        pineGrad.setColorAt(1, QColor(200, 120, 0));
-        p.setBrush(pineGrad);
-        p.setPen(QPen(QColor(180, 100, 0), 2));
-
-        QRect body = rect.adjusted(3, cellSize/4, -3, -2);
-        p.drawEllipse(body);
-
-        p.setPen(QPen(QColor(150, 80, 0), 1));
-        for (int y = 0; y < 3; ++y)
+        for (const Obstacle &o : arena.getObstacles())
+            put(o.x, o.y, wall);
+        for (int id = 0; id < arena.snakeCount(); ++id)
         {
-            for (int x = 0; x < 2; ++x)
+            const ArenaSnake &s = arena.snake(id);
+            if (!s.alive)
+                continue;
+            QColor tint = snakeTint(id);
+            for (int i = s.length - 1; i >= 0; --i)
             {
-                int px = center.x() - cellSize/5 + x * cellSize/2.5;
-                int py = center.y() - cellSize/6 + y * cellSize/4;
-                p.drawLine(px - cellSize/8, py, px, py - cellSize/8);
-                p.drawLine(px, py - cellSize/8, px + cellSize/8, py);
-                p.drawLine(px + cellSize/8, py, px, py + cellSize/8);
-                p.drawLine(px, py + cellSize/8, px - cellSize/8, py);
+                int cell = s.segmentCell(i);
+                float segmentRatio = static_cast<float>(i) / s.length;
+                put(arena.cellX(cell), arena.cellY(cell),
+                    segmentColor(i == 0, segmentRatio, tint).rgb());
             }
         }
+    }
+    else
+    {
+        const SimSnapshot &state = view();
+        const WallGrid &walls = state.walls;
+        for (int y = 0; y < walls.height(); ++y)
+        {
+            const uchar *row = walls.row(y);
+            for (int x = 0; x < walls.width(); ++x)
+            {
+                if ((x & 7) == 0 && !row[x >> 3])
+                {
+                    x += 7;
+                    continue;
+                }
+                if (walls.isWall(x, y))
+                    put(x, y, wall);
+            }
+        }
+        for (const SimHazard &hz : state.hazards)
+            put(hz.x, hz.y, hz.kind == HAZARD_PATROL ? qRgb(255, 110, 30) : qRgb(170, 60, 220));
 
-        p.setBrush(QColor(50, 180, 50));
-        p.setPen(QPen(QColor(30, 140, 30), 2));
-        for (int i = 0; i < 5; ++i)
+        // Fantôme : serpent à moitié transparent, comme aux autres niveaux
+        int totalLength = static_cast<int>(state.snake.size());
+        int alpha = state.ghost ? 128 : 255;
+        for (int i = totalLength - 1; i >= 0; --i)
         {
-            int angle = -60 + i * 30;
-            float rad = angle * 3.14159 / 180.0;
-            int x1 = center.x();
-            int y1 = rect.top() + cellSize/4;
-            int x2 = x1 + qSin(rad) * cellSize/2;
-            int y2 = y1 - qCos(rad) * cellSize/2.5;
-            QPoint leaf[3] = {
-                QPoint(x1, y1),
-                QPoint(x2, y2),
-                QPoint(x1 + qSin(rad) * cellSize/4, y1 - cellSize/6)
-            };
-            p.drawPolygon(leaf, 3);
+            int cell = state.snake[i];
+            QColor c = segmentColor(i == 0, static_cast<float>(i) / totalLength, QColor());
+            put(cell % state.boardW, cell / state.boardW,
+                qPremultiply(qRgba(c.red(), c.green(), c.blue(), alpha)));
         }
     }
-    break;
+
+    p.save();
+    p.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    p.drawImage(gameRect, pixelLayer);
+    p.restore();
+}
+
+// Couleurs de la carte de chaleur, de la valeur nulle (transparente) au
+// maximum, prémultipliées : l'image se pose telle quelle
+static QVector<QRgb> heatRamp(bool deaths)
+{
+    QVector<QRgb> ramp(256);
+    for (int i = 0; i < 256; ++i)
+    {
+        double t = i / 255.0;
+        // Passages : du bleu au rouge ; morts : du magenta au blanc
+        QColor c = deaths ? QColor::fromHsv(300, 255 - int(195 * t), 255)
+                          : QColor::fromHsv(int(240 * (1.0 - t)), 255, 255);
+        int alpha = i == 0 ? 0 : 60 + int(150 * t);
+        ramp[i] = qPremultiply(qRgba(c.red(), c.green(), c.blue(), alpha));
     }
+    return ramp;
 }
 
-void SnakeWidget::paintEvent(QPaintEvent *event)
+// Relue à l'activation, au lancement et à chaque fin de partie (le thread
+// de jeu écrit le fichier juste avant) ; échelle logarithmique, quelques
+// cases concentrent la plupart des passages
+void SnakeWidget::loadHeatMap()
 {
-    Q_UNUSED(event);
-    QPainter p(this);
-    p.setRenderHint(QPainter::Antialiasing, true);
-    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    heatImage = QImage();
+    HeatMap heat;
+    QString path = settings.heatMapDir + "/"
+                   + HeatMap::fileName(settings.mapPath, settings.layout, settings.level,
+                                       boardWidth(), boardHeight());
+    if (heatMode == HEAT_OFF || !heat.load(path) || heat.width() != boardWidth()
+        || heat.height() != boardHeight())
+        return;
 
-    QLinearGradient bgGradient(0, 0, 0, height());
-    bgGradient.setColorAt(0, QColor(15, 15, 35));
-    bgGradient.setColorAt(1, QColor(10, 10, 25));
-    p.fillRect(rect(), bgGradient);
+    static const QVector<QRgb> visitRamp = heatRamp(false);
+    static const QVector<QRgb> deathRamp = heatRamp(true);
+    bool deaths = heatMode == HEAT_DEATHS;
+    const QVector<QRgb> &ramp = deaths ? deathRamp : visitRamp;
+    double scale = 255.0 / std::log1p(double(qMax<quint32>(1, deaths ? heat.maxDeaths()
+                                                                        : heat.maxVisits())));
+    heatImage = QImage(heat.width(), heat.height(), QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < heat.height(); ++y)
+    {
+        QRgb *line = reinterpret_cast<QRgb *>(heatImage.scanLine(y));
+        for (int x = 0; x < heat.width(); ++x)
+        {
+            int cell = y * heat.width() + x;
+            quint32 v = deaths ? heat.deathsAt(cell) : heat.visitsAt(cell);
+            line[x] = ramp[v ? qBound(1, int(std::log1p(double(v)) * scale), 255) : 0];
+        }
+    }
+}
 
-    int gameWidth = WIDTH * cellSize;
-    int gameHeight = HEIGHT * cellSize;
-    int offsetX = (width() - gameWidth) / 2;
-    int offsetY = (height() - (HEIGHT + 3) * cellSize) / 2;
-    if (offsetY < 0) offsetY = 0;
+// Une image d'un pixel par case agrandie sans lissage : un seul appel,
+// quelle que soit la taille du plateau
+void SnakeWidget::drawHeatMap(QPainter &p, const QRect &gameRect)
+{
+    if (heatImage.isNull())
+        return;
+    p.save();
+    p.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    p.drawImage(gameRect, heatImage);
+    p.restore();
+}
 
-    QRect gameRect(offsetX, offsetY, gameWidth, gameHeight);
+void SnakeWidget::drawWall(QPainter &p, const QRect &r)
+{
+    p.save();
+    p.setRenderHint(QPainter::Antialiasing);
+
+    // Ombre portée du mur
+    QRect shadowRect = r.adjusted(2, 2, 2, 2);
+    p.fillRect(shadowRect, QColor(0, 0, 0, 80));
+
+    // Fond du mur - Gradient gris
+    QLinearGradient wallGrad(r.topLeft(), r.bottomRight());
+    wallGrad.setColorAt(0.0, QColor(140, 140, 140));   // Gris clair
+    wallGrad.setColorAt(0.5, QColor(110, 110, 110));   // Gris moyen
+    wallGrad.setColorAt(1.0, QColor(90, 90, 90));      // Gris foncé
+
+    p.setBrush(wallGrad);
+    p.setPen(QPen(QColor(60, 60, 60), 3));  // Bordure très foncée
+    p.drawRect(r.adjusted(1, 1, -1, -1));
+
+    // Lignes de briques horizontales
+    int brickHeight = cellSize / 3;
+    p.setPen(QPen(QColor(50, 50, 50), 2));
+
+    // Ligne 1
+    p.drawLine(r.left() + 1, r.top() + brickHeight,
+               r.right() - 1, r.top() + brickHeight);
+
+    // Ligne 2
+    p.drawLine(r.left() + 1, r.top() + 2 * brickHeight,
+               r.right() - 1, r.top() + 2 * brickHeight);
+
+    // Lignes verticales alternées (joints de briques)
+    // Rangée 1
+    p.drawLine(r.left() + cellSize/2, r.top() + 1,
+               r.left() + cellSize/2, r.top() + brickHeight);
+
+    // Rangée 2
+    p.drawLine(r.left() + cellSize/4, r.top() + brickHeight,
+               r.left() + cellSize/4, r.top() + 2 * brickHeight);
+    p.drawLine(r.left() + 3*cellSize/4, r.top() + brickHeight,
+               r.left() + 3*cellSize/4, r.top() + 2 * brickHeight);
+
+    // Rangée 3
+    p.drawLine(r.left() + cellSize/2, r.top() + 2 * brickHeight,
+               r.left() + cellSize/2, r.bottom() - 1);
+
+    // Effet 3D - Lumière en haut à gauche
+    p.setPen(QPen(QColor(180, 180, 180, 150), 1));
+    p.drawLine(r.left() + 2, r.top() + 2, r.right() - 2, r.top() + 2);
+    p.drawLine(r.left() + 2, r.top() + 2, r.left() + 2, r.bottom() - 2);
+
+    // Effet 3D - Ombre en bas à droite
+    p.setPen(QPen(QColor(40, 40, 40, 150), 1));
+    p.drawLine(r.right() - 2, r.top() + 2, r.right() - 2, r.bottom() - 2);
+    p.drawLine(r.left() + 2, r.bottom() - 2, r.right() - 2, r.bottom() - 2);
+
+    // Texture béton (petites imperfections aléatoires)
+    p.setBrush(QColor(80, 80, 80, 60));
+    p.setPen(Qt::NoPen);
 
-    if (game.isGameOver())
-    {
-        p.fillRect(gameRect, QColor(15, 15, 30));
+    QPoint center = r.center();
+    p.drawEllipse(center.x() - cellSize/6, center.y() - cellSize/8, 3, 2);
+    p.drawEllipse(center.x() + cellSize/8, center.y() + cellSize/10, 2, 3);
+    p.drawEllipse(center.x() - cellSize/10, center.y() + cellSize/6, 2, 2);
 
-        p.setPen(QPen(QColor(0, 60, 60, 100), 1));
-        int gridSize = 30;
-        for (int x = 0; x < gameRect.width(); x += gridSize)
-            p.drawLine(gameRect.left() + x, gameRect.top(),
-                       gameRect.left() + x, gameRect.bottom());
-        for (int y = 0; y < gameRect.height(); y += gridSize)
-            p.drawLine(gameRect.left(), gameRect.top() + y,
-                       gameRect.right(), gameRect.top() + y);
+    p.restore();
+}
 
-        p.setPen(QPen(QColor(255, 50, 50), 4));
-        p.drawRect(gameRect.adjusted(5, 5, -5, -5));
+// Table de dessins indexée par ItemType::sprite : aucune branche par type
+void SnakeWidget::drawFruit(QPainter &p, const QRect &rect, FruitType type)
+{
+    typedef void (SnakeWidget::*SpritePainter)(QPainter &, const QRect &);
+    static const SpritePainter painters[SPRITE_COUNT] = {
+        &SnakeWidget::drawApple,
+        &SnakeWidget::drawBanana,
+        &SnakeWidget::drawPineapple,
+        &SnakeWidget::drawCherry,
+        &SnakeWidget::drawScissors,
+        &SnakeWidget::drawBolt,
+        &SnakeWidget::drawGhost
+    };
+    (this->*painters[itemType(type).sprite])(p, rect);
+}
 
-        int startY = gameRect.top() + 120;
+// Marge autour de chaque dessin de l'atlas (feuilles, tiges)
+static const int ATLAS_PAD = 2;
 
-        p.setPen(QColor(255, 100, 100));
-        p.setFont(QFont("Consolas", 42, QFont::Bold));
-        QRect titleRect(gameRect.left(), startY, gameRect.width(), 60);
-        p.drawText(titleRect, Qt::AlignCenter, "GAME OVER");
+void SnakeWidget::buildFruitAtlas()
+{
+    qreal dpr = devicePixelRatioF();
+    int stride = cellSize + 2 * ATLAS_PAD;
+    fruitAtlas = QPixmap(qCeil(FRUIT_TYPE_COUNT * stride * dpr), qCeil(stride * dpr));
+    fruitAtlas.setDevicePixelRatio(dpr);
+    fruitAtlas.fill(Qt::transparent);
+
+    QPainter ap(&fruitAtlas);
+    ap.setRenderHint(QPainter::Antialiasing, true);
+    for (int t = 0; t < FRUIT_TYPE_COUNT; ++t)
+        drawFruit(ap, QRect(t * stride + ATLAS_PAD, ATLAS_PAD, cellSize, cellSize),
+                  static_cast<FruitType>(t));
+    atlasCellSize = cellSize;
+    fruitAtlasImage = fruitAtlas.toImage();
+}
 
-        startY += 90;
+void SnakeWidget::ensureFruitAtlas()
+{
+    if (fruitAtlas.isNull() || atlasCellSize != cellSize ||
+        !qFuzzyCompare(fruitAtlas.devicePixelRatio(), devicePixelRatioF()))
+        buildFruitAtlas();
+}
 
-        bool isNewRecord = (game.getScore() >= bestScore && game.getScore() > 0);
+// Tous les fruits en un appel : un fragment de l'atlas par fruit, le
+// clignotement des objets éphémères passant par l'opacité du fragment
+void SnakeWidget::drawFoods(QPainter &p, int offsetX, int offsetY)
+{
+    ensureFruitAtlas();
+
+    qreal dpr = fruitAtlas.devicePixelRatio();
+    int stride = cellSize + 2 * ATLAS_PAD;
+    const QVector<SimFood> &foods = view().foods;
+    int nbFood = arenaMode ? arena.foodCount() : static_cast<int>(foods.size());
+    fruitFragments.clear();
+    for (int i = 0; i < nbFood; ++i)
+    {
+        int fx = arenaMode ? arena.foodX(i) : foods[i].x;
+        int fy = arenaMode ? arena.foodY(i) : foods[i].y;
+        if (fx < 0)
+            continue;
+        int type = arenaMode ? arena.foodType(i) : foods[i].type;
+        int left = arenaMode ? arena.foodTicksLeft(i) : foods[i].ticksLeft;
+        qreal opacity = (left >= 0 && left < 12 && (left & 1)) ? 0.35 : 1.0;
+        fruitFragments.append(QPainter::PixmapFragment::create(
+            QPointF(offsetX + (fx + 0.5) * cellSize, offsetY + (fy + 0.5) * cellSize),
+            QRectF((type * stride + ATLAS_PAD) * dpr, ATLAS_PAD * dpr, cellSize * dpr, cellSize * dpr),
+            1.0 / dpr, 1.0 / dpr, 0.0, opacity));
+    }
+    if (!fruitFragments.isEmpty())
+        p.drawPixmapFragments(fruitFragments.constData(), static_cast<int>(fruitFragments.size()), fruitAtlas);
+}
 
-        if (isNewRecord)
-        {
-            p.setPen(QColor(255, 215, 0));
-            p.setFont(QFont("Consolas", 18, QFont::Bold));
-            QRect recordRect(gameRect.left(), startY, gameRect.width(), 40);
-            p.drawText(recordRect, Qt::AlignCenter, "NOUVEAU RECORD !");
-            startY += 60;
-        }
-        else
+// Patrouilles : blocs rayés orange ; poursuivants : boules violettes
+void SnakeWidget::drawHazards(QPainter &p, int offsetX, int offsetY, DetailLevel detail)
+{
+    if (arenaMode || view().hazards.isEmpty())
+        return;
+
+    p.save();
+    for (const SimHazard &hz : view().hazards)
+        drawHazard(p, QRect(offsetX + hz.x * cellSize, offsetY + hz.y * cellSize, cellSize, cellSize),
+                   hz.kind, detail);
+    p.restore();
+}
+
+void SnakeWidget::drawHazard(QPainter &p, const QRect &r, HazardKind kind, DetailLevel detail)
+{
+    if (detail != DETAIL_FULL)
+    {
+        p.fillRect(r.adjusted(1, 1, -1, -1),
+                   kind == HAZARD_PATROL ? QColor(255, 110, 30) : QColor(170, 60, 220));
+    }
+    else if (kind == HAZARD_PATROL)
+    {
+        p.setBrush(QColor(255, 110, 30));
+        p.setPen(QPen(QColor(120, 40, 0), 2));
+        p.drawRoundedRect(r.adjusted(2, 2, -2, -2), 3, 3);
+        p.setPen(QPen(QColor(40, 20, 0, 180), 2));
+        p.drawLine(r.left() + 4, r.bottom() - 4, r.right() - 4, r.top() + 4);
+    }
+    else
+    {
+        p.setBrush(QColor(170, 60, 220));
+        p.setPen(QPen(QColor(80, 0, 120), 2));
+        p.drawEllipse(r.adjusted(2, 2, -2, -2));
+        p.setBrush(Qt::white);
+        p.setPen(Qt::NoPen);
+        int eye = qMax(2, cellSize / 7);
+        p.drawEllipse(QPoint(r.center().x() - cellSize / 6, r.center().y() - cellSize / 8), eye, eye);
+        p.drawEllipse(QPoint(r.center().x() + cellSize / 6, r.center().y() - cellSize / 8), eye, eye);
+    }
+}
+
+// Code d'une case pour le rendu en tuiles
+static constexpr quint32 CELL_WALL = 1;
+static constexpr int CELL_FOOD_SHIFT = 1;      // type + 1 sur 4 bits
+static constexpr quint32 CELL_FOOD_DIM = 1 << 5;
+static constexpr int CELL_HAZARD_SHIFT = 6;    // genre + 1 sur 2 bits
+static constexpr int CELL_SNAKE_SHIFT = 8;     // rang du segment + 1
+
+bool SnakeWidget::useTiles(const QRect &gameRect, DetailLevel detail) const
+{
+    return tiledRendering && !arenaMode && detail != DETAIL_PIXEL
+        && qint64(gameRect.width()) * gameRect.height() >= TILED_MIN_PIXELS;
+}
+
+void SnakeWidget::updateCellCodes()
+{
+    const SimSnapshot &state = view();
+    cellCodes.fill(0, state.boardW * state.boardH);
+    quint32 *codes = cellCodes.data();
+
+    const WallGrid &walls = state.walls;
+    for (int y = 0; y < walls.height(); ++y)
+    {
+        const uchar *row = walls.row(y);
+        for (int x = 0; x < walls.width(); ++x)
         {
-            startY += 30;
+            if ((x & 7) == 0 && !row[x >> 3])
+            {
+                x += 7;
+                continue;
+            }
+            if (walls.isWall(x, y))
+                codes[y * state.boardW + x] |= CELL_WALL;
         }
+    }
+    for (const SimFood &f : state.foods)
+    {
+        if (f.x < 0)
+            continue;
+        bool dim = f.ticksLeft >= 0 && f.ticksLeft < 12 && (f.ticksLeft & 1);
+        codes[f.y * state.boardW + f.x] |= (quint32(f.type) + 1) << CELL_FOOD_SHIFT
+                                          | (dim ? CELL_FOOD_DIM : 0);
+    }
+    for (const SimHazard &hz : state.hazards)
+        codes[hz.y * state.boardW + hz.x] |= (quint32(hz.kind) + 1) << CELL_HAZARD_SHIFT;
+    for (int i = 0; i < state.snake.size(); ++i)
+        codes[state.snake[i]] |= quint32(i + 1) << CELL_SNAKE_SHIFT;
+}
 
-        p.setPen(Qt::white);
-        p.setFont(QFont("Consolas", 22));
-        QRect scoreRect(gameRect.left(), startY, gameRect.width(), 40);
-        p.drawText(scoreRect, Qt::AlignCenter,
-                   QString("Score final : %1").arg(game.getScore()));
-
-        startY += 50;
+// Empreinte FNV-1a des cases de la tuile et de leur bordure d'une case.
+// La teinte d'un segment dépend de son rang et de la longueur, la tête
+// de la direction : ils entrent dans l'empreinte des cases du serpent.
+quint64 SnakeWidget::tileSignature(int tx, int ty) const
+{
+    const SimSnapshot &state = view();
+    int x0 = qMax(0, tx * TILE_CELLS - 1);
+    int y0 = qMax(0, ty * TILE_CELLS - 1);
+    int x1 = qMin(state.boardW, (tx + 1) * TILE_CELLS + 1);
+    int y1 = qMin(state.boardH, (ty + 1) * TILE_CELLS + 1);
+    // Les codes tiennent sur 32 bits : longueur (au plus 2^28 cases),
+    // direction de la tête et fantôme vont au-dessus, sans les recouvrir
+    quint64 snakeSalt = quint64(state.snake.size()) << 32 | quint64(state.ghost) << 63;
+    quint64 headSalt = snakeSalt ^ quint64(state.direction - UP) << 61;
+
+    quint64 h = 14695981039346656037ULL ^ (quint64(state.boardW) << 32 | quint64(state.boardH));
+    for (int y = y0; y < y1; ++y)
+    {
+        const quint32 *row = cellCodes.constData() + y * state.boardW;
+        for (int x = x0; x < x1; ++x)
+        {
+            quint64 c = row[x];
+            if (c >> CELL_SNAKE_SHIFT)
+                c ^= (c >> CELL_SNAKE_SHIFT) == 1 ? headSalt : snakeSalt;
+            h = (h ^ c) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
 
-        p.setPen(QColor(255, 200, 0));
-        p.setFont(QFont("Consolas", 18));
-        QRect bestRect(gameRect.left(), startY, gameRect.width(), 40);
-        p.drawText(bestRect, Qt::AlignCenter,
-                   QString("Meilleur score : %1").arg(bestScore));
+// Tuiles à jour dessinées en parallèle, puis posées par le thread
+// graphique. Les dessins ne lisent que l'état figé de la vue, les codes
+// de cases et l'atlas en QImage (un QPixmap ne se lit pas hors du thread
+// graphique).
+void SnakeWidget::drawTiledBoard(QPainter &p, const QRect &gameRect, DetailLevel detail)
+{
+    int cols = (boardWidth() + TILE_CELLS - 1) / TILE_CELLS;
+    int rows = (boardHeight() + TILE_CELLS - 1) / TILE_CELLS;
+    qreal dpr = devicePixelRatioF();
+    if (cols != tileCols || rows != tileRows || cellSize != tileCellSize
+        || detail != tileDetail || !qFuzzyCompare(dpr, tileDpr))
+    {
+        tiles.clear();
+        tiles.resize(cols * rows);
+        tileCols = cols;
+        tileRows = rows;
+        tileCellSize = cellSize;
+        tileDetail = detail;
+        tileDpr = dpr;
+    }
 
-        return;
+    ensureFruitAtlas();
+    updateCellCodes();
+    dirtyTiles.clear();
+    for (int i = 0; i < tiles.size(); ++i)
+    {
+        quint64 signature = tileSignature(i % cols, i / cols);
+        if (!tiles[i].valid || tiles[i].signature != signature)
+        {
+            tiles[i].signature = signature;
+            tiles[i].valid = true;
+            dirtyTiles.append(i);
+        }
     }
+    QtConcurrent::blockingMap(dirtyTiles, [this](int index) { renderTile(index); });
 
-    QLinearGradient gameGradient(gameRect.topLeft(), gameRect.bottomRight());
-    gameGradient.setColorAt(0, QColor(5, 5, 20));
-    gameGradient.setColorAt(1, QColor(8, 8, 25));
-    p.fillRect(gameRect, gameGradient);
+    int span = TILE_CELLS * cellSize;
+    for (int i = 0; i < tiles.size(); ++i)
+        p.drawImage(QPoint(gameRect.left() + (i % cols) * span, gameRect.top() + (i / cols) * span),
+                    tiles[i].image);
+}
 
-    p.setPen(QPen(QColor(0, 220, 170), 3));
-    p.drawRect(gameRect.adjusted(1, 1, -1, -1));
-    p.setPen(QPen(QColor(0, 255, 200, 100), 1));
-    p.drawRect(gameRect.adjusted(3, 3, -3, -3));
+// Une tuile, dans le repère du plateau : fond et quadrillage, puis les
+// cases de la tuile et de sa bordure, rognées à la tuile, dans l'ordre du
+// rendu d'un seul tenant (murs, fruits, dangers, serpent de la tête à la
+// queue)
+void SnakeWidget::renderTile(int index)
+{
+    const SimSnapshot &state = view();
+    DetailLevel detail = tileDetail;
+    int tx = index % tileCols;
+    int ty = index / tileCols;
+    int span = TILE_CELLS * cellSize;
+    QRect board(0, 0, state.boardW * cellSize, state.boardH * cellSize);
+    QRect area = QRect(tx * span, ty * span, span, span).intersected(board);
+
+    BoardTile &tile = tiles[index];
+    QSize pixels(qCeil(area.width() * tileDpr), qCeil(area.height() * tileDpr));
+    if (tile.image.size() != pixels)
+    {
+        tile.image = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+        tile.image.setDevicePixelRatio(tileDpr);
+    }
 
-    p.setPen(QPen(QColor(0, 100, 100), 1));
-    for (int x = 1; x < WIDTH; ++x)
-        p.drawLine(offsetX + x * cellSize, offsetY,
-                   offsetX + x * cellSize, offsetY + gameHeight);
-    for (int y = 1; y < HEIGHT; ++y)
-        p.drawLine(offsetX, offsetY + y * cellSize,
-                   offsetX + gameWidth, offsetY + y * cellSize);
+    QPainter p(&tile.image);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.translate(-area.topLeft());
+    p.setClipRect(area);
+    drawBoardBackground(p, board);
+
+    int x0 = qMax(0, tx * TILE_CELLS - 1);
+    int y0 = qMax(0, ty * TILE_CELLS - 1);
+    int x1 = qMin(state.boardW, (tx + 1) * TILE_CELLS + 1);
+    int y1 = qMin(state.boardH, (ty + 1) * TILE_CELLS + 1);
+    auto cellRect = [this](int x, int y) {
+        return QRect(x * cellSize, y * cellSize, cellSize, cellSize);
+    };
+
+    const quint32 *codes = cellCodes.constData();
+    QVector<int> segments;   // rang de chaque segment de la zone
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            quint32 c = codes[y * state.boardW + x];
+            if (!(c & CELL_WALL))
+                continue;
+            if (detail == DETAIL_FULL)
+            {
+                drawWall(p, cellRect(x, y));
+            }
+            else
+            {
+                p.save();
+                p.setRenderHint(QPainter::Antialiasing, false);
+                p.setBrush(QColor(115, 115, 115));
+                p.setPen(QPen(QColor(60, 60, 60), 1));
+                p.drawRect(cellRect(x, y).adjusted(0, 0, -1, -1));
+                p.restore();
+            }
+        }
+    }
 
-    if (waitingStart)
+    qreal atlasDpr = fruitAtlasImage.devicePixelRatio();
+    int stride = cellSize + 2 * ATLAS_PAD;
+    for (int y = y0; y < y1; ++y)
     {
-        p.setPen(QPen(QColor(0, 255, 180), 2));
-        p.setFont(QFont("Consolas", 28, QFont::Bold));
-        p.drawText(gameRect.adjusted(0, -40, 0, -40), Qt::AlignCenter, "SNAKE PRO");
-
-        p.setPen(Qt::white);
-        p.setFont(QFont("Consolas", 16));
-        p.drawText(gameRect.adjusted(0, 0, 0, -80), Qt::AlignCenter,
-                   "Appuie sur ENTRER pour commencer");
-
-        p.setFont(QFont("Consolas", 12));
-        p.setPen(QColor(255, 80, 80));
-        p.drawText(gameRect.adjusted(0, 60, 0, 0), Qt::AlignCenter,
-                   "Pomme = 10 pts");
-        p.setPen(QColor(255, 220, 0));
-        p.drawText(gameRect.adjusted(0, 85, 0, 0), Qt::AlignCenter,
-                   "Banane = 15 pts");
-        p.setPen(QColor(255, 180, 0));
-        p.drawText(gameRect.adjusted(0, 110, 0, 0), Qt::AlignCenter,
-                   "Ananas = 25 pts");
+        for (int x = x0; x < x1; ++x)
+        {
+            quint32 c = codes[y * state.boardW + x];
+            int food = (c >> CELL_FOOD_SHIFT) & 15;
+            if (!food)
+                continue;
+            p.setOpacity((c & CELL_FOOD_DIM) ? 0.35 : 1.0);
+            p.drawImage(QRectF(cellRect(x, y)), fruitAtlasImage,
+                        QRectF(((food - 1) * stride + ATLAS_PAD) * atlasDpr, ATLAS_PAD * atlasDpr,
+                               cellSize * atlasDpr, cellSize * atlasDpr));
+        }
+    }
+    p.setOpacity(1.0);
 
-        return;
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            quint32 c = codes[y * state.boardW + x];
+            int hazard = (c >> CELL_HAZARD_SHIFT) & 3;
+            if (hazard)
+                drawHazard(p, cellRect(x, y), static_cast<HazardKind>(hazard - 1), detail);
+            if (c >> CELL_SNAKE_SHIFT)
+                segments.append(int(c >> CELL_SNAKE_SHIFT) - 1);
+        }
     }
 
-    // ============= MUR DE BÉTON GRIS 🏗️ - CLAIR ET VISIBLE =============
-    for (const Obstacle &o : game.getObstacles())
+    std::sort(segments.begin(), segments.end());
+    int totalLength = static_cast<int>(state.snake.size());
+    if (state.ghost)
+        p.setOpacity(0.5);
+    for (int i : segments)
     {
-        QRect r(offsetX + o.x * cellSize,
-                offsetY + o.y * cellSize,
-                cellSize, cellSize);
+        int cell = state.snake[i];
+        QRect r = cellRect(cell % state.boardW, cell / state.boardW);
+        float segmentRatio = static_cast<float>(i) / totalLength;
+        if (detail == DETAIL_FULL)
+        {
+            drawSnakeSegment(p, r, i == 0, segmentRatio, state.direction);
+        }
+        else
+        {
+            p.fillRect(r.adjusted(1, 1, -1, -1), segmentColor(i == 0, segmentRatio, QColor()));
+            p.save();
+            p.setRenderHint(QPainter::Antialiasing, false);
+            p.setBrush(Qt::NoBrush);
+            p.setPen(QPen(QColor(0, 90, 60), 1));
+            p.drawRect(r.adjusted(1, 1, -2, -2));
+            p.restore();
+        }
+    }
+}
 
-        p.save();
-        p.setRenderHint(QPainter::Antialiasing);
-
-        // Ombre portée du mur
-        QRect shadowRect = r.adjusted(2, 2, 2, 2);
-        p.fillRect(shadowRect, QColor(0, 0, 0, 80));
-
-        // Fond du mur - Gradient gris
-        QLinearGradient wallGrad(r.topLeft(), r.bottomRight());
-        wallGrad.setColorAt(0.0, QColor(140, 140, 140));   // Gris clair
-        wallGrad.setColorAt(0.5, QColor(110, 110, 110));   // Gris moyen
-        wallGrad.setColorAt(1.0, QColor(90, 90, 90));      // Gris foncé
-
-        p.setBrush(wallGrad);
-        p.setPen(QPen(QColor(60, 60, 60), 3));  // Bordure très foncée
-        p.drawRect(r.adjusted(1, 1, -1, -1));
-
-        // Lignes de briques horizontales
-        int brickHeight = cellSize / 3;
-        p.setPen(QPen(QColor(50, 50, 50), 2));
-
-        // Ligne 1
-        p.drawLine(r.left() + 1, r.top() + brickHeight,
-                   r.right() - 1, r.top() + brickHeight);
-
-        // Ligne 2
-        p.drawLine(r.left() + 1, r.top() + 2 * brickHeight,
-                   r.right() - 1, r.top() + 2 * brickHeight);
-
-        // Lignes verticales alternées (joints de briques)
-        // Rangée 1
-        p.drawLine(r.left() + cellSize/2, r.top() + 1,
-                   r.left() + cellSize/2, r.top() + brickHeight);
-
-        // Rangée 2
-        p.drawLine(r.left() + cellSize/4, r.top() + brickHeight,
-                   r.left() + cellSize/4, r.top() + 2 * brickHeight);
-        p.drawLine(r.left() + 3*cellSize/4, r.top() + brickHeight,
-                   r.left() + 3*cellSize/4, r.top() + 2 * brickHeight);
-
-        // Rangée 3
-        p.drawLine(r.left() + cellSize/2, r.top() + 2 * brickHeight,
-                   r.left() + cellSize/2, r.bottom() - 1);
-
-        // Effet 3D - Lumière en haut à gauche
-        p.setPen(QPen(QColor(180, 180, 180, 150), 1));
-        p.drawLine(r.left() + 2, r.top() + 2, r.right() - 2, r.top() + 2);
-        p.drawLine(r.left() + 2, r.top() + 2, r.left() + 2, r.bottom() - 2);
-
-        // Effet 3D - Ombre en bas à droite
-        p.setPen(QPen(QColor(40, 40, 40, 150), 1));
-        p.drawLine(r.right() - 2, r.top() + 2, r.right() - 2, r.bottom() - 2);
-        p.drawLine(r.left() + 2, r.bottom() - 2, r.right() - 2, r.bottom() - 2);
-
-        // Texture béton (petites imperfections aléatoires)
-        p.setBrush(QColor(80, 80, 80, 60));
-        p.setPen(Qt::NoPen);
+void SnakeWidget::drawApple(QPainter &p, const QRect &rect)
+{
+    QPoint center = rect.center();
+    QRadialGradient appleGrad(center, cellSize * 0.6);
+    appleGrad.setColorAt(0, QColor(255, 80, 80));
+    appleGrad.setColorAt(0.6, QColor(220, 30, 30));
+    appleGrad.setColorAt(1, QColor(180, 20, 20));
+    p.setBrush(appleGrad);
+    p.setPen(QPen(QColor(200, 40, 40), 2));
+    p.drawEllipse(rect.adjusted(2, 2, -2, -2));
+
+    p.setBrush(QColor(255, 255, 255, 150));
+    p.setPen(Qt::NoPen);
+    p.drawEllipse(center.x() - cellSize/4, center.y() - cellSize/3,
+                  cellSize/3, cellSize/3);
+
+    p.setPen(QPen(QColor(100, 60, 20), 2));
+    p.drawLine(center.x(), center.y() - cellSize/3,
+               center.x(), center.y() - cellSize/2);
+
+    p.setBrush(QColor(50, 150, 50));
+    p.setPen(Qt::NoPen);
+    QPoint leaf[3] = {
+        QPoint(center.x(), center.y() - cellSize/2),
+        QPoint(center.x() + cellSize/5, center.y() - cellSize/2.5),
+        QPoint(center.x() + cellSize/6, center.y() - cellSize/3)
+    };
+    p.drawPolygon(leaf, 3);
+}
+
+void SnakeWidget::drawBanana(QPainter &p, const QRect &rect)
+{
+    QPoint center = rect.center();
+    QPainterPath bananaBody;
+    bananaBody.moveTo(center.x() - cellSize/3, center.y() + cellSize/5);
+    bananaBody.cubicTo(
+        center.x() - cellSize/2.5, center.y() - cellSize/8,
+        center.x() - cellSize/6, center.y() - cellSize/2.5,
+        center.x() + cellSize/4, center.y() - cellSize/3
+        );
+    bananaBody.lineTo(center.x() + cellSize/3, center.y() - cellSize/4);
+    bananaBody.cubicTo(
+        center.x() + cellSize/5, center.y() - cellSize/2.2,
+        center.x() - cellSize/8, center.y() - cellSize/6,
+        center.x() - cellSize/3.5, center.y() + cellSize/4
+        );
+    bananaBody.closeSubpath();
+
+    QLinearGradient bananaGrad(
+        center.x() - cellSize/3, center.y(),
+        center.x() + cellSize/3, center.y()
+        );
+    bananaGrad.setColorAt(0, QColor(240, 210, 70));
+    bananaGrad.setColorAt(0.3, QColor(255, 235, 100));
+    bananaGrad.setColorAt(0.5, QColor(255, 245, 120));
+    bananaGrad.setColorAt(0.7, QColor(255, 230, 80));
+    bananaGrad.setColorAt(1, QColor(230, 195, 50));
+    p.setBrush(bananaGrad);
+    p.setPen(Qt::NoPen);
+    p.drawPath(bananaBody);
 
-        QPoint center = r.center();
-        p.drawEllipse(center.x() - cellSize/6, center.y() - cellSize/8, 3, 2);
-        p.drawEllipse(center.x() + cellSize/8, center.y() + cellSize/10, 2, 3);
-        p.drawEllipse(center.x() - cellSize/10, center.y() + cellSize/6, 2, 2);
+    p.setBrush(Qt::NoBrush);
+    p.setPen(QPen(QColor(180, 140, 30), 2));
+    p.drawPath(bananaBody);
+}
 
-        p.restore();
+void SnakeWidget::drawPineapple(QPainter &p, const QRect &rect)
+{
+    QPoint center = rect.center();
+    QLinearGradient pineGrad(rect.topLeft(), rect.bottomRight());
+    pineGrad.setColorAt(0, QColor(255, 200, 50));
+    pineGrad.setColorAt(0.5, QColor(240, 160, 0));
+    pineGrad.setColorAt(1, QColor(200, 120, 0));
+    p.setBrush(pineGrad);
+    p.setPen(QPen(QColor(180, 100, 0), 2));
+
+    QRect body = rect.adjusted(3, cellSize/4, -3, -2);
+    p.drawEllipse(body);
+
+    p.setPen(QPen(QColor(150, 80, 0), 1));
+    for (int y = 0; y < 3; ++y)
+    {
+        for (int x = 0; x < 2; ++x)
+        {
+            int px = center.x() - cellSize/5 + x * cellSize/2.5;
+            int py = center.y() - cellSize/6 + y * cellSize/4;
+            p.drawLine(px - cellSize/8, py, px, py - cellSize/8);
+            p.drawLine(px, py - cellSize/8, px + cellSize/8, py);
+            p.drawLine(px + cellSize/8, py, px, py + cellSize/8);
+            p.drawLine(px, py + cellSize/8, px - cellSize/8, py);
+        }
     }
 
-    for (int i = 0; i < game.foodCount(); ++i)
+    p.setBrush(QColor(50, 180, 50));
+    p.setPen(QPen(QColor(30, 140, 30), 2));
+    for (int i = 0; i < 5; ++i)
     {
-        QRect foodRect(offsetX + game.foodX(i) * cellSize,
-                       offsetY + game.foodY(i) * cellSize,
-                       cellSize, cellSize);
-        drawFruit(p, foodRect, game.foodType(i));
+        int angle = -60 + i * 30;
+        float rad = angle * 3.14159 / 180.0;
+        int x1 = center.x();
+        int y1 = rect.top() + cellSize/4;
+        int x2 = x1 + qSin(rad) * cellSize/2;
+        int y2 = y1 - qCos(rad) * cellSize/2.5;
+        QPoint leaf[3] = {
+            QPoint(x1, y1),
+            QPoint(x2, y2),
+            QPoint(x1 + qSin(rad) * cellSize/4, y1 - cellSize/6)
+        };
+        p.drawPolygon(leaf, 3);
     }
+}
 
-    Direction snakeDir = game.getDirection();
-    SnakeNode *cur = game.snakeHead();
-    int segmentIndex = 0;
-    int totalLength = game.getLength();
+void SnakeWidget::drawCherry(QPainter &p, const QRect &rect)
+{
+    QPoint center = rect.center();
+    int r = qMax(2, cellSize / 4);
+
+    p.setPen(QPen(QColor(60, 130, 40), 2));
+    p.setBrush(Qt::NoBrush);
+    QPainterPath stems;
+    stems.moveTo(center.x() - r, center.y() + r / 2);
+    stems.quadTo(center.x() - r / 2, center.y() - cellSize / 3, center.x() + r / 3, center.y() - cellSize / 2.5);
+    stems.moveTo(center.x() + r, center.y() + r / 2);
+    stems.quadTo(center.x() + r / 2, center.y() - cellSize / 4, center.x() + r / 3, center.y() - cellSize / 2.5);
+    p.drawPath(stems);
+
+    for (int side = -1; side <= 1; side += 2)
+    {
+        QPoint c(center.x() + side * r, center.y() + r / 2 + 1);
+        QRadialGradient grad(c - QPoint(r / 3, r / 3), r * 1.4);
+        grad.setColorAt(0, QColor(255, 90, 110));
+        grad.setColorAt(0.7, QColor(210, 20, 60));
+        grad.setColorAt(1, QColor(150, 10, 40));
+        p.setBrush(grad);
+        p.setPen(QPen(QColor(140, 10, 35), 1));
+        p.drawEllipse(c, r, r);
+    }
+}
 
-    while (cur)
+// Bonus : losange violet et deux lames croisées
+void SnakeWidget::drawScissors(QPainter &p, const QRect &rect)
+{
+    QPoint center = rect.center();
+    int h = cellSize / 2 - 1;
+
+    QPoint gem[4] = {
+        QPoint(center.x(), center.y() - h),
+        QPoint(center.x() + h, center.y()),
+        QPoint(center.x(), center.y() + h),
+        QPoint(center.x() - h, center.y())
+    };
+    QLinearGradient grad(rect.topLeft(), rect.bottomRight());
+    grad.setColorAt(0, QColor(210, 170, 255));
+    grad.setColorAt(1, QColor(120, 60, 200));
+    p.setBrush(grad);
+    p.setPen(QPen(QColor(90, 40, 160), 2));
+    p.drawPolygon(gem, 4);
+
+    p.setPen(QPen(QColor(255, 255, 255, 220), 2));
+    p.drawLine(center.x() - h / 2, center.y() - h / 2, center.x() + h / 2, center.y() + h / 2);
+    p.drawLine(center.x() + h / 2, center.y() - h / 2, center.x() - h / 2, center.y() + h / 2);
+}
+
+void SnakeWidget::drawBolt(QPainter &p, const QRect &rect)
+{
+    QPoint center = rect.center();
+    int h = cellSize / 2 - 1;
+    QPoint bolt[6] = {
+        QPoint(center.x() + h / 3, center.y() - h),
+        QPoint(center.x() - h / 2, center.y() + h / 6),
+        QPoint(center.x(), center.y() + h / 6),
+        QPoint(center.x() - h / 3, center.y() + h),
+        QPoint(center.x() + h / 2, center.y() - h / 6),
+        QPoint(center.x(), center.y() - h / 6)
+    };
+    QLinearGradient grad(rect.topLeft(), rect.bottomLeft());
+    grad.setColorAt(0, QColor(200, 240, 255));
+    grad.setColorAt(1, QColor(60, 170, 255));
+    p.setBrush(grad);
+    p.setPen(QPen(QColor(30, 110, 200), 1));
+    p.drawPolygon(bolt, 6);
+}
+
+void SnakeWidget::drawGhost(QPainter &p, const QRect &rect)
+{
+    QRectF r = QRectF(rect).adjusted(3, 2, -3, -2);
+    QPainterPath body;
+    body.moveTo(r.left(), r.bottom());
+    body.lineTo(r.left(), r.top() + r.width() / 2);
+    body.cubicTo(r.left(), r.top() - r.width() / 6,
+                 r.right(), r.top() - r.width() / 6,
+                 r.right(), r.top() + r.width() / 2);
+    body.lineTo(r.right(), r.bottom());
+    // Bas ondulé
+    double step = r.width() / 4;
+    for (int i = 1; i <= 4; ++i)
+        body.lineTo(r.right() - i * step, r.bottom() - ((i & 1) ? step / 1.5 : 0));
+    body.closeSubpath();
+
+    p.setBrush(QColor(225, 225, 255, 220));
+    p.setPen(QPen(QColor(150, 150, 210), 1));
+    p.drawPath(body);
+
+    p.setBrush(QColor(40, 40, 80));
+    p.setPen(Qt::NoPen);
+    double eye = qMax(1.5, r.width() / 8);
+    p.drawEllipse(QPointF(r.center().x() - r.width() / 5, r.top() + r.height() / 2.6), eye, eye);
+    p.drawEllipse(QPointF(r.center().x() + r.width() / 5, r.top() + r.height() / 2.6), eye, eye);
+}
+
+void SnakeWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QElapsedTimer paintClock;
+    paintClock.start();
+    QPainter p(this);
+    paintScene(p);
+    if (showTiming && !arenaMode)
+        drawTiming(p);
+    lastPaintNs = paintClock.nsecsElapsed();
+    if (!framePainted)
     {
-        QRect r(offsetX + cur->x * cellSize,
-                offsetY + cur->y * cellSize,
-                cellSize, cellSize);
-        bool isHead = (segmentIndex == 0);
-        float segmentRatio = static_cast<float>(segmentIndex) / totalLength;
-        drawSnakeSegment(p, r, isHead, segmentRatio, snakeDir);
-        cur = cur->next;
-        segmentIndex++;
+        framePainted = true;
+        emit firstFramePainted();
     }
+}
 
-    for (const ScorePopup &popup : scorePopups)
+// Retard des pas sur leur échéance (thread de jeu) et durée du rendu
+// précédent : les deux doivent rester indépendants
+void SnakeWidget::drawTiming(QPainter &p)
+{
+    const SimTiming &t = view().timing;
+    double meanMs = t.ticks ? t.totalLateNs / 1e6 / t.ticks : 0.0;
+    hud.timing[0].setValue(qint64(t.ticks));
+    hud.timing[1].setValue(meanMs, 3);
+    hud.timing[2].setValue(t.maxLateNs / 1e6, 3);
+    hud.timing[3].setValue(qint64(t.lateTicks));
+    hud.timing[4].setValue(lastPaintNs / 1e6, 2);
+
+    QRect box(10, 10, 240, 18 * hud.timing.size() + 12);
+    p.fillRect(box, QColor(0, 0, 0, 170));
+    for (int i = 0; i < hud.timing.size(); ++i)
+        hud.timing[i].draw(p, box.left() + 8, box.top() + 20 + 18 * i, QColor(120, 255, 160));
+}
+
+void SnakeWidget::paintScene(QPainter &p)
+{
+    const SimSnapshot &state = view();
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    QLinearGradient bgGradient(0, 0, 0, height());
+    bgGradient.setColorAt(0, QColor(15, 15, 35));
+    bgGradient.setColorAt(1, QColor(10, 10, 25));
+    p.fillRect(rect(), bgGradient);
+
+    int gameWidth = boardWidth() * cellSize;
+    int gameHeight = boardHeight() * cellSize;
+    int offsetX = (width() - gameWidth) / 2;
+    int offsetY = (height() - (boardHeight() + 3) * cellSize) / 2;
+    if (offsetY < 0) offsetY = 0;
+
+    QRect gameRect(offsetX, offsetY, gameWidth, gameHeight);
+
+    if (isOver())
     {
-        int screenX = offsetX + popup.x * cellSize + cellSize / 2;
-        int screenY = offsetY + popup.y * cellSize + popup.offsetY;
+        p.fillRect(gameRect, QColor(15, 15, 30));
+
+        p.setPen(QPen(QColor(0, 60, 60, 100), 1));
+        int gridSize = 30;
+        for (int x = 0; x < gameRect.width(); x += gridSize)
+            p.drawLine(gameRect.left() + x, gameRect.top(),
+                       gameRect.left() + x, gameRect.bottom());
+        for (int y = 0; y < gameRect.height(); y += gridSize)
+            p.drawLine(gameRect.left(), gameRect.top() + y,
+                       gameRect.right(), gameRect.top() + y);
+
+        p.setPen(QPen(QColor(255, 50, 50), 4));
+        p.drawRect(gameRect.adjusted(5, 5, -5, -5));
+
+        int startY = gameRect.top() + 120;
+
+        QRect titleRect(gameRect.left(), startY, gameRect.width(), 60);
+        hud.overTitle.drawCentered(p, titleRect, QColor(255, 100, 100));
+
+        startY += 90;
 
-        QColor textColor;
-        if (popup.fruitType == APPLE)
+        if (arenaMode)
         {
-            textColor = QColor(255, 80, 80, popup.alpha);
+            int w = arena.winner();
+            QColor tint = snakeTint(w);
+            QRect winnerRect(gameRect.left(), startY, gameRect.width(), 40);
+            if (hud.winnerId != w)
+            {
+                hud.winnerId = w;
+                hud.winner.setFormat("Vainqueur : " + snakeLabel(w) + " (%1 pts)");
+            }
+            hud.winner.setValue(w >= 0 ? arena.snake(w).score : 0);
+            hud.winner.drawCentered(p, winnerRect, tint.isValid() ? tint : QColor(0, 255, 140));
+            return;
+        }
+
+        bool isNewRecord = isRanked() && state.score >= bestScore && state.score > 0;
+
+        if (isNewRecord)
+        {
+            QRect recordRect(gameRect.left(), startY, gameRect.width(), 40);
+            hud.record.drawCentered(p, recordRect, QColor(255, 215, 0));
+            startY += 60;
+        }
+        else
+        {
+            startY += 30;
         }
-        else if (popup.fruitType == BANANA)
+
+        QRect scoreRect(gameRect.left(), startY, gameRect.width(), 40);
+        hud.finalScore.setValue(state.score);
+        hud.finalScore.drawCentered(p, scoreRect, Qt::white);
+
+        startY += 50;
+
+        if (state.cause == DEATH_HAZARD)
         {
-            textColor = QColor(255, 235, 0, popup.alpha);
+            QRect causeRect(gameRect.left(), startY - 15, gameRect.width(), 30);
+            hud.cause.drawCentered(p, causeRect, QColor(255, 140, 60));
+            startY += 25;
         }
-        else if (popup.fruitType == PINEAPPLE)
+
+        if (!isRanked())
+        {
+            QRect frenzyRect(gameRect.left(), startY, gameRect.width(), 30);
+            bool frenzy = state.foods.size() > Game::FOOD_COUNT;
+            HudText &unranked = frenzy ? hud.unrankedFrenzy : hud.unrankedHazards;
+            unranked.setValue(frenzy ? state.foods.size() : state.hazards.size());
+            unranked.drawCentered(p, frenzyRect, QColor(150, 150, 200));
+            return;
+        }
+
+        QRect bestRect(gameRect.left(), startY, gameRect.width(), 40);
+        hud.bestLine.setValue(bestScore);
+        hud.bestLine.drawCentered(p, bestRect, QColor(255, 200, 0));
+
+        quint64 previous = leaderboard.gameCount(state.level);
+        if (previous > 1)
         {
-            textColor = QColor(255, 165, 0, popup.alpha);
+            startY += 40;
+            QRect rankRect(gameRect.left(), startY, gameRect.width(), 30);
+            hud.rank.drawCentered(p, rankRect, QColor(150, 150, 200));
         }
 
-        p.setPen(textColor);
-        p.setFont(QFont("Consolas", 20, QFont::Bold));
+        return;
+    }
+
+    DetailLevel detail = detailLevel();
+    bool tiled = !waitingStart && useTiles(gameRect, detail);
+    if (tiled)
+        drawTiledBoard(p, gameRect, detail);
+    else
+        drawBoardBackground(p, gameRect);
+
+    if (waitingStart)
+    {
+        hud.startTitle.drawCentered(p, gameRect.adjusted(0, -40, 0, -40), QColor(0, 255, 180));
+        hud.startPrompt.drawCentered(p, gameRect.adjusted(0, 0, 0, -80), Qt::white);
+
+        for (int i = 0; i < hud.startFruits.size(); ++i)
+            hud.startFruits[i].drawCentered(p, gameRect.translated(0, 30 + 20 * i),
+                                            QColor::fromRgb(ITEM_TYPES[i].color));
+
+        return;
+    }
 
-        QString scoreText = QString("+%1").arg(popup.points);
+    // Par tuiles, le plateau est déjà posé
+    if (!tiled)
+    {
+        drawWalls(p, offsetX, offsetY, detail);
+        drawFoods(p, offsetX, offsetY);
+        if (detail == DETAIL_PIXEL)
+        {
+            drawPixelLayer(p, gameRect);
+        }
+        else
+        {
+            drawHazards(p, offsetX, offsetY, detail);
+            if (arenaMode)
+                drawArenaSnakes(p, offsetX, offsetY, detail);
+            else
+                drawSnake(p, offsetX, offsetY, detail);
+        }
+    }
+    if (heatMode != HEAT_OFF && !arenaMode)
+        drawHeatMap(p, gameRect);
+
+    for (const ScorePopup &popup : scorePopups)
+    {
+        int screenX = offsetX + popup.x * cellSize + cellSize / 2;
+        int screenY = offsetY + popup.y * cellSize + popup.offsetY;
+
+        QColor textColor = QColor::fromRgb(itemType(popup.fruitType).color);
+        textColor.setAlpha(popup.alpha);
+
+        if (!hud.popups.contains(popup.points))
+        {
+            HudText text(QFont("Consolas", 20, QFont::Bold), "+%1");
+            text.setValue(popup.points);
+            hud.popups.insert(popup.points, text);
+        }
         QRect textRect(screenX - 30, screenY - 20, 60, 40);
-        p.drawText(textRect, Qt::AlignCenter, scoreText);
+        hud.popups[popup.points].drawCentered(p, textRect, textColor);
     }
 
     if (isPaused)
     {
         p.fillRect(gameRect, QColor(0, 0, 0, 180));
 
-        p.setPen(QColor(0, 255, 180));
-        p.setFont(QFont("Consolas", 48, QFont::Bold));
         QRect pauseTitleRect(gameRect.left(), gameRect.top() + 80,
                              gameRect.width(), 60);
-        p.drawText(pauseTitleRect, Qt::AlignCenter, "PAUSE");
+        hud.pauseTitle.drawCentered(p, pauseTitleRect, QColor(0, 255, 180));
 
-        p.setPen(Qt::white);
-        p.setFont(QFont("Consolas", 20));
         QRect pauseScoreRect(gameRect.left(), gameRect.top() + 160,
                              gameRect.width(), 40);
-        p.drawText(pauseScoreRect, Qt::AlignCenter,
-                   QString("Score : %1").arg(game.getScore()));
+        hud.pauseScore.setValue(arenaMode ? arena.snake(0).score : state.score);
+        hud.pauseScore.drawCentered(p, pauseScoreRect, Qt::white);
 
-        p.setPen(QColor(200, 200, 200));
-        p.setFont(QFont("Consolas", 12));
         QRect instructionRect(gameRect.left(), gameRect.bottom() - 60,
                               gameRect.width(), 30);
-        p.drawText(instructionRect, Qt::AlignCenter, "Appuie sur P pour reprendre");
+        hud.pauseHint.drawCentered(p, instructionRect, QColor(200, 200, 200));
     }
 
-    if (game.getScore() > bestScore)
-        bestScore = game.getScore();
-
     int hudY = gameRect.bottom() + 40;
 
     QRect hudRect(offsetX, gameRect.bottom() + 15, gameWidth, 50);
@@ -802,35 +1955,71 @@ void SnakeWidget::paintEvent(QPaintEvent *event)
     hudGrad.setColorAt(1, QColor(5, 5, 20, 200));
     p.fillRect(hudRect, hudGrad);
 
-    p.setPen(QColor(0, 255, 180));
-    p.setFont(QFont("Consolas", 16, QFont::Bold));
-    p.drawText(offsetX + 20, hudY,
-               QString("Score : %1").arg(game.getScore()));
-
-    p.setPen(QColor(100, 200, 255));
-    p.drawText(offsetX + 200, hudY,
-               QString("Longueur : %1").arg(game.getLength()));
+    if (arenaMode)
+    {
+        drawArenaHud(p, offsetX, hudY);
+        return;
+    }
 
-    p.setPen(QColor(255, 200, 0));
-    p.drawText(offsetX + gameWidth/2 + 80, hudY,
-               QString("Best : %1").arg(bestScore));
+    if (isRanked() && state.score > bestScore)
+        bestScore = state.score;
 
-    p.setPen(QColor(255, 150, 255));
-    QString levelText;
-    switch (game.getLevel())
+    // Champs remis en page seulement quand leur valeur change
+    hud.score.setValue(state.score);
+    hud.length.setValue(state.length);
+    hud.best.setValue(bestScore);
+    if (hud.levelShown != state.level)
+    {
+        hud.levelShown = state.level;
+        switch (state.level)
+        {
+        case 1: hud.level.setText("Niveau : FACILE"); break;
+        case 2: hud.level.setText("Niveau : MOYEN"); break;
+        case 3: hud.level.setText("Niveau : DIFFICILE"); break;
+        default: hud.level.setText("Niveau : MOYEN"); break;
+        }
+    }
+    hud.score.draw(p, offsetX + 20, hudY, QColor(0, 255, 180));
+    hud.length.draw(p, offsetX + 200, hudY, QColor(100, 200, 255));
+    hud.best.draw(p, offsetX + gameWidth/2 + 80, hudY, QColor(255, 200, 0));
+    hud.level.draw(p, offsetX + gameWidth - 220, hudY, QColor(255, 150, 255));
+    hud.help.draw(p, offsetX + 20, hudY + 25, QColor(150, 150, 150));
+
+    int effectX = offsetX + gameWidth - 220;
+    if (int left = state.speedTicksLeft)
     {
-    case 1: levelText = "FACILE"; break;
-    case 2: levelText = "MOYEN"; break;
-    case 3: levelText = "DIFFICILE"; break;
-    default: levelText = "MOYEN"; break;
+        hud.speedEffect.setValue(left);
+        hud.speedEffect.draw(p, effectX, hudY + 25, QColor(120, 220, 255));
+        effectX += hud.speedEffect.width() + 14;
     }
-    p.drawText(offsetX + gameWidth - 220, hudY,
-               QString("Niveau : %1").arg(levelText));
+    if (int left = state.ghostTicksLeft)
+    {
+        hud.ghostEffect.setValue(left);
+        hud.ghostEffect.draw(p, effectX, hudY + 25, QColor(120, 220, 255));
+    }
+}
 
-    p.setPen(QColor(150, 150, 150));
-    p.setFont(QFont("Consolas", 10));
-    p.drawText(offsetX + 20, hudY + 25,
-               "P : pause | F11 : plein ecran | ESC : menu | Fleches : direction");
+// Fond du plateau, cadre et quadrillage ; `board` est le rectangle du
+// plateau dans le repère du peintre
+void SnakeWidget::drawBoardBackground(QPainter &p, const QRect &board)
+{
+    QLinearGradient gameGradient(board.topLeft(), board.bottomRight());
+    gameGradient.setColorAt(0, QColor(5, 5, 20));
+    gameGradient.setColorAt(1, QColor(8, 8, 25));
+    p.fillRect(board, gameGradient);
+
+    p.setPen(QPen(QColor(0, 220, 170), 3));
+    p.drawRect(board.adjusted(1, 1, -1, -1));
+    p.setPen(QPen(QColor(0, 255, 200, 100), 1));
+    p.drawRect(board.adjusted(3, 3, -3, -3));
+
+    p.setPen(QPen(QColor(0, 100, 100), 1));
+    for (int x = 1; x < boardWidth(); ++x)
+        p.drawLine(board.left() + x * cellSize, board.top(),
+                   board.left() + x * cellSize, board.top() + board.height());
+    for (int y = 1; y < boardHeight(); ++y)
+        p.drawLine(board.left(), board.top() + y * cellSize,
+                   board.left() + board.width(), board.top() + y * cellSize);
 }
 
 void SnakeWidget::keyPressEvent(QKeyEvent *event)
@@ -847,8 +2036,46 @@ void SnakeWidget::keyPressEvent(QKeyEvent *event)
         return;
     }
 
+    if (event->key() == Qt::Key_F3)
+    {
+        showTiming = !showTiming;
+        update();
+        return;
+    }
+
+    if (arenaMode && event->key() == Qt::Key_T)
+    {
+        cycleTurbo();
+        return;
+    }
+
+    if (arenaMode && event->key() == Qt::Key_B)
+    {
+        autopilot = !autopilot;
+        applyAutopilot();
+        return;
+    }
+
+    if (event->key() == Qt::Key_H && !arenaMode)
+    {
+        heatMode = static_cast<HeatMode>((heatMode + 1) % (HEAT_DEATHS + 1));
+        loadHeatMap();
+        update();
+        return;
+    }
+
+    if (event->key() == Qt::Key_F4)
+    {
+        tiledRendering = !tiledRendering;
+        tiles.clear();
+        update();
+        return;
+    }
+
     if (event->key() == Qt::Key_Escape)
     {
+        suspendSolo();
+        stopArenaLoop();
         emit backToMenu();
         return;
     }
@@ -858,26 +2085,47 @@ void SnakeWidget::keyPressEvent(QKeyEvent *event)
         if (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter)
         {
             waitingStart = false;
-            game.reset();
             lastScore = 0;
             scorePopups.clear();
-            timer.start(game.getSpeed());
+            restartCurrentMode();
             update();
         }
         return;
     }
 
-    if (game.isGameOver() || isPaused)
+    if (isOver() || isPaused)
+    {
+        return;
+    }
+
+    if (arenaMode)
     {
+        // J1 : flèches, J2 : ZQSD (AZERTY) ou WASD (QWERTY)
+        switch (event->key())
+        {
+        case Qt::Key_Up: arena.changeDirection(0, UP); break;
+        case Qt::Key_Down: arena.changeDirection(0, DOWN); break;
+        case Qt::Key_Left: arena.changeDirection(0, LEFT); break;
+        case Qt::Key_Right: arena.changeDirection(0, RIGHT); break;
+        case Qt::Key_Z:
+        case Qt::Key_W: arena.changeDirection(1, UP); break;
+        case Qt::Key_S: arena.changeDirection(1, DOWN); break;
+        case Qt::Key_Q:
+        case Qt::Key_A: arena.changeDirection(1, LEFT); break;
+        case Qt::Key_D: arena.changeDirection(1, RIGHT); break;
+        default:
+            QWidget::keyPressEvent(event);
+            break;
+        }
         return;
     }
 
     switch (event->key())
     {
-    case Qt::Key_Up: game.changeDirection(UP); break;
-    case Qt::Key_Down: game.changeDirection(DOWN); break;
-    case Qt::Key_Left: game.changeDirection(LEFT); break;
-    case Qt::Key_Right: game.changeDirection(RIGHT); break;
+    case Qt::Key_Up: sim.changeDirection(UP); break;
+    case Qt::Key_Down: sim.changeDirection(DOWN); break;
+    case Qt::Key_Left: sim.changeDirection(LEFT); break;
+    case Qt::Key_Right: sim.changeDirection(RIGHT); break;
     default:
         QWidget::keyPressEvent(event);
         break;
@@ -890,15 +2138,230 @@ void SnakeWidget::mouseDoubleClickEvent(QMouseEvent *event)
     toggleFullscreen();
 }
 
+// Arène seulement : le mode solo avance sur le thread de jeu. Un pas par
+// appel, ou en turbo tous les pas dus depuis l'image précédente ; dans
+// les deux cas une seule image demandée.
 void SnakeWidget::gameLoop()
 {
-    game.updateGame();
+    if (turboFactor == 1)
+        arena.tick();
+    else
+        runTurboTicks();
 
-    if (game.isGameOver())
+    if (arena.isOver())
     {
         timer.stop();
         setupGameOverButtons();
     }
+    else if (timer.interval() != loopInterval())
+    {
+        timer.setInterval(loopInterval());
+    }
+
+    update();
+}
+
+// Pas dus au multiple choisi depuis l'appel précédent, ou autant que le
+// budget d'une image le permet ; au-delà du budget, le retard est
+// abandonné plutôt que rattrapé (le rendu passerait après)
+void SnakeWidget::runTurboTicks()
+{
+    qint64 elapsedNs = qMin<qint64>(turboClock.nsecsElapsed(), 100 * 1000000LL);
+    turboClock.start();
+    if (turboFactor > 0)
+        turboDebt += elapsedNs / 1e6 * turboFactor / arena.getSpeed();
+    QElapsedTimer budget;
+    budget.start();
+    int played = 0;
+    while (!arena.isOver() && (turboFactor == 0 || turboDebt >= 1.0))
+    {
+        arena.tick();
+        ++played;
+        turboDebt = qMax(0.0, turboDebt - 1.0);
+        if (budget.nsecsElapsed() >= TURBO_BUDGET_MS * 1000000LL)
+        {
+            turboDebt = 0.0;
+            break;
+        }
+    }
+
+    turboTicks += played;
+    qint64 rateNs = turboRateClock.nsecsElapsed();
+    if (rateNs >= 500 * 1000000LL)
+    {
+        ticksPerSecond = turboTicks * 1e9 / rateNs;
+        turboTicks = 0;
+        turboRateClock.start();
+    }
+}
+
+// Retour au menu : plus aucun pas d'arène derrière lui, et la prochaine
+// partie repart à vitesse normale
+void SnakeWidget::stopArenaLoop()
+{
+    timer.stop();
+    turboFactor = 1;
+    turboDebt = 0.0;
+    turboTicks = 0;
+    ticksPerSecond = 0.0;
+}
+
+void SnakeWidget::cycleTurbo()
+{
+    static const int FACTORS[] = {1, 4, 16, 64, 0};
+    int next = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        if (FACTORS[i] == turboFactor)
+            next = (i + 1) % 5;
+    }
+    turboFactor = FACTORS[next];
+    turboDebt = 0.0;
+    turboTicks = 0;
+    ticksPerSecond = 0.0;
+    turboClock.start();
+    turboRateClock.start();
+    if (turboFactor != 1)
+    {
+        scorePopups.clear();
+        popupTimer.stop();
+    }
+    if (timer.isActive())
+        timer.start(loopInterval());
+    update();
+}
+
+void SnakeWidget::applyAutopilot()
+{
+    for (int id = 0; id < arena.playerCount(); ++id)
+        arena.setBotControlled(id, autopilot);
+}
+
+// Thread graphique, après chaque pas du thread de jeu. Les fruits mangés
+// arrivent par leur propre file : aucun n'est perdu si des états sont
+// remplacés avant d'être lus.
+void SnakeWidget::onSnapshotReady()
+{
+    SimEvent event;
+    while (sim.nextEvent(event))
+    {
+        if (!arenaMode && event.gameId == gameId)
+            onFruitEaten(event.x, event.y, event.points, event.type);
+    }
+
+    if (!sim.updateSnapshot() || arenaMode || view().gameId != gameId)
+        return;
 
+    updateCellSize();  // une carte peut changer les dimensions
+    if (isPaused)
+        setupPauseButtons();   // partie reprise : dimensions connues seulement ici
+    if (view().gameOver && !gameOverShown)
+    {
+        gameOverShown = true;
+        recordGame();
+        saveReplay();
+        if (heatMode != HEAT_OFF)
+            loadHeatMap();   // le thread de jeu vient d'écrire cette partie
+        setupGameOverButtons();
+    }
     update();
 }
+
+QColor SnakeWidget::snakeTint(int id) const
+{
+    if (id <= 0)
+        return QColor();  // J1 garde le vert d'origine
+    if (id == 1 && arena.playerCount() > 1)
+        return QColor(80, 160, 255);
+    // Teintes réparties sur le cercle chromatique (angle d'or)
+    return QColor::fromHsv((id * 137) % 360, 170, 230);
+}
+
+QString SnakeWidget::snakeLabel(int id) const
+{
+    if (id < 0)
+        return "-";
+    if (id < arena.playerCount())
+        return QString("J%1").arg(id + 1);
+    return QString("B%1").arg(id - arena.playerCount() + 1);
+}
+
+void SnakeWidget::drawArenaSnakes(QPainter &p, int offsetX, int offsetY, DetailLevel detail)
+{
+    outlineRects.clear();
+    for (int id = 0; id < arena.snakeCount(); ++id)
+    {
+        const ArenaSnake &s = arena.snake(id);
+        if (!s.alive)
+            continue;
+
+        QColor tint = snakeTint(id);
+        for (int i = s.length - 1; i >= 0; --i)
+        {
+            int cell = s.segmentCell(i);
+            QRect r(offsetX + arena.cellX(cell) * cellSize,
+                    offsetY + arena.cellY(cell) * cellSize,
+                    cellSize, cellSize);
+            float segmentRatio = static_cast<float>(i) / s.length;
+            if (detail == DETAIL_FULL)
+            {
+                drawSnakeSegment(p, r, i == 0, segmentRatio, s.direction, tint);
+            }
+            else
+            {
+                p.fillRect(r.adjusted(1, 1, -1, -1), segmentColor(i == 0, segmentRatio, tint));
+                outlineRects.append(r.adjusted(1, 1, -2, -2));
+            }
+        }
+    }
+    drawOutlines(p, QColor(10, 10, 30));
+}
+
+void SnakeWidget::drawArenaHud(QPainter &p, int offsetX, int hudY)
+{
+    // Meilleurs scores d'abord ; au plus 6 serpents affichés
+    QVector<int> order(arena.snakeCount());
+    for (int id = 0; id < order.size(); ++id)
+        order[id] = id;
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return arena.snake(a).score > arena.snake(b).score;
+    });
+
+    int x = offsetX + 20;
+    int shown = qMin(6, static_cast<int>(order.size()));
+    for (int k = 0; k < shown; ++k)
+    {
+        int id = order[k];
+        const ArenaSnake &s = arena.snake(id);
+        QColor color = snakeTint(id);
+        if (!color.isValid())
+            color = QColor(0, 255, 140);
+        if (!s.alive)
+            color.setAlpha(110);
+
+        // Le libellé ne change que si le classement change
+        HudText &text = hud.arenaScores[k];
+        if (hud.arenaScoreIds[k] != id)
+        {
+            hud.arenaScoreIds[k] = id;
+            text.setFormat(snakeLabel(id) + " : %1");
+        }
+        text.setValue(s.score);
+        text.draw(p, x, hudY, color);
+        x += text.width() + 24;
+    }
+
+    hud.alive.setValues(arena.aliveCount(), arena.snakeCount());
+    hud.alive.draw(p, x, hudY, QColor(255, 150, 255));
+    hud.arenaHelp.draw(p, offsetX + 20, hudY + 25, QColor(150, 150, 150));
+
+    if (turboFactor != 1)
+    {
+        HudText &turbo = turboFactor > 0 ? hud.turbo : hud.turboMax;
+        if (turboFactor > 0)
+            turbo.setValues(turboFactor, qRound(ticksPerSecond));
+        else
+            turbo.setValue(qRound(ticksPerSecond));
+        turbo.draw(p, x + hud.alive.width() + 24, hudY, QColor(255, 200, 0));
+    }
+}
@@ -3,8 +3,17 @@
 
 #include <QWidget>
 #include <QTimer>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
 #include <QPushButton>
+#include <QElapsedTimer>
+#include <QHash>
 #include "game.h"
+#include "arena.h"
+#include "hudtext.h"
+#include "leaderboard.h"
+#include "simthread.h"
 
 struct ScorePopup
 {
@@ -16,6 +25,61 @@ struct ScorePopup
     FruitType fruitType;
 };
 
+// État figé affiché à la place du thread de jeu (banc de rendu,
+// tools/render_bench.cpp)
+struct RenderScene
+{
+    SimSnapshot state;
+    int cellSize = 25;
+    bool paused = false;
+    int bestScore = 0;
+    QVector<ScorePopup> popups;
+};
+
+// Textes de l'interface (bandeau, pause, fin de partie, accueil), créés
+// une fois avec leur police ; chacun n'est remis en page que si sa valeur
+// change
+struct SnakeHud
+{
+    HudText score;
+    HudText length;
+    HudText best;
+    HudText level;
+    int levelShown;                 // niveau du libellé, -1 : à refaire
+    HudText help;
+    HudText speedEffect;
+    HudText ghostEffect;
+
+    QVector<HudText> arenaScores;   // au plus 6 serpents affichés
+    QVector<int> arenaScoreIds;     // serpent de chaque ligne, -1 : à refaire
+    HudText alive;
+    HudText arenaHelp;
+    HudText turbo;
+    HudText turboMax;
+
+    HudText pauseTitle;
+    HudText pauseScore;
+    HudText pauseHint;
+
+    HudText overTitle;
+    HudText winner;
+    int winnerId;                   // serpent du libellé, -2 : à refaire
+    HudText record;
+    HudText finalScore;
+    HudText cause;
+    HudText unrankedFrenzy;
+    HudText unrankedHazards;
+    HudText bestLine;
+    HudText rank;                   // posé par recordGame()
+
+    HudText startTitle;
+    HudText startPrompt;
+    QVector<HudText> startFruits;
+
+    QHash<int, HudText> popups;     // par nombre de points
+    QVector<HudText> timing;        // F3
+};
+
 class SnakeWidget : public QWidget
 {
     Q_OBJECT
@@ -24,10 +88,25 @@ public:
     explicit SnakeWidget(QWidget *parent = nullptr);
     void startGameDirectly();
     void setLevel(int level);  // NOUVEAU : définir le niveau
+    void setLevelTable(const LevelTable &table);  // vitesse et murs de chaque niveau
+    void setLayoutStyle(LayoutStyle style) { settings.layout = style; }
+    void setFoodCount(int count) { settings.foods = count; }  // mode frénésie
+    void setHazardCount(int count) { settings.hazards = count; }  // mode dangers
+    void startArena(int players, int bots);
+    bool loadMap(const QString &path, QString *error = nullptr);  // mode solo
+    void warmUp();  // à appeler au repos, avant la première partie
+    void showScene(const RenderScene &scene);
+    void setTiledRendering(bool on) { tiledRendering = on; tiles.clear(); }  // F4
+    // Partie solo interrompue (fermeture, menu, arrêt brutal), reprise en
+    // pause avec ses réglages ; faux s'il n'y en a pas
+    static QString autosavePath();
+    bool resumeSavedGame();
+    void shutdown();  // fermeture : sauvegarde la partie et arrête le thread de jeu
 
 signals:
     void backToMenu();
     void requestFullscreen(bool fullscreen);
+    void firstFramePainted();   // profil de démarrage
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -40,6 +119,7 @@ private slots:
     void onRestartClicked();
     void onMenuClicked();
     void onFruitEaten(int x, int y, int points, FruitType type);
+    void onSnapshotReady();
     void updateScorePopups();
 
     void onPauseResumeClicked();
@@ -47,30 +127,167 @@ private slots:
     void onPauseMenuClicked();
 
 private:
-    Game game;
-    QTimer timer;
+    // Niveau de détail selon la taille des cases : sous ~14 px, reflets,
+    // yeux, écailles et joints de briques ne se voient plus
+    enum DetailLevel
+    {
+        DETAIL_FULL,     // dégradés, yeux, écailles, briques
+        DETAIL_SIMPLE,   // aplat et contour
+        DETAIL_PIXEL     // une case = un pixel d'une image agrandie
+    };
+    static constexpr int DETAIL_FULL_MIN = 14;    // px par case
+    static constexpr int DETAIL_SIMPLE_MIN = 8;
+    static constexpr int REPLAYS_KEPT = 50;       // parties solo gardées
+
+    // Turbo de l'arène (T) : multiples de la vitesse du niveau, 0 pour
+    // aussi vite que le processeur le permet. Les pas dus sont joués par
+    // paquets, une image par période d'affichage.
+    static constexpr int TURBO_FRAME_MS = 16;     // ~60 images/s
+    static constexpr int TURBO_BUDGET_MS = 12;    // le reste pour le rendu
+
+    // Carte de chaleur (H) : passages de la tête, puis morts, par case
+    enum HeatMode
+    {
+        HEAT_OFF,
+        HEAT_VISITS,
+        HEAT_DEATHS
+    };
+
+    // Rendu en tuiles des grands plateaux (4K, plusieurs écrans) : tuiles
+    // de TILE_CELLS x TILE_CELLS cases, dessinées en parallèle chacune
+    // dans son image puis posées ; une tuile dont les cases (et leurs
+    // voisines, que les ombres débordent) n'ont pas changé garde son image
+    static constexpr int TILE_CELLS = 8;
+    static constexpr int TILED_MIN_PIXELS = 1920 * 1080;
+    struct BoardTile
+    {
+        QImage image;
+        quint64 signature = 0;
+        bool valid = false;
+    };
+
+    // Partie solo sur son propre thread ; l'affichage ne lit que ses états
+    SimThread sim;
+    SimSettings settings;
+    bool sceneMode;          // showScene() : frozenState remplace le thread
+    SimSnapshot frozenState;
+    quint32 gameId;          // dernière partie solo lancée
+    bool gameOverShown;
+    bool showTiming;         // F3 : régularité des pas et temps de rendu
+    qint64 lastPaintNs;
+    Arena arena;
+    bool arenaMode;
+    QTimer timer;            // pas de l'arène, ou images en turbo
+    int turboFactor;         // 1 : vitesse normale
+    double turboDebt;        // pas dus, fraction comprise
+    QElapsedTimer turboClock;
+    quint64 turboTicks;      // depuis turboRateClock
+    QElapsedTimer turboRateClock;
+    double ticksPerSecond;
+    bool autopilot;          // B : serpents des joueurs confiés aux bots
     QTimer popupTimer;
     int cellSize;
     bool isFullscreen;
     int bestScore;
+    Leaderboard leaderboard;
     bool waitingStart;
     int lastScore;
     bool isPaused;
+    bool framePainted;
 
-    QPushButton *restartButton;
+    QPushButton *restartButton;   // créés par createButtons()
     QPushButton *menuButton;
     QPushButton *pauseResumeButton;
     QPushButton *pauseRestartButton;
     QPushButton *pauseMenuButton;
 
     QVector<ScorePopup> scorePopups;
+    SnakeHud hud;
+
+    // Fruits dessinés une fois par taille de case, puis posés en un seul
+    // appel pour tout le plateau
+    QPixmap fruitAtlas;
+    int atlasCellSize;
+    QVector<QPainter::PixmapFragment> fruitFragments;
+
+    // Niveaux réduits : contours posés en un appel, plateau en pixels
+    QVector<QRect> outlineRects;
+    QImage pixelLayer;
+
+    bool tiledRendering;     // F4 : comparaison avec le rendu d'un seul tenant
+    QVector<BoardTile> tiles;
+    int tileCols;
+    int tileRows;
+    int tileCellSize;
+    DetailLevel tileDetail;
+    qreal tileDpr;
+    QVector<quint32> cellCodes;   // par case : mur, fruit, danger, rang du segment
+    QVector<int> dirtyTiles;
+    QImage fruitAtlasImage;       // copie de l'atlas lisible hors du thread graphique
+
+    HeatMode heatMode;
+    QImage heatImage;             // un pixel par case, couleurs précalculées
 
     void toggleFullscreen();
     void togglePause();
+    void suspendSolo();
+    QByteArray screenState() const;
+    void restoreScreen(const QByteArray &data);
+    void cycleTurbo();
+    void runTurboTicks();
+    void stopArenaLoop();
+    int loopInterval() const { return turboFactor == 1 ? arena.getSpeed() : TURBO_FRAME_MS; }
+    void applyAutopilot();
+    bool isOver() const;
+    bool isRanked() const;
+    int boardWidth() const;
+    int boardHeight() const;
+    void updateCellSize();
+    void restartCurrentMode();
+    void startSolo();
+    const SimSnapshot &view() const { return sceneMode ? frozenState : sim.snapshot(); }
+    void setupHudTexts();
+    void paintScene(QPainter &p);
+    void drawBoardBackground(QPainter &p, const QRect &board);
+    void drawTiming(QPainter &p);
+    void recordGame();
+    void saveReplay();
+    QColor snakeTint(int id) const;
+    QString snakeLabel(int id) const;
+    void drawArenaSnakes(QPainter &p, int offsetX, int offsetY, DetailLevel detail);
+    void drawArenaHud(QPainter &p, int offsetX, int hudY);
+    DetailLevel detailLevel() const;
+    void drawSnake(QPainter &p, int offsetX, int offsetY, DetailLevel detail);
     void drawSnakeSegment(QPainter &p, const QRect &rect, bool isHead,
-                          float segmentRatio, Direction dir);
+                          float segmentRatio, Direction dir,
+                          const QColor &tint = QColor());
+    static QColor segmentColor(bool isHead, float segmentRatio, const QColor &tint);
+    void drawOutlines(QPainter &p, const QColor &color);
+    void drawWalls(QPainter &p, int offsetX, int offsetY, DetailLevel detail);
+    void drawWall(QPainter &p, const QRect &r);
+    void drawPixelLayer(QPainter &p, const QRect &gameRect);
+    void loadHeatMap();
+    void drawHeatMap(QPainter &p, const QRect &gameRect);
     void drawFruit(QPainter &p, const QRect &rect, FruitType type);
+    void buildFruitAtlas();
+    void ensureFruitAtlas();
+    void drawFoods(QPainter &p, int offsetX, int offsetY);
+    void drawHazards(QPainter &p, int offsetX, int offsetY, DetailLevel detail);
+    void drawHazard(QPainter &p, const QRect &r, HazardKind kind, DetailLevel detail);
+    bool useTiles(const QRect &gameRect, DetailLevel detail) const;
+    void drawTiledBoard(QPainter &p, const QRect &gameRect, DetailLevel detail);
+    void updateCellCodes();
+    quint64 tileSignature(int tx, int ty) const;
+    void renderTile(int index);
+    void drawApple(QPainter &p, const QRect &rect);
+    void drawBanana(QPainter &p, const QRect &rect);
+    void drawPineapple(QPainter &p, const QRect &rect);
+    void drawCherry(QPainter &p, const QRect &rect);
+    void drawScissors(QPainter &p, const QRect &rect);
+    void drawBolt(QPainter &p, const QRect &rect);
+    void drawGhost(QPainter &p, const QRect &rect);
     QString getButtonStyle(const QString &color, const QString &hoverColor);
+    void createButtons();
     void setupGameOverButtons();
     void hideGameOverButtons();
     void setupPauseButtons();
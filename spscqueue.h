@@ -0,0 +1,57 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// File bornée sans verrou, un producteur et un consommateur. Chaque côté
+// garde une copie de l'indice de l'autre et ne relit l'atomique que quand
+// la file lui paraît pleine (ou vide) : en régime courant, une opération
+// ne touche que sa propre ligne de cache.
+template <typename T, int N>
+class SpscQueue
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "taille en puissance de deux");
+
+public:
+    SpscQueue() : tail(0), headCache(0), head(0), tailCache(0) {}
+
+    // Producteur : faux si la file est pleine
+    bool push(const T &value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == size_t(N))
+        {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == size_t(N))
+                return false;
+        }
+        items[t & (N - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur : faux si la file est vide
+    bool pop(T &value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache)
+        {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache)
+                return false;
+        }
+        value = items[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[N];
+    alignas(64) std::atomic<size_t> tail;
+    size_t headCache;
+    alignas(64) std::atomic<size_t> head;
+    size_t tailCache;
+};
+
+#endif // SPSCQUEUE_H
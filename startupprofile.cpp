@@ -0,0 +1,53 @@
+#include "startupprofile.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <cstdio>
+
+namespace
+{
+struct Milestone
+{
+    const char *phase;
+    qint64 ns;
+};
+
+QElapsedTimer startClock;
+QVector<Milestone> pending;
+bool enabled = false;
+
+void print(const Milestone &m)
+{
+    std::fprintf(stderr, "[demarrage] %8.1f ms  %s\n", m.ns / 1e6, m.phase);
+}
+}
+
+namespace StartupProfile
+{
+void begin()
+{
+    startClock.start();
+}
+
+void enable()
+{
+    enabled = true;
+    for (const Milestone &m : pending)
+        print(m);
+    pending.clear();
+}
+
+bool isEnabled()
+{
+    return enabled;
+}
+
+void mark(const char *phase)
+{
+    Milestone m = {phase, startClock.isValid() ? startClock.nsecsElapsed() : 0};
+    if (enabled)
+        print(m);
+    else
+        pending.append(m);
+}
+}
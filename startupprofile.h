@@ -0,0 +1,15 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+// Jalons du démarrage (Snake --profile-startup) : temps écoulé depuis le
+// début de main(). Les jalons notés avant enable() sont gardés et
+// affichés à ce moment-là, sur la sortie d'erreur.
+namespace StartupProfile
+{
+void begin();
+void enable();
+bool isEnabled();
+void mark(const char *phase);
+}
+
+#endif // STARTUPPROFILE_H
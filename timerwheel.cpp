@@ -0,0 +1,202 @@
+#include "timerwheel.h"
+
+#include <algorithm>
+
+TimerWheel::TimerWheel()
+{
+    reset();
+}
+
+void TimerWheel::reset(quint64 tick)
+{
+    current = tick;
+    nextSeq = 0;
+    pending = 0;
+    nodes.clear();
+    freeNodes.clear();
+    for (int s = 0; s <= OVERFLOW_SLOT; ++s)
+        head[s] = tail[s] = -1;
+    for (int l = 0; l < LEVELS; ++l)
+        occupied[l] = 0;
+}
+
+// Niveau : le plus haut groupe de 6 bits où l'échéance diffère du pas
+// courant. Au niveau 0, la case est donc exactement le pas d'échéance.
+int TimerWheel::slotFor(quint64 due) const
+{
+    quint64 diff = due ^ current;
+    if (diff >> (SLOT_BITS * LEVELS))
+        return OVERFLOW_SLOT;
+    int level = 0;
+    while (diff >> (SLOT_BITS * (level + 1)))
+        ++level;
+    return level * SLOTS + int((due >> (SLOT_BITS * level)) & (SLOTS - 1));
+}
+
+void TimerWheel::link(int index)
+{
+    Node &n = nodes[index];
+    int s = slotFor(n.due);
+    n.slot = s;
+    n.next = -1;
+    n.prev = tail[s];
+    if (tail[s] >= 0)
+        nodes[tail[s]].next = index;
+    else
+        head[s] = index;
+    tail[s] = index;
+    if (s < OVERFLOW_SLOT)
+        occupied[s / SLOTS] |= quint64(1) << (s % SLOTS);
+}
+
+void TimerWheel::unlink(int index)
+{
+    Node &n = nodes[index];
+    int s = n.slot;
+    if (n.prev >= 0)
+        nodes[n.prev].next = n.next;
+    else
+        head[s] = n.next;
+    if (n.next >= 0)
+        nodes[n.next].prev = n.prev;
+    else
+        tail[s] = n.prev;
+    if (head[s] < 0 && s < OVERFLOW_SLOT)
+        occupied[s / SLOTS] &= ~(quint64(1) << (s % SLOTS));
+}
+
+const TimerWheel::Node *TimerWheel::lookup(TimerId id) const
+{
+    int index = int(id & INDEX_MASK) - 1;
+    if (index < 0 || index >= nodes.size())
+        return nullptr;
+    const Node &n = nodes[index];
+    if (n.slot < 0 || (n.generation & (0xFFFFFFFFu >> INDEX_BITS)) != (id >> INDEX_BITS))
+        return nullptr;
+    return &n;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(quint64 due, int kind, int arg)
+{
+    int index;
+    if (!freeNodes.isEmpty())
+    {
+        index = freeNodes.takeLast();
+    }
+    else
+    {
+        if (nodes.size() >= int(INDEX_MASK))
+            return 0;
+        index = static_cast<int>(nodes.size());
+        nodes.append(Node());
+        nodes[index].generation = 0;
+    }
+    Node &n = nodes[index];
+    n.due = qMax(due, current + 1);
+    n.seq = nextSeq++;
+    n.kind = kind;
+    n.arg = arg;
+    link(index);
+    ++pending;
+    return ((n.generation & (0xFFFFFFFFu >> INDEX_BITS)) << INDEX_BITS) | quint32(index + 1);
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    const Node *n = lookup(id);
+    if (!n)
+        return false;
+    int index = int(id & INDEX_MASK) - 1;
+    unlink(index);
+    nodes[index].slot = -1;
+    ++nodes[index].generation;
+    freeNodes.append(index);
+    --pending;
+    return true;
+}
+
+bool TimerWheel::isPending(TimerId id) const
+{
+    return lookup(id) != nullptr;
+}
+
+quint64 TimerWheel::dueTick(TimerId id) const
+{
+    const Node *n = lookup(id);
+    return n ? n->due : 0;
+}
+
+quint64 TimerWheel::sequence(TimerId id) const
+{
+    const Node *n = lookup(id);
+    return n ? n->seq : 0;
+}
+
+// Redistribue une case d'un niveau supérieur : ses échéances sont
+// désormais assez proches pour descendre d'au moins un niveau
+void TimerWheel::cascade(int slot)
+{
+    int index = head[slot];
+    head[slot] = tail[slot] = -1;
+    if (slot < OVERFLOW_SLOT)
+        occupied[slot / SLOTS] &= ~(quint64(1) << (slot % SLOTS));
+    while (index >= 0)
+    {
+        int next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::advance(QVector<TimerEvent> &fired)
+{
+    ++current;
+
+    // Début d'un bloc de 64^l pas : les cases concernées descendent, de la
+    // plus haute à la plus basse
+    if ((current & (SLOTS - 1)) == 0)
+    {
+        int top = 1;
+        while (top < LEVELS && (current & ((quint64(1) << (SLOT_BITS * (top + 1))) - 1)) == 0)
+            ++top;
+        if (top == LEVELS)
+        {
+            cascade(OVERFLOW_SLOT);
+            top = LEVELS - 1;
+        }
+        for (int l = top; l >= 1; --l)
+        {
+            int index = int((current >> (SLOT_BITS * l)) & (SLOTS - 1));
+            if (occupied[l] & (quint64(1) << index))
+                cascade(l * SLOTS + index);
+        }
+    }
+
+    int slot = int(current & (SLOTS - 1));
+    if (!(occupied[0] & (quint64(1) << slot)))
+        return;
+
+    firing.clear();
+    for (int index = head[slot]; index >= 0; index = nodes[index].next)
+        firing.append(index);
+    head[slot] = tail[slot] = -1;
+    occupied[0] &= ~(quint64(1) << slot);
+
+    // Les cascades ont pu mélanger l'ordre d'arrivée : on rétablit celui
+    // de programmation
+    if (firing.size() > 1)
+    {
+        std::sort(firing.begin(), firing.end(), [this](int a, int b) {
+            return nodes[a].seq < nodes[b].seq;
+        });
+    }
+    for (int index : firing)
+    {
+        Node &n = nodes[index];
+        fired.append({n.kind, n.arg});
+        n.slot = -1;
+        ++n.generation;
+        freeNodes.append(index);
+    }
+    pending -= static_cast<int>(firing.size());
+}
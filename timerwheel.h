@@ -0,0 +1,83 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QVector>
+
+// Événement rendu par TimerWheel::advance()
+struct TimerEvent
+{
+    int kind;
+    int arg;
+};
+
+// Échéancier indexé par numéro de pas : roue hiérarchique de 4 niveaux de
+// 64 cases (2^24 pas d'horizon, au-delà une liste de débordement).
+// Programmer et annuler coûtent O(1) ; une échéance descend d'au plus un
+// niveau à la fois, donc O(1) amorti par événement. Un pas sans échéance
+// ne coûte qu'un test de bit, quel que soit le nombre de minuteries.
+//
+// Les événements d'un même pas sortent dans l'ordre où ils ont été
+// programmés : le déroulement ne dépend que de la suite des appels, ce qui
+// garde les parties rejouables.
+class TimerWheel
+{
+public:
+    typedef quint32 TimerId;  // 0 : aucune minuterie
+
+    TimerWheel();
+
+    // Tout annule ; le prochain advance() passe au pas tick + 1
+    void reset(quint64 tick = 0);
+    quint64 now() const { return current; }
+    int pendingCount() const { return pending; }
+
+    // Échéance au pas `due` (au plus tôt le pas suivant)
+    TimerId schedule(quint64 due, int kind, int arg);
+    bool cancel(TimerId id);
+    bool isPending(TimerId id) const;
+    quint64 dueTick(TimerId id) const;  // 0 si la minuterie n'est plus active
+    // Rang de programmation : reprogrammer des minuteries dans cet ordre
+    // garde l'ordre de sortie de celles d'un même pas (sauvegarde)
+    quint64 sequence(TimerId id) const;
+
+    // Passe au pas suivant ; ajoute à `fired` les événements échus
+    void advance(QVector<TimerEvent> &fired);
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int OVERFLOW_SLOT = LEVELS * SLOTS;
+    static constexpr int INDEX_BITS = 20;  // 2^20 - 1 minuteries simultanées
+    static constexpr quint32 INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    struct Node
+    {
+        quint64 due;
+        quint64 seq;
+        int kind;
+        int arg;
+        quint32 generation;
+        int slot;   // -1 : libre
+        int prev;
+        int next;
+    };
+
+    quint64 current;
+    quint64 nextSeq;
+    int pending;
+    QVector<Node> nodes;
+    QVector<int> freeNodes;
+    int head[OVERFLOW_SLOT + 1];
+    int tail[OVERFLOW_SLOT + 1];
+    quint64 occupied[LEVELS];   // un bit par case non vide
+    QVector<int> firing;
+
+    const Node *lookup(TimerId id) const;
+    int slotFor(quint64 due) const;
+    void link(int index);
+    void unlink(int index);
+    void cascade(int slot);
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,192 @@
+// Mémoire et vitesse du corps compact (PackedBody, 2 bits par segment)
+// face à la liste chaînée d'avant (un nœud alloué par segment), pour un
+// grand nombre de parties en mémoire : octets par partie, coût d'un pas
+// (nouvelle tête, queue retirée) et d'un parcours complet des corps. Les
+// deux représentations doivent toujours donner les mêmes cases.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QVector>
+#include "packedbody.h"
+
+// Représentation de référence, celle de Game jusqu'ici
+struct ListNode
+{
+    int x;
+    int y;
+    ListNode *next;
+    ListNode *prev;
+};
+
+struct ListBody
+{
+    ListNode *head = nullptr;
+    ListNode *tail = nullptr;
+
+    void pushHead(int x, int y)
+    {
+        ListNode *n = new ListNode{x, y, head, nullptr};
+        if (head)
+            head->prev = n;
+        else
+            tail = n;
+        head = n;
+    }
+
+    void popTail()
+    {
+        ListNode *t = tail;
+        tail = t->prev;
+        tail->next = nullptr;
+        delete t;
+    }
+
+    void clear()
+    {
+        while (head)
+        {
+            ListNode *n = head->next;
+            delete head;
+            head = n;
+        }
+        tail = nullptr;
+    }
+};
+
+// Bloc glibc 64 bits : en-tête de 8 octets, multiple de 16, 32 au minimum
+static int allocBytes(int size)
+{
+    return qMax(32, (size + 8 + 15) & ~15);
+}
+
+static void step(int &x, int &y, Direction dir, int w, int h)
+{
+    x = (x + (dir == RIGHT) - (dir == LEFT) + w) % w;
+    y = (y + (dir == DOWN) - (dir == UP) + h) % h;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Corps compact : memoire et vitesse face a la liste chainee");
+    parser.addHelpOption();
+    QCommandLineOption gamesOpt("games", "Parties en memoire.", "n", "10000");
+    QCommandLineOption lengthsOpt("lengths", "Longueurs, separees par des virgules.", "liste",
+                                  "3,30,100,1000");
+    QCommandLineOption ticksOpt("ticks", "Pas joues par partie.", "n", "100");
+    QCommandLineOption sizeOpt("size", "Cote du plateau.", "n", "256");
+    parser.addOptions({gamesOpt, lengthsOpt, ticksOpt, sizeOpt});
+    parser.process(app);
+
+    int games = qMax(1, parser.value(gamesOpt).toInt());
+    int ticks = qMax(1, parser.value(ticksOpt).toInt());
+    int size = qMax(8, parser.value(sizeOpt).toInt());
+
+    // Directions tirées d'avance : le tirage ne compte pas dans les mesures
+    QRandomGenerator rng(11);
+    QVector<Direction> dirs(4096);
+    Direction last = RIGHT;
+    for (int i = 0; i < dirs.size(); ++i)
+    {
+        Direction d = static_cast<Direction>(rng.bounded(UP, RIGHT + 1));
+        dirs[i] = (d == oppositeDirection(last)) ? last : d;
+        last = dirs[i];
+    }
+
+    QTextStream out(stdout);
+    bool mismatch = false;
+    for (const QString &field : parser.value(lengthsOpt).split(','))
+    {
+        int length = qMax(1, field.toInt());
+        QVector<PackedBody> packed(games);
+        QVector<ListBody> lists(games);
+        for (int g = 0; g < games; ++g)
+        {
+            int x = (g * 7) % size, y = (g * 13) % size;
+            packed[g].reset(size, size, x, y);
+            lists[g].pushHead(x, y);
+            for (int i = 1; i < length; ++i)
+            {
+                Direction d = dirs[(g + i) & 4095];
+                packed[g].pushHead(d);
+                step(x, y, d, size, size);
+                lists[g].pushHead(x, y);
+            }
+        }
+
+        qint64 packedBytes = 0;
+        for (const PackedBody &b : packed)
+            packedBytes += b.memoryBytes();
+        qint64 listBytes = qint64(games) * (sizeof(ListBody)
+                                            + qint64(length) * allocBytes(sizeof(ListNode)));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int t = 0; t < ticks; ++t)
+        {
+            for (int g = 0; g < games; ++g)
+            {
+                packed[g].pushHead(dirs[(g + length + t) & 4095]);
+                packed[g].popTail();
+            }
+        }
+        qint64 packedMove = timer.nsecsElapsed();
+
+        timer.start();
+        for (int t = 0; t < ticks; ++t)
+        {
+            for (int g = 0; g < games; ++g)
+            {
+                ListBody &b = lists[g];
+                int x = b.head->x, y = b.head->y;
+                step(x, y, dirs[(g + length + t) & 4095], size, size);
+                b.pushHead(x, y);
+                b.popTail();
+            }
+        }
+        qint64 listMove = timer.nsecsElapsed();
+
+        quint64 packedSum = 0, listSum = 0;
+        timer.start();
+        for (const PackedBody &b : packed)
+        {
+            quint64 k = 0;
+            for (PackedBody::Cursor c = b.cursor(); c.valid(); c.next())
+                packedSum += quint64(c.cell()) * ++k;
+        }
+        qint64 packedWalk = timer.nsecsElapsed();
+
+        timer.start();
+        for (const ListBody &b : lists)
+        {
+            quint64 k = 0;
+            for (const ListNode *n = b.head; n; n = n->next)
+                listSum += quint64(n->y * size + n->x) * ++k;
+        }
+        qint64 listWalk = timer.nsecsElapsed();
+        if (packedSum != listSum)
+            mismatch = true;
+
+        double moves = double(games) * ticks;
+        double segments = double(games) * length;
+        out << QString("longueur %1 : %2 octets/partie (compact) contre %3 (liste), "
+                       "pas %4 ns contre %5 ns, parcours %6 ns/segment contre %7")
+                   .arg(length, 5)
+                   .arg(double(packedBytes) / games, 0, 'f', 0)
+                   .arg(double(listBytes) / games, 0, 'f', 0)
+                   .arg(packedMove / moves, 0, 'f', 1)
+                   .arg(listMove / moves, 0, 'f', 1)
+                   .arg(packedWalk / segments, 0, 'f', 2)
+                   .arg(listWalk / segments, 0, 'f', 2) << Qt::endl;
+
+        for (ListBody &b : lists)
+            b.clear();
+    }
+    if (mismatch)
+        out << "ERREUR : les deux representations ne donnent pas les memes cases" << Qt::endl;
+    return mismatch ? 1 : 0;
+}
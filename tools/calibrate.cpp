@@ -0,0 +1,453 @@
+// Calibrage de la difficulté des niveaux. Des réglages candidats (durée
+// d'un pas, densité des murs de la disposition choisie) sont évalués par
+// une population de bots au temps de réaction humain, en parties sans
+// affichage sur tous les coeurs. Pour chaque niveau, le candidat retenu est
+// celui dont la survie (en secondes) et le score médians sont les plus
+// proches des cibles ; la table obtenue se charge avec `Snake --levels`.
+//
+// La vitesse n'agit sur un bot que par son temps de réaction : chaque
+// décision prend effet round(réaction / pas) pas plus tard, et le bot n'en
+// anticipe qu'une partie (il prévoit sa tête le long des virages déjà
+// décidés). Il se trompe parfois. Trois profils, du débutant à l'expert :
+// les médianes par profil donnent la courbe de difficulté de chaque niveau.
+//
+// Sélection par élimination successive : chaque tour joue de nouvelles
+// graines, les mêmes pour tous les candidats (les écarts entre candidats ne
+// viennent pas du tirage), puis seule la meilleure moitié de chaque niveau
+// continue, avec deux fois plus de parties. Départager n candidats coûte
+// ainsi quelques log2(n) fois leur premier tour, non n évaluations complètes.
+//
+//   snake_calibrate -o niveaux.txt [--candidates 2000] [--layout aleatoire]
+//       [--survival 60,30,15] [--score 40,25,10] [--games 12]
+//       [--max-games 768] [--jobs 0] [--seed 1] [--from niveaux.txt]
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtMath>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include "game.h"
+
+static constexpr int MAX_SECONDS = 600;   // partie arrêtée (survie comptée pleine)
+
+// Joueur simulé
+struct Profile
+{
+    const char *name;
+    int reactionMs;
+    int anticipation;    // part du retard compensée, en %
+    int errorPerMille;   // décisions au hasard
+};
+
+static const Profile PROFILES[] = {
+    {"debutant", 400, 0, 40},
+    {"regulier", 280, 50, 15},
+    {"expert", 180, 85, 4},
+};
+static constexpr int PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+struct Candidate
+{
+    int level;
+    LevelParams params;
+    bool alive = true;           // encore en lice
+    QVector<float> survival;     // secondes, par partie
+    QVector<int> scores;
+    double loss = 0.0;
+};
+
+// Partie g : profil g % PROFILE_COUNT, graine seed + g pour tous les candidats
+struct WorkItem
+{
+    int candidate;
+    int game;
+};
+
+static int median(QVector<int> values)
+{
+    if (values.isEmpty())
+        return 0;
+    auto mid = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), mid, values.end());
+    return *mid;
+}
+
+static float median(QVector<float> values)
+{
+    if (values.isEmpty())
+        return 0.0f;
+    auto mid = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), mid, values.end());
+    return *mid;
+}
+
+static int stepX(int x, Direction dir, int w)
+{
+    return (x + (dir == RIGHT) - (dir == LEFT) + w) % w;
+}
+
+static int stepY(int y, Direction dir, int h)
+{
+    return (y + (dir == DOWN) - (dir == UP) + h) % h;
+}
+
+// Pas sûr depuis (x, y) en allant vers `from`, au plus près d'un fruit ;
+// une case sans autre sortie libre ne vient qu'en dernier recours
+static Direction plan(const Game &game, int x, int y, Direction from)
+{
+    int w = game.boardWidth(), h = game.boardHeight();
+    auto blocked = [&game](int cx, int cy) {
+        return game.isWall(cx, cy) || game.isOccupied(cx, cy) || game.isHazard(cx, cy);
+    };
+    Direction best = from;
+    int bestCost = INT_MAX;
+    for (int d = UP; d <= RIGHT; ++d)
+    {
+        Direction dir = static_cast<Direction>(d);
+        if (dir == oppositeDirection(from))
+            continue;
+        int nx = stepX(x, dir, w), ny = stepY(y, dir, h);
+        if (blocked(nx, ny))
+            continue;
+        int exits = 0;
+        for (int e = UP; e <= RIGHT; ++e)
+            exits += !blocked(stepX(nx, static_cast<Direction>(e), w),
+                              stepY(ny, static_cast<Direction>(e), h));
+        int dist = w + h;
+        for (int i = 0; i < game.foodCount(); ++i)
+        {
+            if (fruitPoints(game.foodType(i)) <= 0)
+                continue;
+            int dx = qAbs(game.foodX(i) - nx), dy = qAbs(game.foodY(i) - ny);
+            dist = qMin(dist, qMin(dx, w - dx) + qMin(dy, h - dy));
+        }
+        int cost = dist + (exits <= 1 ? 4 * (w + h) : 0);
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            best = dir;
+        }
+    }
+    return best;
+}
+
+// Une partie d'un profil ; renvoie la survie en secondes
+static float play(Game &game, const Candidate &candidate, LayoutStyle layout,
+                  const Profile &profile, quint32 seed, int &score)
+{
+    LevelTable levels;
+    levels.setLevel(candidate.level, candidate.params);
+    game.setLevelTable(levels);
+    game.setLevel(candidate.level);
+    game.setLayoutStyle(layout);
+    game.setSeed(seed);
+    game.reset();
+
+    int tickMs = candidate.params.tickMs;
+    int lag = qMin(qRound(double(profile.reactionMs) / tickMs), 63);
+    int foresee = lag * profile.anticipation / 100;
+    quint64 maxTicks = quint64(MAX_SECONDS) * 1000 / tickMs;
+    QRandomGenerator rng(seed ^ 0x9E3779B9u);
+
+    // Décisions en route : pending[0] prend effet au prochain pas
+    Direction pending[64];
+    int pendingCount = 0;
+    int w = game.boardWidth(), h = game.boardHeight();
+    while (!game.isGameOver() && game.tickCount() < maxTicks)
+    {
+        int x = game.headX(), y = game.headY();
+        Direction dir = game.getDirection();
+        for (int i = 0; i < qMin(foresee, pendingCount); ++i)
+        {
+            if (pending[i] != oppositeDirection(dir))
+                dir = pending[i];
+            x = stepX(x, dir, w);
+            y = stepY(y, dir, h);
+        }
+        Direction choice;
+        if (int(rng.bounded(1000)) < profile.errorPerMille)
+            choice = static_cast<Direction>(rng.bounded(UP, RIGHT + 1));
+        else
+            choice = plan(game, x, y, pendingCount ? pending[pendingCount - 1] : dir);
+
+        pending[pendingCount++] = choice;
+        if (pendingCount > lag)
+        {
+            game.changeDirection(pending[0]);
+            std::copy(pending + 1, pending + pendingCount, pending);
+            --pendingCount;
+        }
+        game.updateGame();
+    }
+    score = game.getScore();
+    return float(game.tickCount() * tickMs / 1000.0);
+}
+
+static LevelParams randomParams(QRandomGenerator &rng, LayoutStyle layout,
+                                const LevelParams &base)
+{
+    LevelParams p = base;
+    p.tickMs = 60 + 5 * rng.bounded(41);   // 60 à 260 ms
+    switch (layout)
+    {
+    case LAYOUT_CLUSTERS: p.clusterPercent = rng.bounded(1, 17); break;
+    case LAYOUT_ROOMS:
+        p.roomPitch = rng.bounded(5, 17);
+        p.doorWidth = rng.bounded(1, qMin(4, p.roomPitch - 2) + 1);
+        break;
+    case LAYOUT_MAZE: p.mazePitch = rng.bounded(2, 7); break;
+    default: p.wallsPerThousand = rng.bounded(41); break;
+    }
+    return p;
+}
+
+static QString describe(const LevelParams &p, LayoutStyle layout)
+{
+    QString walls;
+    switch (layout)
+    {
+    case LAYOUT_CLUSTERS: walls = QString("amas %1 %").arg(p.clusterPercent); break;
+    case LAYOUT_ROOMS:
+        walls = QString("salles %1, portes %2").arg(p.roomPitch).arg(p.doorWidth);
+        break;
+    case LAYOUT_MAZE: walls = QString("couloirs %1").arg(p.mazePitch - 1); break;
+    default: walls = QString("%1 murs pour 1000").arg(p.wallsPerThousand); break;
+    }
+    return QString("%1 ms, %2").arg(p.tickMs).arg(walls);
+}
+
+static bool parseTargets(const QString &text, double targets[LevelTable::LEVEL_COUNT])
+{
+    QStringList f = text.split(',');
+    if (f.size() != LevelTable::LEVEL_COUNT)
+        return false;
+    for (int i = 0; i < LevelTable::LEVEL_COUNT; ++i)
+    {
+        bool ok;
+        targets[i] = f[i].toDouble(&ok);
+        if (!ok || targets[i] <= 0)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Calibrage des niveaux par des populations de bots");
+    parser.addHelpOption();
+    QCommandLineOption outOpt({"o", "output"}, "Table de niveaux ecrite (Snake --levels).",
+                              "fichier");
+    QCommandLineOption candidatesOpt("candidates", "Candidats par niveau.", "n", "2000");
+    QCommandLineOption layoutOpt("layout", "Disposition calibree : aleatoire, amas, salles, "
+                                 "labyrinthe.", "nom", "aleatoire");
+    QCommandLineOption survivalOpt("survival", "Survie mediane visee par niveau (s).", "a,b,c",
+                                   "60,30,15");
+    QCommandLineOption scoreOpt("score", "Score median vise par niveau.", "a,b,c", "40,25,10");
+    QCommandLineOption gamesOpt("games", "Parties par candidat au premier tour.", "n", "12");
+    QCommandLineOption maxGamesOpt("max-games", "Parties par candidat au dernier tour.", "n",
+                                   "768");
+    QCommandLineOption jobsOpt("jobs", "Threads de jeu (0 : un par coeur).", "n", "0");
+    QCommandLineOption seedOpt("seed", "Graine des candidats et des parties.", "n", "1");
+    QCommandLineOption fromOpt("from", "Table de depart (candidat de reference et reglages "
+                               "des autres dispositions).", "fichier");
+    parser.addOptions({outOpt, candidatesOpt, layoutOpt, survivalOpt, scoreOpt, gamesOpt,
+                       maxGamesOpt, jobsOpt, seedOpt, fromOpt});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    if (!parser.isSet(outOpt))
+        parser.showHelp(2);
+
+    static const char *const LAYOUT_NAMES[LAYOUT_COUNT] = {"aleatoire", "amas", "salles",
+                                                           "labyrinthe"};
+    int layoutIndex = 0;
+    while (layoutIndex < LAYOUT_COUNT && parser.value(layoutOpt) != LAYOUT_NAMES[layoutIndex])
+        ++layoutIndex;
+    double survivalTarget[LevelTable::LEVEL_COUNT], scoreTarget[LevelTable::LEVEL_COUNT];
+    if (layoutIndex == LAYOUT_COUNT || !parseTargets(parser.value(survivalOpt), survivalTarget)
+        || !parseTargets(parser.value(scoreOpt), scoreTarget))
+        parser.showHelp(2);
+    LayoutStyle layout = static_cast<LayoutStyle>(layoutIndex);
+
+    LevelTable start;
+    if (parser.isSet(fromOpt))
+    {
+        QString error;
+        if (!start.load(parser.value(fromOpt), &error))
+        {
+            out << parser.value(fromOpt) << " : " << error << Qt::endl;
+            return 1;
+        }
+    }
+
+    // Candidat 0 de chaque niveau : la table de départ, pour comparaison
+    int perLevel = qMax(1, parser.value(candidatesOpt).toInt());
+    quint32 seed = parser.value(seedOpt).toUInt();
+    QRandomGenerator rng(seed);
+    QVector<Candidate> candidates;
+    for (int level = 1; level <= LevelTable::LEVEL_COUNT; ++level)
+    {
+        for (int i = 0; i < perLevel; ++i)
+        {
+            Candidate c;
+            c.level = level;
+            c.params = i == 0 ? start.level(level) : randomParams(rng, layout, start.level(level));
+            candidates.append(c);
+        }
+    }
+
+    int jobs = parser.value(jobsOpt).toInt();
+    if (jobs <= 0)
+        jobs = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    out << QString("%1 candidats par niveau, disposition %2, %3 threads")
+               .arg(perLevel).arg(LAYOUT_NAMES[layout]).arg(jobs) << Qt::endl;
+
+    QElapsedTimer total;
+    total.start();
+    qint64 gamesPlayed = 0;
+    int played = 0;
+    int target = qMax(PROFILE_COUNT, parser.value(gamesOpt).toInt());
+    int maxGames = qMax(target, parser.value(maxGamesOpt).toInt());
+    for (int round = 1;; ++round)
+    {
+        // Nouvelles parties g = played .. target - 1 de chaque candidat en lice
+        QVector<WorkItem> work;
+        for (int c = 0; c < candidates.size(); ++c)
+        {
+            if (!candidates[c].alive)
+                continue;
+            candidates[c].survival.resize(target);
+            candidates[c].scores.resize(target);
+            for (int g = played; g < target; ++g)
+                work.append({c, g});
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        std::atomic<int> next(0);
+        Candidate *pool = candidates.data();
+        QVector<QFuture<void>> workers;
+        for (int j = 0; j < jobs; ++j)
+        {
+            workers.append(QtConcurrent::run([&, pool]() {
+                Game game;
+                for (int i = next++; i < work.size(); i = next++)
+                {
+                    Candidate &c = pool[work[i].candidate];
+                    int g = work[i].game;
+                    c.survival[g] = play(game, c, layout, PROFILES[g % PROFILE_COUNT],
+                                         seed + quint32(g), c.scores[g]);
+                }
+            }));
+        }
+        for (QFuture<void> &worker : workers)
+            worker.waitForFinished();
+        gamesPlayed += work.size();
+        played = target;
+
+        // Écart aux cibles, en rapport (log) : 2x trop long compte comme 2x trop court
+        bool settled = true;
+        for (int level = 1; level <= LevelTable::LEVEL_COUNT; ++level)
+        {
+            QVector<Candidate *> inRace;
+            for (Candidate &c : candidates)
+            {
+                if (c.level != level || !c.alive)
+                    continue;
+                double s = qLn(qMax(0.1, double(median(c.survival))) / survivalTarget[level - 1]);
+                double p = qLn((median(c.scores) + 1.0) / (scoreTarget[level - 1] + 1.0));
+                c.loss = s * s + p * p;
+                inRace.append(&c);
+            }
+            std::sort(inRace.begin(), inRace.end(),
+                      [](const Candidate *a, const Candidate *b) { return a->loss < b->loss; });
+            if (target < maxGames)
+            {
+                for (int i = (inRace.size() + 1) / 2; i < inRace.size(); ++i)
+                    inRace[i]->alive = false;
+            }
+            if ((inRace.size() + 1) / 2 > 1)
+                settled = false;
+        }
+        double seconds = qMax(timer.nsecsElapsed() / 1e9, 1e-9);
+        out << QString("tour %1 : %2 parties par candidat, %3 parties en %4 s (%5 parties/s)")
+                   .arg(round).arg(target).arg(work.size()).arg(seconds, 0, 'f', 1)
+                   .arg(work.size() / seconds, 0, 'f', 0) << Qt::endl;
+        if (target >= maxGames || settled)
+            break;
+        target = qMin(maxGames, target * 2);
+    }
+
+    // Meilleur candidat de chaque niveau parmi ceux restés en lice
+    LevelTable result = start;
+    QString comment = QString("snake_calibrate : disposition %1, %2 candidats par niveau, "
+                              "%3 parties")
+                          .arg(LAYOUT_NAMES[layout]).arg(perLevel).arg(gamesPlayed);
+    out << Qt::endl;
+    for (int level = 1; level <= LevelTable::LEVEL_COUNT; ++level)
+    {
+        const Candidate *best = nullptr;
+        const Candidate *reference = nullptr;
+        for (const Candidate &c : candidates)
+        {
+            if (c.level != level)
+                continue;
+            if (!reference)
+                reference = &c;
+            if (c.alive && (!best || c.loss < best->loss))
+                best = &c;
+        }
+        result.setLevel(level, best->params);
+        QString summary = QString("niveau %1 : %2 ; survie %3 s (cible %4), score %5 (cible %6)")
+                              .arg(level).arg(describe(best->params, layout))
+                              .arg(median(best->survival), 0, 'f', 0).arg(survivalTarget[level - 1])
+                              .arg(median(best->scores)).arg(scoreTarget[level - 1]);
+        out << summary << Qt::endl;
+        comment += "\n" + summary;
+
+        // Courbe par profil, sur les parties du dernier tour
+        for (int p = 0; p < PROFILE_COUNT; ++p)
+        {
+            QVector<float> survival;
+            QVector<int> scores;
+            for (int g = p; g < best->survival.size(); g += PROFILE_COUNT)
+            {
+                survival.append(best->survival[g]);
+                scores.append(best->scores[g]);
+            }
+            out << QString("  %1 survie %2 s, score %3")
+                       .arg(PROFILES[p].name, -9).arg(median(survival), 0, 'f', 0)
+                       .arg(median(scores)) << Qt::endl;
+        }
+        if (reference != best)
+            out << QString("  depart (%1) : ecart %2 sur %3 parties, retenu %4")
+                       .arg(describe(reference->params, layout))
+                       .arg(reference->loss, 0, 'f', 3).arg(reference->survival.size())
+                       .arg(best->loss, 0, 'f', 3) << Qt::endl;
+    }
+
+    double seconds = qMax(total.nsecsElapsed() / 1e9, 1e-9);
+    out << Qt::endl << QString("%1 parties en %2 s : %3 parties/s, %4 candidats par heure "
+                               "au rythme de ce calibrage")
+                           .arg(gamesPlayed).arg(seconds, 0, 'f', 1)
+                           .arg(gamesPlayed / seconds, 0, 'f', 0)
+                           .arg(candidates.size() / seconds * 3600, 0, 'f', 0) << Qt::endl;
+
+    QString error;
+    if (!result.save(parser.value(outOpt), comment, &error))
+    {
+        out << parser.value(outOpt) << " : " << error << Qt::endl;
+        return 1;
+    }
+    out << "Table ecrite dans " << parser.value(outOpt) << Qt::endl;
+    return 0;
+}
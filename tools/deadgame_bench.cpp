@@ -0,0 +1,161 @@
+// Parties perdues d'avance : combien de pas un lot d'auto-apprentissage
+// économise en arrêtant une partie dès que Game::isDoomed() le signale,
+// plutôt qu'au choc. Joue des parties avec un bot glouton bruité, puis
+// les rejoue (mêmes graines) sans détection pour mesurer son coût.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+#include "game.h"
+
+// Bot : se rapproche du fruit le plus proche en évitant murs et corps,
+// avec un coup au hasard de temps en temps. En mode survie, il préfère
+// d'abord la case dont la région libre est la plus grande (requête O(1)).
+static Direction chooseMove(const Game &game, QRandomGenerator &rng, int noisePercent, bool survival)
+{
+    int w = game.boardWidth(), hgt = game.boardHeight();
+    Direction safe[4];
+    int safeCount = 0;
+    Direction best = game.getDirection();
+    qint64 bestScore = 0;
+    for (int d = UP; d <= RIGHT; ++d)
+    {
+        Direction dir = static_cast<Direction>(d);
+        if (dir == oppositeDirection(game.getDirection()))
+            continue;
+        int x = game.headX() + (dir == RIGHT) - (dir == LEFT);
+        int y = game.headY() + (dir == DOWN) - (dir == UP);
+        x = (x + w) % w;
+        y = (y + hgt) % hgt;
+        if (game.isWall(x, y) || game.isOccupied(x, y))
+            continue;
+        safe[safeCount++] = dir;
+
+        int dist = w + hgt;
+        for (int i = 0; i < game.foodCount(); ++i)
+        {
+            int dx = qAbs(game.foodX(i) - x), dy = qAbs(game.foodY(i) - y);
+            dist = qMin(dist, qMin(dx, w - dx) + qMin(dy, hgt - dy));
+        }
+        qint64 score = dist;
+        if (survival)
+        {
+            const FreeSpaceTracker &space = game.freeSpace();
+            score -= qint64(w + hgt) * space.componentSize(space.componentOf(y * w + x));
+        }
+        if (safeCount == 1 || score < bestScore)
+        {
+            bestScore = score;
+            best = dir;
+        }
+    }
+    if (safeCount > 0 && int(rng.bounded(100)) < noisePercent)
+        return safe[rng.bounded(safeCount)];
+    return best;
+}
+
+struct RunResult
+{
+    qint64 ticks = 0;
+    qint64 savedTicks = 0;
+    int doomedGames = 0;
+    int falsePositives = 0;
+    qint64 nanos = 0;
+    qint64 splits = 0;
+    QVector<int> leads;  // pas entre la détection et le choc
+};
+
+static RunResult play(int games, int level, LayoutStyle layout, int noise, bool survival,
+                      int maxTicks, bool detect)
+{
+    RunResult r;
+    Game game;
+    game.setLevel(level);
+    game.setLayoutStyle(layout);
+    QElapsedTimer timer;
+    for (int g = 0; g < games; ++g)
+    {
+        game.setSeed(1000 + g);
+        game.reset();
+        QRandomGenerator bot(5000 + g);
+        int doomedAt = -1;
+        int t = 0;
+        timer.start();
+        while (!game.isGameOver() && t < maxTicks)
+        {
+            game.changeDirection(chooseMove(game, bot, noise, survival));
+            game.updateGame();
+            ++t;
+            if (detect && doomedAt < 0 && !game.isGameOver() && game.isDoomed())
+                doomedAt = t;
+        }
+        r.nanos += timer.nsecsElapsed();
+        r.ticks += t;
+        r.splits += game.freeSpace().splitSearches();
+        if (doomedAt < 0)
+            continue;
+        if (!game.isGameOver())
+        {
+            ++r.falsePositives;
+            continue;
+        }
+        ++r.doomedGames;
+        r.savedTicks += t - doomedAt;
+        r.leads.append(t - doomedAt);
+    }
+    return r;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Parties condamnees : pas economises par la detection precoce");
+    parser.addHelpOption();
+    QCommandLineOption gamesOpt("games", "Nombre de parties.", "n", "2000");
+    QCommandLineOption levelOpt("level", "Niveau 1..3.", "n", "2");
+    QCommandLineOption layoutOpt("layout", "Terrain 0..3 (aleatoire, amas, salles, labyrinthe).", "n", "0");
+    QCommandLineOption noiseOpt("noise", "Coups au hasard du bot, en %.", "pct", "10");
+    QCommandLineOption survivalOpt("survival", "Bot qui evite les petites regions libres.");
+    QCommandLineOption maxOpt("max-ticks", "Pas maximum par partie.", "n", "20000");
+    parser.addOptions({gamesOpt, levelOpt, layoutOpt, noiseOpt, survivalOpt, maxOpt});
+    parser.process(app);
+
+    int games = qMax(1, parser.value(gamesOpt).toInt());
+    int level = parser.value(levelOpt).toInt();
+    LayoutStyle layout = static_cast<LayoutStyle>(qBound(0, parser.value(layoutOpt).toInt(), LAYOUT_COUNT - 1));
+    int noise = qBound(0, parser.value(noiseOpt).toInt(), 100);
+    bool survival = parser.isSet(survivalOpt);
+    int maxTicks = qMax(1, parser.value(maxOpt).toInt());
+
+    QTextStream out(stdout);
+    RunResult base = play(games, level, layout, noise, survival, maxTicks, false);
+    RunResult det = play(games, level, layout, noise, survival, maxTicks, true);
+
+    std::sort(det.leads.begin(), det.leads.end());
+    int median = det.leads.isEmpty() ? 0 : det.leads[det.leads.size() / 2];
+    int p90 = det.leads.isEmpty() ? 0 : det.leads[det.leads.size() * 9 / 10];
+
+    out << QString("%1 parties, %2 pas joues").arg(games).arg(det.ticks) << Qt::endl;
+    out << QString("Condamnees avant le choc : %1 (%2 %)")
+               .arg(det.doomedGames).arg(100.0 * det.doomedGames / games, 0, 'f', 1) << Qt::endl;
+    out << QString("Pas economises en arretant a la detection : %1 (%2 % du total), "
+                   "avance mediane %3 pas, p90 %4 pas")
+               .arg(det.savedTicks).arg(100.0 * det.savedTicks / qMax<qint64>(1, det.ticks), 0, 'f', 1)
+               .arg(median).arg(p90) << Qt::endl;
+    out << QString("Cout par pas : %1 ns sans requete, %2 ns avec isDoomed() a chaque pas ; "
+                   "%3 parcours de coupure par partie")
+               .arg(double(base.nanos) / qMax<qint64>(1, base.ticks), 0, 'f', 0)
+               .arg(double(det.nanos) / qMax<qint64>(1, det.ticks), 0, 'f', 0)
+               .arg(double(det.splits) / games, 0, 'f', 1) << Qt::endl;
+
+    if (det.falsePositives > 0)
+    {
+        out << "ERREUR : " << det.falsePositives << " parties condamnees ont survecu" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Banc de latence du serveur d'environnement : lance un serveur dans un
+// processus fils (sauf --attach), puis mesure l'aller-retour d'un pas de
+// lot complet vu par le client.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "envclient.h"
+#include "envserver.h"
+
+static double percentile(QVector<double> &sorted, double p)
+{
+    if (sorted.isEmpty())
+        return 0.0;
+    int n = static_cast<int>(sorted.size());
+    int idx = qBound(0, static_cast<int>(p * (n - 1) + 0.5), n - 1);
+    return sorted[idx];
+}
+
+int main(int argc, char *argv[])
+{
+    // Le serveur fils est créé avant QCoreApplication : aucun état Qt
+    // n'est dupliqué par fork()
+    QString name = QString(ENV_DEFAULT_NAME) + QString("_bench_%1").arg(getpid());
+    bool attach = false;
+    for (int i = 1; i < argc; ++i)
+        if (QByteArray(argv[i]) == "--attach")
+            attach = true;
+
+    pid_t child = -1;
+    if (!attach)
+    {
+        child = fork();
+        if (child == 0)
+        {
+            EnvServer server(name);
+            if (!server.start())
+                _exit(1);
+            server.run();
+            _exit(0);
+        }
+    }
+
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Latence aller-retour du serveur d'environnement");
+    parser.addHelpOption();
+    QCommandLineOption attachOpt("attach", "Utiliser un serveur deja lance (--name).");
+    QCommandLineOption nameOpt("name", "Nom du segment avec --attach.", "nom", ENV_DEFAULT_NAME);
+    QCommandLineOption batchOpt("batch", "Jeux par lot.", "n", "64");
+    QCommandLineOption stepsOpt("steps", "Pas mesures.", "n", "100000");
+    QCommandLineOption gridOpt("grid", "Demander la grille d'observation.");
+    QCommandLineOption foodOpt("foods", "Fruits par jeu (0 : defaut).", "n", "0");
+    QCommandLineOption hazardOpt("hazards", "Dangers mobiles par jeu.", "n", "0");
+    parser.addOptions({attachOpt, nameOpt, batchOpt, stepsOpt, gridOpt, foodOpt, hazardOpt});
+    parser.process(app);
+
+    if (attach)
+        name = parser.value(nameOpt);
+    int batch = qBound(1, parser.value(batchOpt).toInt(), ENV_MAX_BATCH);
+    int steps = qMax(1, parser.value(stepsOpt).toInt());
+    quint32 flags = ENV_FLAG_AUTO_RESET | (parser.isSet(gridOpt) ? quint32(ENV_FLAG_GRID) : 0u);
+
+    QTextStream out(stdout);
+    EnvClient client;
+    bool connected = false;
+    for (int tries = 0; tries < 500 && !connected; ++tries)
+    {
+        connected = client.connectTo(name);
+        if (!connected)
+            usleep(2000);
+    }
+    if (!connected)
+    {
+        QTextStream(stderr) << "Connexion impossible : " << client.errorString() << Qt::endl;
+        if (child > 0)
+            kill(child, SIGTERM);
+        return 1;
+    }
+
+    client.reset(batch, 1234, 2, flags, parser.value(foodOpt).toInt(),
+                 parser.value(hazardOpt).toInt());
+
+    QRandomGenerator rng(42);
+    uint8_t actions[ENV_MAX_BATCH];
+    QVector<double> rtt;
+    rtt.reserve(steps);
+    double serverNs = 0.0;
+    int warmup = qMin(1000, steps / 10);
+
+    for (int s = 0; s < steps + warmup; ++s)
+    {
+        for (int i = 0; i < batch; ++i)
+            actions[i] = static_cast<uint8_t>(rng.bounded(5));
+
+        auto t0 = std::chrono::steady_clock::now();
+        const EnvResponse *resp = client.step(actions, batch, flags);
+        auto t1 = std::chrono::steady_clock::now();
+
+        if (s >= warmup)
+        {
+            rtt.append(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            serverNs += resp->serverNanos;
+        }
+    }
+    client.close();
+    if (child > 0)
+        waitpid(child, nullptr, 0);
+
+    std::sort(rtt.begin(), rtt.end());
+    double p50 = percentile(rtt, 0.50);
+    double p99 = percentile(rtt, 0.99);
+
+    out << "lot : " << batch << " jeux, " << steps << " pas"
+        << (parser.isSet(gridOpt) ? " (avec grille)" : "") << Qt::endl;
+    out << QString("aller-retour us : p50 %1  p90 %2  p99 %3  max %4")
+               .arg(p50, 0, 'f', 2)
+               .arg(percentile(rtt, 0.90), 0, 'f', 2)
+               .arg(p99, 0, 'f', 2)
+               .arg(rtt.last(), 0, 'f', 2) << Qt::endl;
+    out << QString("traitement serveur us (moyenne) : %1")
+               .arg(serverNs / steps / 1000.0, 0, 'f', 2) << Qt::endl;
+    out << QString("debit : %1 pas-jeu/s")
+               .arg(batch * 1e6 / (p50 > 0 ? p50 : 1), 0, 'f', 0) << Qt::endl;
+    out << "objectif p50 < 10 us : " << (p50 < 10.0 ? "atteint" : "NON atteint") << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <csignal>
+#include "envserver.h"
+
+static EnvServer *runningServer = nullptr;
+
+static void onSignal(int)
+{
+    if (runningServer)
+        runningServer->stop();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("snake_envserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Serveur d'environnement Snake (memoire partagee)");
+    parser.addHelpOption();
+    QCommandLineOption nameOpt("name", "Nom du segment POSIX.", "nom", ENV_DEFAULT_NAME);
+    parser.addOption(nameOpt);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    EnvServer server(parser.value(nameOpt));
+    if (!server.start())
+    {
+        QTextStream(stderr) << "Erreur : " << server.errorString() << Qt::endl;
+        return 1;
+    }
+
+    runningServer = &server;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    out << "En ecoute sur " << parser.value(nameOpt) << Qt::endl;
+    server.run();
+    runningServer = nullptr;
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Coût d'un pas de Game::updateGame() selon le nombre de fruits : le test
+// de collision et le choix d'une case passent par la grille foodAt, le pas
+// ne doit donc pas grandir avec les fruits. Les pas où un fruit est mangé
+// (nouveau fruit, croissance) sont comptés à part : avec des centaines de
+// fruits, ils deviennent simplement plus fréquents. Bot : coup sûr au hasard.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "game.h"
+
+static Direction randomSafeMove(const Game &game, QRandomGenerator &rng)
+{
+    int w = game.boardWidth(), hgt = game.boardHeight();
+    Direction safe[4];
+    int count = 0;
+    for (int d = UP; d <= RIGHT; ++d)
+    {
+        Direction dir = static_cast<Direction>(d);
+        if (dir == oppositeDirection(game.getDirection()))
+            continue;
+        int x = (game.headX() + (dir == RIGHT) - (dir == LEFT) + w) % w;
+        int y = (game.headY() + (dir == DOWN) - (dir == UP) + hgt) % hgt;
+        if (!game.isWall(x, y) && !game.isOccupied(x, y))
+            safe[count++] = dir;
+    }
+    return count ? safe[rng.bounded(count)] : game.getDirection();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Cout d'un pas selon le nombre de fruits");
+    parser.addHelpOption();
+    QCommandLineOption foodsOpt("foods", "Nombres de fruits, separes par des virgules.", "liste",
+                                "3,30,100,200,300");
+    QCommandLineOption ticksOpt("ticks", "Pas mesures par nombre de fruits.", "n", "200000");
+    QCommandLineOption levelOpt("level", "Niveau 1..3.", "n", "1");
+    parser.addOptions({foodsOpt, ticksOpt, levelOpt});
+    parser.process(app);
+
+    int ticks = qMax(1, parser.value(ticksOpt).toInt());
+    QTextStream out(stdout);
+    for (const QString &field : parser.value(foodsOpt).split(','))
+    {
+        Game game;
+        game.setLevel(parser.value(levelOpt).toInt());
+        game.setFoodCount(field.toInt());
+        game.setSeed(1);
+        game.reset();
+        QRandomGenerator bot(2);
+
+        qint64 nanos[2] = { 0, 0 };
+        int steps[2] = { 0, 0 };
+        int games = 1;
+        QElapsedTimer timer;
+        for (int t = 0; t < ticks; ++t)
+        {
+            if (game.isGameOver())
+            {
+                game.setSeed(++games);
+                game.reset();
+            }
+            game.changeDirection(randomSafeMove(game, bot));
+            int score = game.getScore();
+            timer.start();
+            game.updateGame();
+            qint64 elapsed = timer.nsecsElapsed();
+            int ate = game.getScore() != score;
+            nanos[ate] += elapsed;
+            ++steps[ate];
+        }
+        out << QString("%1 fruits : %2 ns/pas sans fruit, %3 ns/pas avec (%4 % des pas), %5 parties")
+                   .arg(game.foodCount(), 4)
+                   .arg(double(nanos[0]) / qMax(1, steps[0]), 0, 'f', 0)
+                   .arg(double(nanos[1]) / qMax(1, steps[1]), 0, 'f', 0)
+                   .arg(100.0 * steps[1] / ticks, 0, 'f', 1)
+                   .arg(games) << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Coût des dangers mobiles selon leur nombre, sur un grand plateau sans
+// mur : déplacement de tous les dangers à chaque pas (table de hachage
+// tenue à jour) et test de cases au hasard, comparé au balayage linéaire
+// de la liste. Les deux tests doivent toujours donner la même réponse.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "hazards.h"
+
+static bool scanContains(const HazardField &field, int x, int y)
+{
+    for (int i = 0; i < field.count(); ++i)
+    {
+        if (field.hazard(i).x == x && field.hazard(i).y == y)
+            return true;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Dangers mobiles : cout du pas et des tests de case");
+    parser.addHelpOption();
+    QCommandLineOption hazardsOpt("hazards", "Nombres de dangers, separes par des virgules.", "liste",
+                                  "10,100,1000,10000");
+    QCommandLineOption sizeOpt("size", "Cote du plateau.", "n", "1024");
+    QCommandLineOption ticksOpt("ticks", "Pas simules.", "n", "2000");
+    QCommandLineOption queriesOpt("queries", "Tests de case par pas.", "n", "64");
+    parser.addOptions({hazardsOpt, sizeOpt, ticksOpt, queriesOpt});
+    parser.process(app);
+
+    int size = qMax(16, parser.value(sizeOpt).toInt());
+    int ticks = qMax(1, parser.value(ticksOpt).toInt());
+    int queries = qMax(1, parser.value(queriesOpt).toInt());
+    WallGrid walls;
+    walls.reset(size, size);
+
+    QTextStream out(stdout);
+    bool mismatch = false;
+    for (const QString &field : parser.value(hazardsOpt).split(','))
+    {
+        int count = qMax(1, field.toInt());
+        QRandomGenerator rng(7);
+        HazardField hazards;
+        hazards.reset(size, size);
+        for (int i = 0; i < count; ++i)
+        {
+            int x = rng.bounded(size), y = rng.bounded(size);
+            if (i % 4 == 3)
+                hazards.addChaser(x, y, 2, i & 1);
+            else
+                hazards.addPatrol(x, y, i & 1, !(i & 1), rng.bounded(3, 9), 1 + (i & 1), 0);
+        }
+
+        qint64 stepNanos = 0, hashNanos = 0, scanNanos = 0;
+        int hits = 0;
+        QVector<int> cells(queries * 2);
+        QElapsedTimer timer;
+        for (int t = 1; t <= ticks; ++t)
+        {
+            int targetX = t % size, targetY = (t / 2) % size;
+            timer.start();
+            hazards.step(quint64(t), walls, targetX, targetY);
+            stepNanos += timer.nsecsElapsed();
+
+            // Moitié de cases occupées, moitié au hasard
+            for (int q = 0; q < queries; ++q)
+            {
+                bool onHazard = q & 1;
+                const Hazard &hz = hazards.hazard(rng.bounded(count));
+                cells[2 * q] = onHazard ? hz.x : rng.bounded(size);
+                cells[2 * q + 1] = onHazard ? hz.y : rng.bounded(size);
+            }
+            int hashHits = 0, scanHits = 0;
+            timer.start();
+            for (int q = 0; q < queries; ++q)
+                hashHits += hazards.contains(cells[2 * q], cells[2 * q + 1]);
+            hashNanos += timer.nsecsElapsed();
+            timer.start();
+            for (int q = 0; q < queries; ++q)
+                scanHits += scanContains(hazards, cells[2 * q], cells[2 * q + 1]);
+            scanNanos += timer.nsecsElapsed();
+            if (hashHits != scanHits)
+                mismatch = true;
+            hits += hashHits;
+        }
+
+        double total = double(ticks) * queries;
+        out << QString("%1 dangers : pas %2 ns (%3 ns/danger), test %4 ns (hachage) contre %5 ns "
+                       "(balayage), %6 % de cases occupees")
+                   .arg(count, 6)
+                   .arg(double(stepNanos) / ticks, 9, 'f', 0)
+                   .arg(double(stepNanos) / ticks / count, 0, 'f', 1)
+                   .arg(double(hashNanos) / total, 0, 'f', 1)
+                   .arg(double(scanNanos) / total, 0, 'f', 1)
+                   .arg(100.0 * hits / total, 0, 'f', 1) << Qt::endl;
+    }
+    if (mismatch)
+        out << "ERREUR : le hachage et le balayage ne concordent pas" << Qt::endl;
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+// Consultation du classement persistant, et banc d'essai (--bench) :
+// ajout de N parties, temps de réouverture et des requêtes.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "leaderboard.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Snake");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Classement Snake par niveau");
+    parser.addHelpOption();
+    QCommandLineOption dirOpt("dir", "Dossier du classement (defaut : celui du jeu).", "dossier");
+    QCommandLineOption levelOpt("level", "Niveau (1 a 3).", "n", "2");
+    QCommandLineOption topOpt("top", "Nombre de meilleures parties affichees.", "k", "10");
+    QCommandLineOption scoreOpt("percentile", "Rang d'un score parmi les parties du niveau.", "score");
+    QCommandLineOption benchOpt("bench", "Ajouter N parties aleatoires puis mesurer.", "n");
+    parser.addOptions({dirOpt, levelOpt, topOpt, scoreOpt, benchOpt});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QString dir = parser.value(dirOpt);
+    int level = qBound(1, parser.value(levelOpt).toInt(), static_cast<int>(Leaderboard::LEVELS));
+
+    if (parser.isSet(benchOpt))
+    {
+        int n = qMax(1, parser.value(benchOpt).toInt());
+        Leaderboard board(dir);
+        if (!board.open())
+        {
+            QTextStream(stderr) << "Erreur : " << board.errorString() << Qt::endl;
+            return 1;
+        }
+        QRandomGenerator rng(1);
+        QElapsedTimer t;
+        t.start();
+        for (int i = 0; i < n; ++i)
+        {
+            // Somme de fruits : multiples de 5, queue longue vers les hauts scores
+            int fruits = rng.bounded(10) * rng.bounded(20);
+            board.record(level, fruits * 15, 3 + fruits);
+        }
+        out << QString("ajout : %1 us/partie").arg(t.nsecsElapsed() / 1000.0 / n, 0, 'f', 2) << Qt::endl;
+    }
+
+    QElapsedTimer t;
+    t.start();
+    Leaderboard board(dir);
+    if (!board.open())
+    {
+        QTextStream(stderr) << "Erreur : " << board.errorString() << Qt::endl;
+        return 1;
+    }
+    out << QString("ouverture : %1 ms, %2 parties au niveau %3 (%4)")
+               .arg(t.nsecsElapsed() / 1e6, 0, 'f', 2)
+               .arg(board.gameCount(level)).arg(level)
+               .arg(board.directory()) << Qt::endl;
+
+    t.restart();
+    QVector<LeaderboardEntry> best = board.top(level, parser.value(topOpt).toInt());
+    qint64 topNs = t.nsecsElapsed();
+    for (int i = 0; i < best.size(); ++i)
+        out << QString("%1. %2 pts  (longueur %3)").arg(i + 1, 3).arg(best[i].score, 6).arg(best[i].length) << Qt::endl;
+
+    t.restart();
+    int median = board.scoreAtPercentile(level, 50.0);
+    int p99 = board.scoreAtPercentile(level, 99.0);
+    qint64 quantileNs = t.nsecsElapsed() / 2;
+    out << "mediane : " << median << "  p99 : " << p99 << Qt::endl;
+
+    if (parser.isSet(scoreOpt))
+    {
+        int score = parser.value(scoreOpt).toInt();
+        out << QString("%1 pts : mieux que %2 % des parties")
+                   .arg(score).arg(board.percentile(level, score), 0, 'f', 2) << Qt::endl;
+    }
+    out << QString("requetes : top %1 us, quantile %2 us")
+               .arg(topNs / 1000.0, 0, 'f', 2).arg(quantileNs / 1000.0, 0, 'f', 2) << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Mesure de la génération des terrains et de la vérification
+// d'accessibilité, sur de grands plateaux sans carte.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "levelgen.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Terrains Snake : generation et verification d'accessibilite");
+    parser.addHelpOption();
+    QCommandLineOption sizeOpt("size", "Taille du plateau LxH.", "LxH", "1000x1000");
+    QCommandLineOption levelOpt("level", "Niveau (densite des murs).", "n", "2");
+    QCommandLineOption runsOpt("runs", "Generations par disposition.", "n", "20");
+    parser.addOptions({sizeOpt, levelOpt, runsOpt});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QStringList dims = parser.value(sizeOpt).split('x');
+    int width = dims.value(0).toInt();
+    int height = dims.value(1).toInt();
+    int level = parser.value(levelOpt).toInt();
+    int runs = qMax(1, parser.value(runsOpt).toInt());
+    if (width < 8 || height < 8)
+        parser.showHelp(1);
+
+    static const char *names[LAYOUT_COUNT] = { "aleatoire", "amas", "salles", "labyrinthe" };
+    QRandomGenerator rng(1);
+    LevelGenerator generator(rng);
+    LevelTable levels;
+    WallGrid walls;
+
+    // Serpent de départ au centre, vers la droite, comme Game::reset()
+    int sx = width / 2, sy = height / 2;
+    QVector<int> reserved;
+    for (int dx : { 0, 1, 2, 3, -1, -2 })
+        reserved.append(sy * width + sx + dx);
+
+    out << QString("%1x%2, niveau %3, %4 generations par disposition")
+               .arg(width).arg(height).arg(level).arg(runs) << Qt::endl;
+    for (int style = 0; style < LAYOUT_COUNT; ++style)
+    {
+        qint64 totalNs = 0, maxNs = 0, checkNs = 0;
+        qint64 free = 0, sealedCells = 0;
+        for (int r = 0; r < runs; ++r)
+        {
+            walls.reset(width, height);
+            QElapsedTimer t;
+            t.start();
+            free += generator.generate(walls, static_cast<LayoutStyle>(style), levels.level(level),
+                                       reserved);
+            qint64 ns = t.nsecsElapsed();
+            totalNs += ns;
+            maxNs = qMax(maxNs, ns);
+            sealedCells += generator.lastSealed();
+
+            // Second passage seul : coût de la vérification, et rien ne
+            // doit plus être muré
+            t.restart();
+            generator.sealUnreachable(walls, reserved.first());
+            checkNs += t.nsecsElapsed();
+            if (generator.lastSealed() != 0)
+            {
+                out << names[style] << " : cases encore inaccessibles apres generation" << Qt::endl;
+                return 1;
+            }
+        }
+        out << QString("%1 : %2 ms en moyenne (max %3), dont verification %4 ms ; "
+                       "%5 % de cases libres, %6 murees en moyenne")
+                   .arg(names[style], -10)
+                   .arg(totalNs / 1e6 / runs, 0, 'f', 2)
+                   .arg(maxNs / 1e6, 0, 'f', 2)
+                   .arg(checkNs / 1e6 / runs, 0, 'f', 2)
+                   .arg(100.0 * free / runs / (qint64(width) * height), 0, 'f', 1)
+                   .arg(sealedCells / runs) << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+// Conversion des cartes texte en cartes binaires (.snkm), génération de
+// grandes cartes aléatoires pour les bancs d'essai, et mesure du chargement.
+//
+// Format texte :
+//   ; commentaire
+//   zone X Y L H        zone d'apparition des fruits (facultatif, répétable)
+//   #..##....>...       une ligne par rangée : # mur, . ou espace libre,
+//                       > < ^ v départ du serpent (tête et direction)
+// Les rangées plus courtes que la plus longue sont complétées par du vide.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "game.h"
+#include "mapfile.h"
+
+static bool convertText(const QString &inPath, const QString &outPath, QTextStream &err)
+{
+    QFile in(inPath);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        err << inPath << " : " << in.errorString() << Qt::endl;
+        return false;
+    }
+
+    QStringList rows;
+    QVector<MapZone> zones;
+    int lineNo = 0;
+    while (!in.atEnd())
+    {
+        QString line = QString::fromUtf8(in.readLine());
+        ++lineNo;
+        while (line.endsWith("\n") || line.endsWith("\r"))
+            line.chop(1);
+        if (line.startsWith(";"))
+            continue;
+        if (line.startsWith("zone "))
+        {
+            QStringList f = line.split(' ', Qt::SkipEmptyParts);
+            bool ok = f.size() == 5;
+            MapZone z;
+            z.x = f.value(1).toUInt(&ok);
+            if (ok) z.y = f.value(2).toUInt(&ok);
+            if (ok) z.width = f.value(3).toUInt(&ok);
+            if (ok) z.height = f.value(4).toUInt(&ok);
+            if (!ok)
+            {
+                err << inPath << ":" << lineNo << " : zone attendue : zone X Y L H" << Qt::endl;
+                return false;
+            }
+            zones.append(z);
+            continue;
+        }
+        rows.append(line);
+    }
+    while (!rows.isEmpty() && rows.last().trimmed().isEmpty())
+        rows.removeLast();
+
+    int height = static_cast<int>(rows.size());
+    int width = 0;
+    for (const QString &r : rows)
+        width = qMax(width, static_cast<int>(r.size()));
+    if (width < 8 || height < 8 || width > MAP_MAX_SIZE || height > MAP_MAX_SIZE)
+    {
+        err << inPath << " : dimensions " << width << "x" << height << " hors limites (8 a "
+            << MAP_MAX_SIZE << ")" << Qt::endl;
+        return false;
+    }
+
+    for (const MapZone &z : zones)
+    {
+        if (z.width == 0 || z.height == 0 || z.x + z.width > uint32_t(width) || z.y + z.height > uint32_t(height))
+        {
+            err << inPath << " : zone " << z.x << " " << z.y << " " << z.width << " " << z.height
+                << " hors de la carte" << Qt::endl;
+            return false;
+        }
+    }
+
+    WallGrid walls;
+    walls.reset(width, height);
+    int spawnX = -1, spawnY = -1;
+    Direction spawnDir = RIGHT;
+    for (int y = 0; y < height; ++y)
+    {
+        const QString &r = rows[y];
+        for (int x = 0; x < r.size(); ++x)
+        {
+            QChar c = r[x];
+            if (c == '#')
+                walls.setWall(x, y);
+            else if (c == '>' || c == '<' || c == '^' || c == 'v')
+            {
+                spawnX = x;
+                spawnY = y;
+                spawnDir = (c == '>') ? RIGHT : (c == '<') ? LEFT : (c == '^') ? UP : DOWN;
+            }
+            else if (c != '.' && c != ' ')
+            {
+                err << inPath << " : caractere inconnu '" << c << "' en " << x << "," << y << Qt::endl;
+                return false;
+            }
+        }
+    }
+    if (spawnX < 0)
+    {
+        spawnX = width / 2;
+        spawnY = height / 2;
+    }
+
+    // Tête et deux segments derrière elle doivent être libres
+    int dx = (spawnDir == RIGHT) ? -1 : (spawnDir == LEFT) ? 1 : 0;
+    int dy = (spawnDir == DOWN) ? -1 : (spawnDir == UP) ? 1 : 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        int x = (spawnX + i * dx + width) % width;
+        int y = (spawnY + i * dy + height) % height;
+        if (walls.isWall(x, y))
+        {
+            err << inPath << " : le serpent de depart chevauche un mur en " << x << "," << y << Qt::endl;
+            return false;
+        }
+    }
+
+    QString error;
+    if (!MapFile::save(outPath, walls, spawnX, spawnY, spawnDir, zones, &error))
+    {
+        err << outPath << " : " << error << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool generateRandom(const QString &size, double density, const QString &outPath, QTextStream &err)
+{
+    QStringList dims = size.split('x');
+    int width = dims.value(0).toInt();
+    int height = dims.value(1).toInt();
+    if (width < 8 || height < 8 || width > MAP_MAX_SIZE || height > MAP_MAX_SIZE)
+    {
+        err << "Taille invalide : " << size << " (attendu LxH)" << Qt::endl;
+        return false;
+    }
+
+    WallGrid walls;
+    walls.reset(width, height);
+    QRandomGenerator rng(1);
+    quint32 threshold = static_cast<quint32>(qBound(0.0, density, 0.9) * 4294967295.0);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            if (rng.generate() < threshold)
+                walls.setWall(x, y);
+
+    // Couloir de départ dégagé au centre
+    int sx = width / 2, sy = height / 2;
+    for (int x = sx - 4; x <= sx + 4; ++x)
+        walls.setWall(x, sy, false);
+
+    QString error;
+    if (!MapFile::save(outPath, walls, sx, sy, RIGHT, QVector<MapZone>(), &error))
+    {
+        err << outPath << " : " << error << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Cartes Snake : texte -> .snkm, generation, mesure");
+    parser.addHelpOption();
+    QCommandLineOption randomOpt("random", "Generer une carte aleatoire de taille LxH.", "LxH");
+    QCommandLineOption densityOpt("density", "Avec --random : proportion de murs.", "d", "0.15");
+    QCommandLineOption benchOpt("bench", "Mesurer le chargement de la carte donnee.");
+    parser.addOptions({randomOpt, densityOpt, benchOpt});
+    parser.addPositionalArgument("entree", "Carte texte (ou .snkm avec --bench).");
+    parser.addPositionalArgument("sortie", "Carte binaire .snkm.");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QStringList args = parser.positionalArguments();
+
+    if (parser.isSet(benchOpt))
+    {
+        if (args.size() != 1)
+            parser.showHelp(1);
+        QElapsedTimer t;
+        t.start();
+        MapFile map;
+        if (!map.open(args[0]))
+        {
+            err << args[0] << " : " << map.errorString() << Qt::endl;
+            return 1;
+        }
+        qint64 openNs = t.nsecsElapsed();
+        map.close();
+
+        // Chargement complet dans le jeu : carte + reset (grille, serpent, fruits)
+        t.restart();
+        Game game;
+        game.loadMap(args[0]);
+        game.reset();
+        qint64 gameNs = t.nsecsElapsed();
+        out << QString("%1x%2 : ouverture %3 ms, partie prete %4 ms")
+                   .arg(game.boardWidth()).arg(game.boardHeight())
+                   .arg(openNs / 1e6, 0, 'f', 3).arg(gameNs / 1e6, 0, 'f', 3) << Qt::endl;
+        return 0;
+    }
+
+    if (parser.isSet(randomOpt))
+    {
+        if (args.size() != 1)
+            parser.showHelp(1);
+        return generateRandom(parser.value(randomOpt), parser.value(densityOpt).toDouble(), args[0], err) ? 0 : 1;
+    }
+
+    if (args.size() != 2)
+        parser.showHelp(1);
+    if (!convertText(args[0], args[1], err))
+        return 1;
+    out << args[0] << " -> " << args[1] << Qt::endl;
+    return 0;
+}
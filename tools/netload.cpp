@@ -0,0 +1,163 @@
+// Générateur de charge du mode réseau : N clients scriptés dans un seul
+// processus (boucle locale), directions aléatoires, puis bilan de la
+// bande passante par client et du coût de tick annoncé par le serveur.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include "netclient.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Charge du serveur reseau : N clients scriptes");
+    parser.addHelpOption();
+    QCommandLineOption clientsOpt("clients", "Nombre de clients.", "n", "120");
+    QCommandLineOption secondsOpt("seconds", "Duree de la mesure.", "s", "20");
+    QCommandLineOption hostOpt("host", "Adresse du serveur.", "hote", "127.0.0.1");
+    QCommandLineOption portOpt("port", "Port du serveur.", "port", QString::number(NET_DEFAULT_PORT));
+    QCommandLineOption inputOpt("input-ms", "Intervalle entre deux decisions d'un client.", "ms", "200");
+    QCommandLineOption spawnOpt("spawn", "Lancer snake_netserver (meme dossier) pour la mesure.");
+    QCommandLineOption tickOpt("tick", "Avec --spawn : duree d'un tick en ms.", "ms", "0");
+    parser.addOptions({clientsOpt, secondsOpt, hostOpt, portOpt, inputOpt, spawnOpt, tickOpt});
+    parser.process(app);
+
+    int count = qBound(1, parser.value(clientsOpt).toInt(), static_cast<int>(Arena::MAX_SNAKES));
+    int seconds = qMax(1, parser.value(secondsOpt).toInt());
+    QString host = parser.value(hostOpt);
+    quint16 port = static_cast<quint16>(parser.value(portOpt).toUInt());
+    QTextStream out(stdout);
+
+    QProcess server;
+    if (parser.isSet(spawnOpt))
+    {
+        server.setProcessChannelMode(QProcess::ForwardedChannels);
+        server.start(QCoreApplication::applicationDirPath() + "/snake_netserver",
+                     {"--port", QString::number(port),
+                      "--players", QString::number(count),
+                      "--tick", parser.value(tickOpt)});
+        if (!server.waitForStarted())
+        {
+            QTextStream(stderr) << "Impossible de lancer snake_netserver" << Qt::endl;
+            return 1;
+        }
+    }
+
+    QVector<NetClient *> clients;
+    for (int i = 0; i < count; ++i)
+        clients.append(new NetClient(&app));
+
+    // Pire seconde vue par le premier client
+    NetStats worst = NetStats();
+    quint32 bytesOutTotal = 0;
+    int statsSamples = 0;
+    bool measuring = false;
+    QObject::connect(clients.first(), &NetClient::statsReceived, &app, [&]() {
+        if (!measuring)
+            return;
+        const NetStats &s = clients.first()->serverStats();
+        if (s.tickP99Us >= worst.tickP99Us)
+            worst = s;
+        worst.clients = qMax(worst.clients, s.clients);
+        bytesOutTotal += s.bytesOut;
+        ++statsSamples;
+    });
+
+    // Connexions échelonnées pour ne pas saturer la file d'attente d'accept()
+    QTimer::singleShot(parser.isSet(spawnOpt) ? 500 : 0, &app, [&]() {
+        for (int i = 0; i < count; ++i)
+            QTimer::singleShot(i / 16, &app, [&, i]() { clients[i]->connectTo(host, port); });
+    });
+
+    QRandomGenerator rng(7);
+    QTimer inputs;
+    QObject::connect(&inputs, &QTimer::timeout, &app, [&]() {
+        for (NetClient *c : clients)
+        {
+            if (c->isReady() && rng.bounded(3) == 0)
+                c->sendDirection(static_cast<Direction>(rng.bounded(UP, RIGHT + 1)));
+        }
+    });
+    inputs.start(qMax(1, parser.value(inputOpt).toInt()));
+
+    // Mesure après deux secondes : les SNAPSHOT d'arrivée sont exclus
+    QVector<qint64> inBase(count), outBase(count);
+    QVector<quint32> deltaBase(count);
+    QElapsedTimer window;
+    QTimer::singleShot(2000, &app, [&]() {
+        for (int i = 0; i < count; ++i)
+        {
+            inBase[i] = clients[i]->bytesReceived();
+            outBase[i] = clients[i]->bytesSent();
+            deltaBase[i] = clients[i]->deltaCount();
+        }
+        measuring = true;
+        window.start();
+    });
+
+    QTimer::singleShot(2000 + seconds * 1000, &app, [&]() {
+        double elapsed = window.elapsed() / 1000.0;
+        QVector<double> inRates;
+        double outSum = 0.0, deltaSum = 0.0;
+        quint64 predictions = 0, misses = 0, resyncs = 0;
+        int joined = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            NetClient *c = clients[i];
+            if (!c->isReady())
+                continue;
+            ++joined;
+            inRates.append((c->bytesReceived() - inBase[i]) / elapsed);
+            outSum += (c->bytesSent() - outBase[i]) / elapsed;
+            deltaSum += (c->deltaCount() - deltaBase[i]) / elapsed;
+            predictions += c->predictionCount();
+            misses += c->mispredictionCount();
+            resyncs += c->resyncCount();
+        }
+        std::sort(inRates.begin(), inRates.end());
+
+        out << "clients connectes : " << joined << " / " << count << Qt::endl;
+        if (joined > 0)
+        {
+            double inSum = 0.0;
+            for (double r : inRates)
+                inSum += r;
+            out << QString("reception par client (octets/s) : moyenne %1  min %2  max %3")
+                       .arg(inSum / joined, 0, 'f', 0)
+                       .arg(inRates.first(), 0, 'f', 0)
+                       .arg(inRates.last(), 0, 'f', 0) << Qt::endl;
+            out << QString("emission par client (octets/s) : %1").arg(outSum / joined, 0, 'f', 1) << Qt::endl;
+            out << QString("deltas par client et par seconde : %1").arg(deltaSum / joined, 0, 'f', 1) << Qt::endl;
+            out << QString("prediction locale : %1 ticks, %2 erreurs (%3 %)")
+                       .arg(predictions).arg(misses)
+                       .arg(predictions ? 100.0 * misses / predictions : 0.0, 0, 'f', 2) << Qt::endl;
+            out << "resynchronisations : " << resyncs << Qt::endl;
+        }
+        if (statsSamples > 0)
+        {
+            out << QString("serveur, pire seconde : tick p50 %1 us  p99 %2 us  max %3 us (%4 clients)")
+                       .arg(worst.tickP50Us).arg(worst.tickP99Us).arg(worst.tickMaxUs)
+                       .arg(worst.clients) << Qt::endl;
+            out << QString("serveur, sortie totale : %1 octets/s")
+                       .arg(double(bytesOutTotal) / statsSamples, 0, 'f', 0) << Qt::endl;
+        }
+
+        for (NetClient *c : clients)
+            c->disconnectFrom();
+        if (server.state() != QProcess::NotRunning)
+        {
+            server.terminate();
+            server.waitForFinished(2000);
+        }
+        QCoreApplication::quit();
+    });
+
+    return app.exec();
+}
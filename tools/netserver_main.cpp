@@ -0,0 +1,52 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QtMath>
+#include "netserver.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("snake_netserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Serveur reseau Snake (arene multijoueur, TCP)");
+    parser.addHelpOption();
+    QCommandLineOption portOpt("port", "Port TCP.", "port", QString::number(NET_DEFAULT_PORT));
+    QCommandLineOption playersOpt("players", "Places de joueurs (bot tant que libre).", "n", "128");
+    QCommandLineOption botsOpt("bots", "Bots supplementaires.", "n", "0");
+    QCommandLineOption widthOpt("width", "Largeur du plateau (0 = selon le nombre de serpents).", "cases", "0");
+    QCommandLineOption heightOpt("height", "Hauteur du plateau (0 = selon le nombre de serpents).", "cases", "0");
+    QCommandLineOption levelOpt("level", "Niveau (1 a 3).", "n", "2");
+    QCommandLineOption tickOpt("tick", "Duree d'un tick en ms (0 = vitesse du niveau).", "ms", "0");
+    parser.addOptions({portOpt, playersOpt, botsOpt, widthOpt, heightOpt, levelOpt, tickOpt});
+    parser.process(app);
+
+    int players = parser.value(playersOpt).toInt();
+    int bots = parser.value(botsOpt).toInt();
+    int width = parser.value(widthOpt).toInt();
+    int height = parser.value(heightOpt).toInt();
+    if (width <= 0 || height <= 0)
+    {
+        // Plateau solo agrandi pour garder environ 4 serpents par 40x25
+        int scale = qMax(1, qCeil(qSqrt((players + bots) / 4.0)));
+        width = WIDTH * scale;
+        height = HEIGHT * scale;
+    }
+    width = qBound(8, width, Arena::MAX_SIDE);
+    height = qBound(8, height, Arena::MAX_SIDE);
+
+    NetServer server;
+    server.configure(players, bots, width, height,
+                     parser.value(levelOpt).toInt(), parser.value(tickOpt).toInt());
+    quint16 port = static_cast<quint16>(parser.value(portOpt).toUInt());
+    if (!server.listen(port))
+    {
+        QTextStream(stderr) << "Erreur : " << server.errorString() << Qt::endl;
+        return 1;
+    }
+
+    QTextStream(stdout) << "En ecoute sur le port " << port << " (" << width << "x" << height
+                        << ", " << players << " places)" << Qt::endl;
+    return app.exec();
+}
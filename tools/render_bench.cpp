@@ -0,0 +1,336 @@
+// Banc de rendu hors écran (QT_QPA_PLATFORM=offscreen) : SnakeWidget dessine
+// dans une QImage une matrice de scènes figées (longueur du serpent, nombre
+// de murs, taille de case de 5 à 60 px, pause, fin de partie, gains de
+// points à l'écran). Pour chaque scène : temps par image (médiane, 90e et
+// 99e centiles), puis comparaison aux images de référence avec une
+// tolérance par canal. Code de retour 1 si une image diffère, si une
+// scène est nettement plus lente que la référence ou si une référence
+// (image ou temps) manque : une comparaison sans référence n'en est pas une.
+//
+//   snake_render_bench --golden tools/render_golden --update-golden
+//       enregistre les images et les temps de référence de cette machine
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <algorithm>
+#include "snakewidget.h"
+
+struct Scenario
+{
+    QString name;
+    int boardW;
+    int boardH;
+    int length;
+    int walls;
+    int hazards;
+    int popups;
+    bool paused;
+    bool over;
+};
+
+static const Scenario SCENARIOS[] = {
+    // nom       plateau   long. murs dangers gains pause  fin
+    {"jeu",      40, 25,    30,   40,  4,     0,    false, false},
+    {"long",    120, 75,  2000,  400, 12,     0,    false, false},
+    {"pause",    40, 25,    30,   40,  4,     0,    true,  false},
+    {"fin",      40, 25,    30,   40,  0,     0,    false, true},
+    {"gains",    40, 25,    30,   40,  0,    60,    false, false},
+};
+
+static constexpr int MAX_IMAGE_SIDE = 4096;
+
+// Serpent en boustrophédon depuis le coin haut gauche, murs, fruits et
+// dangers tirés d'une graine fixe hors du corps : même scène à chaque appel
+static RenderScene buildScene(const Scenario &sc, int cellSize)
+{
+    RenderScene scene;
+    scene.cellSize = cellSize;
+    scene.paused = sc.paused;
+    scene.bestScore = 500;
+
+    SimSnapshot &s = scene.state;
+    s.gameId = 1;
+    s.tick = 1000;
+    s.boardW = sc.boardW;
+    s.boardH = sc.boardH;
+    s.level = 2;
+    s.score = 420;
+    s.gameOver = sc.over;
+    s.cause = sc.over ? DEATH_BODY : DEATH_NONE;
+
+    QVector<int> path;
+    for (int i = 0; i < sc.length; ++i)
+    {
+        int y = i / sc.boardW;
+        int x = i % sc.boardW;
+        path.append(y * sc.boardW + ((y & 1) ? sc.boardW - 1 - x : x));
+    }
+    for (int i = path.size() - 1; i >= 0; --i)
+        s.snake.append(path[i]);
+    s.length = s.snake.size();
+    int head = s.snake[0];
+    int neck = s.snake.size() > 1 ? s.snake[1] : head;
+    if (head == neck + 1)
+        s.direction = RIGHT;
+    else if (head == neck - 1)
+        s.direction = LEFT;
+    else
+        s.direction = DOWN;
+
+    QVector<bool> used(sc.boardW * sc.boardH, false);
+    for (int cell : s.snake)
+        used[cell] = true;
+    QRandomGenerator rng(42);
+    auto freeCell = [&]() {
+        int cell;
+        do
+            cell = rng.bounded(sc.boardW * sc.boardH);
+        while (used[cell]);
+        used[cell] = true;
+        return cell;
+    };
+
+    s.walls.reset(sc.boardW, sc.boardH);
+    for (int i = 0; i < sc.walls; ++i)
+    {
+        int cell = freeCell();
+        s.walls.setWall(cell % sc.boardW, cell / sc.boardW);
+    }
+    for (int i = 0; i < FRUIT_TYPE_COUNT; ++i)
+    {
+        int cell = freeCell();
+        s.foods.append({cell % sc.boardW, cell / sc.boardW, static_cast<FruitType>(i),
+                        i < 4 ? -1 : 40});
+    }
+    for (int i = 0; i < sc.hazards; ++i)
+    {
+        int cell = freeCell();
+        s.hazards.append({cell % sc.boardW, cell / sc.boardW,
+                          (i & 1) ? HAZARD_CHASER : HAZARD_PATROL});
+    }
+    for (int i = 0; i < sc.popups; ++i)
+    {
+        ScorePopup popup;
+        popup.x = rng.bounded(sc.boardW);
+        popup.y = rng.bounded(sc.boardH);
+        popup.points = 10 * (1 + i % 5);
+        popup.alpha = 255 - (i * 4) % 200;
+        popup.offsetY = -(i % 30);
+        popup.fruitType = static_cast<FruitType>(i % FRUIT_TYPE_COUNT);
+        scene.popups.append(popup);
+    }
+    return scene;
+}
+
+// Part des pixels dont un canal s'écarte de plus de `tolerance`
+static double diffRatio(const QImage &a, const QImage &b, int tolerance, QImage *diff)
+{
+    if (a.size() != b.size())
+        return 1.0;
+    *diff = QImage(a.size(), QImage::Format_ARGB32);
+    diff->fill(Qt::black);
+    qint64 differing = 0;
+    for (int y = 0; y < a.height(); ++y)
+    {
+        const QRgb *ra = reinterpret_cast<const QRgb *>(a.constScanLine(y));
+        const QRgb *rb = reinterpret_cast<const QRgb *>(b.constScanLine(y));
+        QRgb *rd = reinterpret_cast<QRgb *>(diff->scanLine(y));
+        for (int x = 0; x < a.width(); ++x)
+        {
+            int d = qMax(qMax(qAbs(qRed(ra[x]) - qRed(rb[x])), qAbs(qGreen(ra[x]) - qGreen(rb[x]))),
+                         qMax(qAbs(qBlue(ra[x]) - qBlue(rb[x])), qAbs(qAlpha(ra[x]) - qAlpha(rb[x]))));
+            if (d > tolerance)
+            {
+                ++differing;
+                rd[x] = qRgb(255, 0, 255);
+            }
+        }
+    }
+    return double(differing) / (qint64(a.width()) * a.height());
+}
+
+static double percentile(const QVector<qint64> &sorted, double p)
+{
+    int i = qMin(int(p * sorted.size()), int(sorted.size()) - 1);
+    return sorted[i] / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QStandardPaths::setTestModeEnabled(true);  // classement de test, jamais celui du joueur
+    QApplication app(argc, argv);
+    app.setStyle("Fusion");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Rendu hors ecran : temps par image et images de reference");
+    parser.addHelpOption();
+    QCommandLineOption cellsOpt("cells", "Tailles de case, separees par des virgules.", "liste",
+                                "5,8,14,25,60");
+    QCommandLineOption framesOpt("frames", "Images mesurees par scene.", "n", "40");
+    QCommandLineOption onlyOpt("only", "Scenes dont le nom contient ce texte.", "texte");
+    QCommandLineOption goldenOpt("golden", "Dossier des images et temps de reference.", "dossier");
+    QCommandLineOption updateOpt("update-golden", "Remplace les references par ce rendu.");
+    QCommandLineOption outOpt("out", "Dossier des images de difference.", "dossier", ".");
+    QCommandLineOption tolOpt("pixel-tol", "Ecart tolere par canal (0-255).", "n", "24");
+    QCommandLineOption maxDiffOpt("max-diff", "Part maximale de pixels differents.", "part",
+                                  "0.002");
+    QCommandLineOption slowOpt("slowdown", "Facteur de ralentissement tolere (mediane).", "x",
+                               "1.5");
+    QCommandLineOption noTilesOpt("no-tiles", "Rendu d'un seul tenant, meme sur grand plateau.");
+    parser.addOptions({cellsOpt, framesOpt, onlyOpt, goldenOpt, updateOpt, outOpt,
+                       tolOpt, maxDiffOpt, slowOpt, noTilesOpt});
+    parser.process(app);
+
+    int frames = qMax(1, parser.value(framesOpt).toInt());
+    int tolerance = parser.value(tolOpt).toInt();
+    double maxDiff = parser.value(maxDiffOpt).toDouble();
+    double slowdown = parser.value(slowOpt).toDouble();
+    bool update = parser.isSet(updateOpt);
+    QDir golden(parser.value(goldenOpt));
+    QDir out(parser.value(outOpt));
+    bool compare = parser.isSet(goldenOpt);
+    if (compare && update)
+        golden.mkpath(".");
+
+    // Temps de référence : une ligne « nom médiane_ms » par scène
+    QString timingsPath = golden.filePath("timings.txt");
+    QHash<QString, double> baseline;
+    QFile timingsFile(timingsPath);
+    if (compare && !update && timingsFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QTextStream in(&timingsFile);
+        while (!in.atEnd())
+        {
+            QStringList fields = in.readLine().split(' ', Qt::SkipEmptyParts);
+            if (fields.size() == 2)
+                baseline.insert(fields[0], fields[1].toDouble());
+        }
+        timingsFile.close();
+    }
+    QString newTimings;
+
+    QTextStream console(stdout);
+    int failures = 0;
+    int missing = 0;
+    for (const Scenario &sc : SCENARIOS)
+    {
+        for (const QString &field : parser.value(cellsOpt).split(','))
+        {
+            int cellSize = qBound(5, field.toInt(), 60);
+            QString name = QString("%1-c%2").arg(sc.name).arg(cellSize);
+            if (parser.isSet(onlyOpt) && !name.contains(parser.value(onlyOpt)))
+                continue;
+            if (qMax(sc.boardW, sc.boardH) * cellSize > MAX_IMAGE_SIDE)
+                continue;
+
+            // Un widget par scène : rien ne reste de la précédente
+            SnakeWidget widget;
+            widget.showScene(buildScene(sc, cellSize));
+            widget.setTiledRendering(!parser.isSet(noTilesOpt));
+            QImage image(widget.size(), QImage::Format_ARGB32_Premultiplied);
+            for (int i = 0; i < 3; ++i)   // atlas des fruits, textes, boutons
+                widget.render(&image);
+
+            QVector<qint64> times;
+            QElapsedTimer timer;
+            for (int i = 0; i < frames; ++i)
+            {
+                timer.start();
+                widget.render(&image);
+                times.append(timer.nsecsElapsed());
+            }
+            std::sort(times.begin(), times.end());
+            double p50 = percentile(times, 0.50);
+            double p90 = percentile(times, 0.90);
+            double p99 = percentile(times, 0.99);
+            newTimings += QString("%1 %2\n").arg(name).arg(p50, 0, 'f', 3);
+
+            QString verdict;
+            if (compare && update)
+            {
+                image.save(golden.filePath(name + ".png"));
+                verdict = "reference enregistree";
+            }
+            else if (compare)
+            {
+                QImage reference(golden.filePath(name + ".png"));
+                if (reference.isNull())
+                {
+                    ++missing;
+                    verdict = "PAS D'IMAGE DE REFERENCE";
+                }
+                else
+                {
+                    QImage diff;
+                    double ratio = diffRatio(image.convertToFormat(QImage::Format_ARGB32),
+                                             reference.convertToFormat(QImage::Format_ARGB32),
+                                             tolerance, &diff);
+                    if (ratio > maxDiff)
+                    {
+                        ++failures;
+                        out.mkpath(".");
+                        image.save(out.filePath(name + "-rendu.png"));
+                        if (!diff.isNull())
+                            diff.save(out.filePath(name + "-diff.png"));
+                        verdict = QString("IMAGE DIFFERENTE (%1 % des pixels)")
+                                      .arg(ratio * 100, 0, 'f', 3);
+                    }
+                    else
+                    {
+                        verdict = "image ok";
+                    }
+                }
+
+                // Écart absolu minimal : les scènes rapides sont bruitées
+                if (!baseline.contains(name))
+                {
+                    ++missing;
+                    verdict += ", PAS DE TEMPS DE REFERENCE";
+                }
+                else
+                {
+                    double ref = baseline.value(name);
+                    if (p50 > ref * slowdown && p50 - ref > 0.5)
+                    {
+                        ++failures;
+                        verdict += QString(", PLUS LENT (%1 ms en reference)").arg(ref, 0, 'f', 2);
+                    }
+                }
+            }
+
+            console << QString("%1 %2x%3 : mediane %4 ms, p90 %5 ms, p99 %6 ms  %7")
+                           .arg(name, -10)
+                           .arg(image.width())
+                           .arg(image.height())
+                           .arg(p50, 0, 'f', 2)
+                           .arg(p90, 0, 'f', 2)
+                           .arg(p99, 0, 'f', 2)
+                           .arg(verdict) << Qt::endl;
+        }
+    }
+
+    if (compare && update)
+    {
+        if (timingsFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        {
+            timingsFile.write(newTimings.toUtf8());
+            timingsFile.close();
+        }
+    }
+    if (missing)
+        console << "ERREUR : " << missing
+                << " reference(s) absente(s) : les produire avec --update-golden" << Qt::endl;
+    if (failures)
+        console << "ERREUR : " << failures << " regression(s) de rendu" << Qt::endl;
+    return failures || missing ? 1 : 0;
+}
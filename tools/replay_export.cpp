@@ -0,0 +1,189 @@
+// Export d'une partie enregistrée (.snkp) en animation, sans affichage
+// (QT_QPA_PLATFORM=offscreen). La partie est rejouée pas à pas ; chaque
+// image est dessinée par SnakeWidget, comme à l'écran, puis encodée sur
+// les autres cœurs pendant que la suivante se dessine. Au plus
+// --in-flight images attendent leur écriture : la mémoire ne dépend pas
+// de la longueur de la partie.
+//
+//   snake_replay_export partie.snkp -o partie.gif
+//   snake_replay_export partie.snkp -o - --format raw |
+//       ffmpeg -f rawvideo -pix_fmt bgra -s 800x595 -r 10 -i - partie.mp4
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QScopedPointer>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <deque>
+#include "animwriter.h"
+#include "replay.h"
+#include "snakewidget.h"
+
+static constexpr int FINAL_FRAME_MS = 2000;   // dernière image tenue
+
+struct PendingFrame
+{
+    QFuture<QByteArray> data;
+    int delayMs;
+};
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QStandardPaths::setTestModeEnabled(true);  // classement de test, jamais celui du joueur
+    QApplication app(argc, argv);
+    app.setStyle("Fusion");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Export d'une partie enregistree en GIF, APNG ou images brutes");
+    parser.addHelpOption();
+    parser.addPositionalArgument("partie", "Fichier .snkp (dossier replays des donnees du jeu).");
+    QCommandLineOption outOpt({"o", "output"}, "Fichier de sortie, - pour la sortie standard.",
+                              "fichier");
+    QCommandLineOption formatOpt("format", "gif, apng ou raw (sinon d'apres l'extension).",
+                                 "format");
+    QCommandLineOption cellOpt("cell", "Taille de case en pixels.", "px", "16");
+    QCommandLineOption everyOpt("every", "Une image tous les n pas de jeu.", "n", "1");
+    QCommandLineOption jobsOpt("jobs", "Threads d'encodage (0 : un par coeur).", "n", "0");
+    QCommandLineOption inFlightOpt("in-flight", "Images en attente d'ecriture, au plus.", "n",
+                                   "0");
+    parser.addOptions({outOpt, formatOpt, cellOpt, everyOpt, jobsOpt, inFlightOpt});
+    parser.process(app);
+
+    QTextStream console(stderr);
+    if (parser.positionalArguments().size() != 1 || !parser.isSet(outOpt))
+    {
+        console << "Usage : snake_replay_export partie.snkp -o sortie.gif" << Qt::endl;
+        return 2;
+    }
+
+    QString outPath = parser.value(outOpt);
+    QString format = parser.value(formatOpt);
+    if (format.isEmpty())
+        format = outPath == "-" ? QString("raw") : QFileInfo(outPath).suffix().toLower();
+    if (format == "png")
+        format = "apng";
+    QScopedPointer<AnimWriter> writer(AnimWriter::create(format));
+    if (!writer)
+    {
+        console << "Format inconnu : " << format << " (gif, apng ou raw)" << Qt::endl;
+        return 2;
+    }
+
+    Replay replay;
+    QString error;
+    if (!replay.load(parser.positionalArguments().first(), &error))
+    {
+        console << "Lecture impossible : " << error << Qt::endl;
+        return 1;
+    }
+    ReplayPlayer player(replay);
+    if (!player.start(&error))
+    {
+        console << "Partie impossible a rejouer : " << error << Qt::endl;
+        return 1;
+    }
+
+    int every = qMax(1, parser.value(everyOpt).toInt());
+    int startSpeed = player.game().getSpeed();   // ms par pas au départ
+    int jobs = parser.value(jobsOpt).toInt();
+    if (jobs > 0)
+        QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    int inFlight = parser.value(inFlightOpt).toInt();
+    if (inFlight <= 0)
+        inFlight = 2 * QThreadPool::globalInstance()->maxThreadCount();
+
+    RenderScene scene;
+    scene.cellSize = qBound(5, parser.value(cellOpt).toInt(), 60);
+    scene.bestScore = replay.finalScore;
+    SnakeWidget widget;
+    auto showCurrent = [&]() {
+        fillSnapshot(scene.state, player.game());
+        scene.state.gameId = 1;
+        widget.showScene(scene);
+    };
+    showCurrent();
+
+    if (!writer->open(outPath, widget.size(), int(replay.ticks / every) + 1))
+    {
+        console << "Ecriture impossible : " << writer->errorString() << Qt::endl;
+        return 1;
+    }
+
+    // Les images sont écrites dans l'ordre : on attend toujours la plus
+    // ancienne, les suivantes continuent de s'encoder
+    std::deque<PendingFrame> pending;
+    auto writeOldest = [&]() {
+        PendingFrame frame = pending.front();
+        pending.pop_front();
+        return writer->writeFrame(frame.data.result(), frame.delayMs);
+    };
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    int frames = 0;
+    bool ok = true;
+    while (ok)
+    {
+        QImage image(widget.size(), QImage::Format_ARGB32_Premultiplied);
+        widget.render(&image);
+
+        // Durée de l'image : les pas qu'elle représente, à la vitesse du
+        // moment (niveau, éclair)
+        int delay = 0;
+        for (int i = 0; i < every && !player.atEnd(); ++i)
+        {
+            delay += player.game().getSpeed();
+            player.step();
+        }
+        bool last = delay == 0;
+        if (last)
+            delay = FINAL_FRAME_MS;
+
+        const AnimWriter *encoder = writer.data();
+        pending.push_back({QtConcurrent::run([encoder, image]() {
+                               return encoder->encodeFrame(image);
+                           }),
+                           delay});
+        ++frames;
+        while (ok && int(pending.size()) >= inFlight)
+            ok = writeOldest();
+        if (last)
+            break;
+        showCurrent();
+    }
+    while (ok && !pending.empty())
+        ok = writeOldest();
+    for (PendingFrame &frame : pending)   // écriture en échec : on laisse finir
+        frame.data.waitForFinished();
+    if (!ok || !writer->finish())
+    {
+        console << "Ecriture impossible : " << writer->errorString() << Qt::endl;
+        return 1;
+    }
+
+    double seconds = qMax(elapsed.nsecsElapsed() / 1e9, 1e-9);
+    console << QString("%1 images %2x%3 en %4 s (%5 images/s), %6 Ko")
+                   .arg(frames)
+                   .arg(widget.width())
+                   .arg(widget.height())
+                   .arg(seconds, 0, 'f', 1)
+                   .arg(frames / seconds, 0, 'f', 1)
+                   .arg(writer->bytesWritten() / 1024) << Qt::endl;
+    if (!player.matchesRecording())
+        console << "ATTENTION : la partie rejouee differe de l'enregistrement "
+                   "(logique de jeu modifiee depuis ?)" << Qt::endl;
+    if (format == "raw")
+        console << QString("ffmpeg -f rawvideo -pix_fmt bgra -s %1x%2 -r %3 -i %4 ...")
+                       .arg(widget.width())
+                       .arg(widget.height())
+                       .arg(1000.0 / qMax(1, startSpeed * every), 0, 'f', 2)
+                       .arg(outPath) << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,490 @@
+// Statistiques d'un corpus de parties enregistrées (.snkp) : chaque partie
+// est rejouée sans affichage (ReplayPlayer), puis comptée par niveau :
+// distribution des scores et des durées en pas, cause de la fin (mur,
+// corps, danger, abandon, comme Game::checkCollision les distingue) et
+// objets ramassés par type.
+//
+// Les fichiers sont projetés en mémoire et lus sur place. Un lot (parties
+// mises bout à bout, `cat *.snkp > lot.snkp`) est découpé en tranches aux
+// frontières des parties. Chaque thread prend la tranche suivante, garde
+// sa partie et ses histogrammes, et les histogrammes sont fusionnés à la
+// fin : aucun verrou pendant l'analyse.
+//
+//   snake_replay_stats replays/ lot.snkp [--jobs 0] [--histogram]
+//       [--heatmap dossier]   cartes de chaleur ajoutées à celles du dossier
+//   snake_replay_stats --generate 100000 lot.snkp   corpus de test (bot)
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <atomic>
+#include "heatmap.h"
+#include "replay.h"
+
+static constexpr qint64 SLICE_BYTES = 1 << 20;   // tranche d'un lot
+static constexpr int SCORE_CLASS = 10;           // points par classe
+static constexpr int TICK_CLASS = 50;            // pas par classe
+static constexpr int HISTOGRAM_CLASSES = 4096;   // la dernière prend le reste
+
+static const char *const CAUSE_NAMES[] = {"aucune", "mur", "corps", "danger", "abandon"};
+static constexpr int CAUSE_COUNT = DEATH_ABANDON + 1;
+
+// Histogramme à classes fixes, moyenne et maximum exacts
+struct Histogram
+{
+    int width = 1;
+    QVector<quint64> counts;
+    quint64 total = 0;
+    qint64 sum = 0;
+    qint64 max = 0;
+
+    void add(qint64 value)
+    {
+        int c = int(qBound<qint64>(0, value / width, HISTOGRAM_CLASSES - 1));
+        if (c >= counts.size())
+            counts.resize(c + 1);
+        ++counts[c];
+        ++total;
+        sum += value;
+        max = total == 1 ? value : qMax(max, value);
+    }
+
+    void merge(const Histogram &other)
+    {
+        if (other.counts.size() > counts.size())
+            counts.resize(other.counts.size());
+        for (int c = 0; c < other.counts.size(); ++c)
+            counts[c] += other.counts[c];
+        max = total == 0 ? other.max : qMax(max, other.max);
+        total += other.total;
+        sum += other.sum;
+    }
+
+    double mean() const { return total ? double(sum) / total : 0.0; }
+
+    // Borne basse de la classe qui contient le centile `p`
+    qint64 percentile(double p) const
+    {
+        quint64 rank = quint64(p * total);
+        quint64 seen = 0;
+        for (int c = 0; c < counts.size(); ++c)
+        {
+            seen += counts[c];
+            if (seen > rank)
+                return qint64(c) * width;
+        }
+        return max;
+    }
+};
+
+struct LevelStats
+{
+    quint64 games = 0;
+    quint64 diverged = 0;   // fin différente de l'enregistrement
+    quint64 causes[CAUSE_COUNT] = {};
+    quint64 items[FRUIT_TYPE_COUNT] = {};
+    Histogram scores;
+    Histogram ticks;
+
+    LevelStats()
+    {
+        scores.width = SCORE_CLASS;
+        ticks.width = TICK_CLASS;
+    }
+
+    void merge(const LevelStats &other)
+    {
+        games += other.games;
+        diverged += other.diverged;
+        for (int i = 0; i < CAUSE_COUNT; ++i)
+            causes[i] += other.causes[i];
+        for (int i = 0; i < FRUIT_TYPE_COUNT; ++i)
+            items[i] += other.items[i];
+        scores.merge(other.scores);
+        ticks.merge(other.ticks);
+    }
+};
+
+struct CorpusStats
+{
+    QMap<int, LevelStats> levels;
+    QMap<QString, HeatMap> heat;   // --heatmap : par HeatMap::fileName
+    quint64 unreadable = 0;        // parties illisibles ou impossibles à rejouer
+
+    void merge(const CorpusStats &other)
+    {
+        for (auto it = other.levels.cbegin(); it != other.levels.cend(); ++it)
+            levels[it.key()].merge(it.value());
+        for (auto it = other.heat.cbegin(); it != other.heat.cend(); ++it)
+        {
+            if (!heat.contains(it.key()))
+                heat.insert(it.key(), it.value());
+            else
+                heat[it.key()].merge(it.value());
+        }
+        unreadable += other.unreadable;
+    }
+};
+
+// Plage d'un fichier qui commence et finit sur une frontière de partie
+struct Slice
+{
+    QString path;
+    qint64 begin;
+    qint64 end;
+};
+
+// Découpe un fichier en tranches d'environ SLICE_BYTES ; seuls les
+// en-têtes sont lus. Une partie invalide termine la dernière tranche, où
+// elle sera comptée illisible.
+static void sliceFile(const QString &path, QVector<Slice> &slices)
+{
+    QFile file(path);
+    qint64 size = file.size();
+    if (size <= 0)
+        return;
+    if (size <= SLICE_BYTES || !file.open(QIODevice::ReadOnly))
+    {
+        slices.append({path, 0, size});
+        return;
+    }
+    const uchar *data = file.map(0, size);
+    if (!data)
+    {
+        slices.append({path, 0, size});
+        return;
+    }
+    qint64 begin = 0;
+    qint64 offset = 0;
+    while (offset < size)
+    {
+        qint64 n = Replay::recordSize(data + offset, size - offset);
+        if (n < 0)
+            break;
+        offset += n;
+        if (offset - begin >= SLICE_BYTES)
+        {
+            slices.append({path, begin, offset});
+            begin = offset;
+        }
+    }
+    if (begin < size)
+        slices.append({path, begin, size});
+    file.unmap(const_cast<uchar *>(data));
+}
+
+// Un thread : une partie réutilisée d'un enregistrement à l'autre (ses
+// tampons gardent leur capacité), ses propres histogrammes
+static void analyze(const QVector<Slice> &slices, std::atomic<int> &next, bool withHeat,
+                    CorpusStats &stats)
+{
+    Replay replay;
+    ReplayPlayer player(replay);
+    quint64 items[FRUIT_TYPE_COUNT];
+    QObject::connect(&player.game(), &Game::fruitEaten,
+                     [&items](int, int, int, FruitType type) { ++items[type]; });
+
+    for (int i = next++; i < slices.size(); i = next++)
+    {
+        const Slice &slice = slices[i];
+        QFile file(slice.path);
+        qint64 size = slice.end - slice.begin;
+        const uchar *data = file.open(QIODevice::ReadOnly) ? file.map(slice.begin, size) : nullptr;
+        if (!data)
+        {
+            ++stats.unreadable;
+            continue;
+        }
+        for (qint64 offset = 0; offset < size;)
+        {
+            qint64 n = replay.read(data + offset, size - offset);
+            if (n < 0)
+            {
+                ++stats.unreadable;   // sans en-tête valide, la suite est perdue
+                break;
+            }
+            offset += n;
+            if (!player.start())
+            {
+                ++stats.unreadable;
+                continue;
+            }
+
+            // Carte de chaleur : case de la tête à chaque pas, case du choc
+            const Game &game = player.game();
+            HeatMap *heat = nullptr;
+            if (withHeat)
+            {
+                heat = &stats.heat[HeatMap::fileName(replay.mapPath, replay.layout, replay.level,
+                                                     game.boardWidth(), game.boardHeight())];
+                if (heat->width() == 0)
+                    heat->reset(game.boardWidth(), game.boardHeight());
+                heat->visit(game.headY() * game.boardWidth() + game.headX());
+            }
+
+            // Une partie qui diverge peut ne jamais finir : on l'arrête
+            // bien après la fin enregistrée
+            std::fill(items, items + FRUIT_TYPE_COUNT, 0);
+            quint64 limit = quint64(replay.ticks) * 2 + 10000;
+            while (game.tickCount() < limit && player.step())
+            {
+                if (heat && !game.isGameOver())
+                    heat->visit(game.headY() * game.boardWidth() + game.headX());
+            }
+            if (heat && game.isGameOver())
+                heat->death(game.headY() * game.boardWidth() + game.headX());
+
+            LevelStats &level = stats.levels[replay.level];
+            ++level.games;
+            if (!player.matchesRecording())
+                ++level.diverged;
+            ++level.causes[game.isGameOver() ? game.deathCause() : DEATH_ABANDON];
+            for (int t = 0; t < FRUIT_TYPE_COUNT; ++t)
+                level.items[t] += items[t];
+            level.scores.add(game.getScore());
+            level.ticks.add(qint64(game.tickCount()));
+        }
+        file.unmap(const_cast<uchar *>(data));
+    }
+}
+
+// Bot du corpus de test : vers le fruit le plus proche sans heurter mur
+// ni corps, un coup au hasard de temps en temps
+static Direction botMove(const Game &game, QRandomGenerator &rng)
+{
+    int w = game.boardWidth(), h = game.boardHeight();
+    Direction safe[4];
+    int safeCount = 0;
+    Direction best = game.getDirection();
+    int bestDist = w + h + 1;
+    for (int d = UP; d <= RIGHT; ++d)
+    {
+        Direction dir = static_cast<Direction>(d);
+        if (dir == oppositeDirection(game.getDirection()))
+            continue;
+        int x = (game.headX() + (dir == RIGHT) - (dir == LEFT) + w) % w;
+        int y = (game.headY() + (dir == DOWN) - (dir == UP) + h) % h;
+        if (game.isWall(x, y) || game.isOccupied(x, y) || game.isHazard(x, y))
+            continue;
+        safe[safeCount++] = dir;
+        int dist = w + h;
+        for (int i = 0; i < game.foodCount(); ++i)
+        {
+            int dx = qAbs(game.foodX(i) - x), dy = qAbs(game.foodY(i) - y);
+            dist = qMin(dist, qMin(dx, w - dx) + qMin(dy, h - dy));
+        }
+        if (dist < bestDist)
+        {
+            bestDist = dist;
+            best = dir;
+        }
+    }
+    if (safeCount > 0 && rng.bounded(100) < 8)
+        return safe[rng.bounded(safeCount)];
+    return best;
+}
+
+static bool generate(int games, const QString &path, QTextStream &out)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        out << "Ecriture impossible : " << file.errorString() << Qt::endl;
+        return false;
+    }
+    QRandomGenerator rng(2024);
+    Game game;
+    Replay replay;
+    for (int written = 0; written < games;)
+    {
+        replay.seed = rng.generate();
+        replay.level = 1 + written % 3;
+        replay.layout = static_cast<LayoutStyle>(rng.bounded(LAYOUT_COUNT));
+        replay.foods = written % 10 == 0 ? 20 : Game::FOOD_COUNT;
+        replay.hazards = written % 4 == 0 ? 4 : 0;
+        replay.inputs.clear();
+        replay.setup(game);
+
+        Direction issued = game.getDirection();
+        while (!game.isGameOver() && game.tickCount() < 20000)
+        {
+            Direction dir = botMove(game, rng);
+            if (dir != issued)
+            {
+                replay.inputs.append({quint32(game.tickCount()), dir});
+                game.changeDirection(dir);
+                issued = dir;
+            }
+            game.updateGame();
+        }
+        if (!game.isGameOver())
+            continue;   // partie sans fin : un enregistrement s'arrête au choc
+        replay.ticks = quint32(game.tickCount());
+        replay.finalScore = game.getScore();
+        if (file.write(replay.toBytes()) < 0)
+        {
+            out << "Ecriture impossible : " << file.errorString() << Qt::endl;
+            return false;
+        }
+        ++written;
+    }
+    out << games << " parties ecrites dans " << path << " (" << file.size() / 1024 << " Ko)"
+        << Qt::endl;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Statistiques d'un corpus de parties enregistrees (.snkp)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("chemins", "Fichiers .snkp (lots compris) ou dossiers.");
+    QCommandLineOption jobsOpt("jobs", "Threads d'analyse (0 : un par coeur).", "n", "0");
+    QCommandLineOption histOpt("histogram", "Affiche la distribution des scores par niveau.");
+    QCommandLineOption generateOpt("generate", "Ecrit n parties jouees par un bot dans le fichier "
+                                   "donne, puis quitte.", "n");
+    QCommandLineOption heatOpt("heatmap", "Ajoute passages et morts par case aux cartes de "
+                               "chaleur de ce dossier (celui du jeu : heatmaps).", "dossier");
+    parser.addOptions({jobsOpt, histOpt, generateOpt, heatOpt});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty())
+        parser.showHelp(2);
+    if (parser.isSet(generateOpt))
+        return generate(qMax(1, parser.value(generateOpt).toInt()), paths.first(), out) ? 0 : 1;
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<Slice> slices;
+    int files = 0;
+    for (const QString &path : paths)
+    {
+        if (QFileInfo(path).isDir())
+        {
+            QDirIterator it(path, {"*.snkp"}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext())
+            {
+                sliceFile(it.next(), slices);
+                ++files;
+            }
+        }
+        else
+        {
+            sliceFile(path, slices);
+            ++files;
+        }
+    }
+    qint64 sliceNs = timer.nsecsElapsed();
+
+    int jobs = parser.value(jobsOpt).toInt();
+    if (jobs <= 0)
+        jobs = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    QVector<CorpusStats> perThread(jobs);
+    std::atomic<int> next(0);
+    bool withHeat = parser.isSet(heatOpt);
+    QVector<QFuture<void>> workers;
+    for (int j = 0; j < jobs; ++j)
+    {
+        CorpusStats *stats = &perThread[j];
+        workers.append(QtConcurrent::run([&slices, &next, withHeat, stats]() {
+            analyze(slices, next, withHeat, *stats);
+        }));
+    }
+    for (QFuture<void> &worker : workers)
+        worker.waitForFinished();
+    CorpusStats total;
+    for (const CorpusStats &stats : perThread)
+        total.merge(stats);
+    double seconds = qMax(timer.nsecsElapsed() / 1e9, 1e-9);
+
+    quint64 games = 0;
+    qint64 ticks = 0;
+    for (const LevelStats &level : total.levels)
+    {
+        games += level.games;
+        ticks += level.ticks.sum;
+    }
+    out << QString("%1 parties dans %2 fichiers (%3 tranches), %4 illisibles")
+               .arg(games).arg(files).arg(slices.size()).arg(total.unreadable) << Qt::endl;
+    out << QString("%1 s sur %2 threads (decoupage %3 ms) : %4 parties/s, %5 millions/heure, "
+                   "%6 Mpas/s")
+               .arg(seconds, 0, 'f', 2)
+               .arg(jobs)
+               .arg(sliceNs / 1e6, 0, 'f', 1)
+               .arg(games / seconds, 0, 'f', 0)
+               .arg(games / seconds * 3600 / 1e6, 0, 'f', 2)
+               .arg(ticks / seconds / 1e6, 0, 'f', 1) << Qt::endl;
+
+    for (auto it = total.levels.cbegin(); it != total.levels.cend(); ++it)
+    {
+        const LevelStats &level = it.value();
+        double n = qMax<quint64>(1, level.games);
+        out << Qt::endl << QString("Niveau %1 : %2 parties").arg(it.key()).arg(level.games);
+        if (level.diverged)
+            out << QString(", %1 divergent de l'enregistrement").arg(level.diverged);
+        out << Qt::endl;
+        const Histogram *rows[] = {&level.scores, &level.ticks};
+        const char *labels[] = {"score", "pas"};
+        for (int r = 0; r < 2; ++r)
+            out << QString("  %1 moyenne %2  mediane %3  p90 %4  p99 %5  max %6")
+                       .arg(labels[r], -6)
+                       .arg(rows[r]->mean(), 0, 'f', 1)
+                       .arg(rows[r]->percentile(0.50))
+                       .arg(rows[r]->percentile(0.90))
+                       .arg(rows[r]->percentile(0.99))
+                       .arg(rows[r]->max) << Qt::endl;
+        out << "  fins  ";
+        for (int c = DEATH_WALL; c < CAUSE_COUNT; ++c)
+            out << QString(" %1 %2 %").arg(CAUSE_NAMES[c]).arg(100.0 * level.causes[c] / n, 0, 'f', 1);
+        out << Qt::endl << "  objets par partie ";
+        for (int t = 0; t < FRUIT_TYPE_COUNT; ++t)
+            out << QString(" %1 %2").arg(ITEM_TYPES[t].name).arg(level.items[t] / n, 0, 'f', 2);
+        out << Qt::endl;
+
+        if (parser.isSet(histOpt))
+        {
+            const QVector<quint64> &counts = level.scores.counts;
+            quint64 peak = *std::max_element(counts.cbegin(), counts.cend());
+            for (int c = 0; c < counts.size(); ++c)
+            {
+                if (!counts[c])
+                    continue;
+                out << QString("  %1 %2 %3")
+                           .arg(c * SCORE_CLASS, 6)
+                           .arg(counts[c], 9)
+                           .arg(QString(int(60 * counts[c] / peak), QChar('#'))) << Qt::endl;
+            }
+        }
+    }
+
+    if (withHeat)
+    {
+        QDir dir(parser.value(heatOpt));
+        dir.mkpath(".");
+        out << Qt::endl;
+        for (auto it = total.heat.begin(); it != total.heat.end(); ++it)
+        {
+            quint64 games = it.value().gameCount();
+            QString error;
+            if (it.value().flushTo(dir.filePath(it.key()), &error))
+                out << QString("Carte de chaleur %1 : %2 parties ajoutees").arg(it.key()).arg(games);
+            else
+                out << QString("Carte de chaleur %1 non ecrite : %2").arg(it.key(), error);
+            out << Qt::endl;
+        }
+    }
+    return total.unreadable ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+// Régularité des pas sous charge de rendu, sans fenêtre : le thread
+// principal "dessine" à la cadence voulue en occupant le processeur
+// pendant --render-ms. Deux cas mesurés :
+//  - fil graphique : les pas sont joués entre deux rendus, comme avec le
+//    QTimer d'avant (un pas attend la fin du rendu en cours) ;
+//  - thread de jeu : SimThread, le thread principal ne fait que lire les
+//    états publiés.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+#include "simthread.h"
+
+static void burn(const QElapsedTimer &clock, qint64 untilNs)
+{
+    while (clock.nsecsElapsed() < untilNs)
+    {
+    }
+}
+
+static QString describe(const SimTiming &t)
+{
+    return QString("retard moyen %1 ms, max %2 ms, > 1 ms : %3 / %4 pas")
+        .arg(t.ticks ? t.totalLateNs / 1e6 / t.ticks : 0.0, 0, 'f', 3)
+        .arg(t.maxLateNs / 1e6, 0, 'f', 3)
+        .arg(t.lateTicks)
+        .arg(t.ticks);
+}
+
+static SimTiming runGuiThread(const SimSettings &settings, qint64 durationNs,
+                              qint64 frameNs, qint64 renderNs)
+{
+    Game game;
+    game.setLevel(settings.level);
+    game.reset();
+
+    SimTiming t;
+    qint64 periodNs = settings.periodMs * 1000000LL;
+    QElapsedTimer clock;
+    clock.start();
+    qint64 tickDeadline = periodNs;
+    qint64 frameDeadline = 0;
+    while (clock.nsecsElapsed() < durationNs)
+    {
+        qint64 now = clock.nsecsElapsed();
+        if (now >= tickDeadline)
+        {
+            qint64 late = now - tickDeadline;
+            ++t.ticks;
+            t.totalLateNs += late;
+            t.maxLateNs = qMax(t.maxLateNs, late);
+            if (late > 1000000)
+                ++t.lateTicks;
+            game.updateGame();
+            if (game.isGameOver())
+                game.reset();
+            tickDeadline += periodNs;
+        }
+        else if (now >= frameDeadline)
+        {
+            burn(clock, now + renderNs);
+            frameDeadline += frameNs;
+        }
+        else
+        {
+            QThread::usleep(100);
+        }
+    }
+    return t;
+}
+
+static SimTiming runSimThread(const SimSettings &settings, qint64 durationNs,
+                              qint64 frameNs, qint64 renderNs)
+{
+    SimThread sim;
+    sim.start(QThread::HighPriority);
+    quint32 gameId = 1;
+    sim.startGame(settings, gameId);
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 frameDeadline = 0;
+    while (clock.nsecsElapsed() < durationNs)
+    {
+        SimEvent event;
+        while (sim.nextEvent(event))
+        {
+        }
+        if (sim.updateSnapshot() && sim.snapshot().gameId == gameId && sim.snapshot().gameOver)
+            sim.startGame(settings, ++gameId);
+
+        qint64 now = clock.nsecsElapsed();
+        if (now >= frameDeadline)
+        {
+            burn(clock, now + renderNs);
+            frameDeadline += frameNs;
+        }
+        else
+        {
+            QThread::usleep(100);
+        }
+    }
+    sim.stopGame();
+    sim.updateSnapshot();
+    return sim.snapshot().timing;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Retard des pas sous charge de rendu");
+    parser.addHelpOption();
+    QCommandLineOption periodOpt("period", "Periode des pas, en ms.", "ms", "10");
+    QCommandLineOption fpsOpt("fps", "Rendus par seconde.", "n", "60");
+    QCommandLineOption renderOpt("render-ms", "Duree d'un rendu, en ms.", "ms", "12");
+    QCommandLineOption secondsOpt("seconds", "Duree de chaque mesure.", "s", "5");
+    parser.addOptions({periodOpt, fpsOpt, renderOpt, secondsOpt});
+    parser.process(app);
+
+    SimSettings settings;
+    settings.periodMs = qMax(1, parser.value(periodOpt).toInt());
+    qint64 frameNs = 1000000000LL / qMax(1, parser.value(fpsOpt).toInt());
+    qint64 renderNs = static_cast<qint64>(parser.value(renderOpt).toDouble() * 1e6);
+    qint64 durationNs = qMax(1, parser.value(secondsOpt).toInt()) * 1000000000LL;
+
+    QTextStream out(stdout);
+    out << "fil graphique : "
+        << describe(runGuiThread(settings, durationNs, frameNs, renderNs)) << Qt::endl;
+    out << "thread de jeu : "
+        << describe(runSimThread(settings, durationNs, frameNs, renderNs)) << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Coût par pas de l'échéancier (TimerWheel) face au décompte naïf, qui
+// décrémente chaque minuterie à chaque pas. Régime établi : chaque
+// minuterie échue est reprogrammée, avec une durée qui ne dépend que de
+// son numéro et de son rang, si bien que les deux méthodes doivent
+// déclencher exactement les mêmes événements.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "timerwheel.h"
+
+static int duration(int id, int round, int maxLife)
+{
+    quint32 h = quint32(id) * 0x9E3779B1u ^ quint32(round) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return 1 + int(h % quint32(maxLife));
+}
+
+struct BenchResult
+{
+    qint64 nanos = 0;
+    qint64 fired = 0;
+};
+
+static BenchResult runWheel(int count, int ticks, int maxLife)
+{
+    TimerWheel wheel;
+    QVector<int> rounds(count, 0);
+    for (int id = 0; id < count; ++id)
+        wheel.schedule(duration(id, 0, maxLife), 0, id);
+
+    BenchResult r;
+    QVector<TimerEvent> fired;
+    QElapsedTimer timer;
+    timer.start();
+    for (int t = 0; t < ticks; ++t)
+    {
+        fired.clear();
+        wheel.advance(fired);
+        for (const TimerEvent &e : fired)
+            wheel.schedule(wheel.now() + duration(e.arg, ++rounds[e.arg], maxLife), 0, e.arg);
+        r.fired += fired.size();
+    }
+    r.nanos = timer.nsecsElapsed();
+    return r;
+}
+
+static BenchResult runCountdown(int count, int ticks, int maxLife)
+{
+    QVector<int> left(count), rounds(count, 0);
+    for (int id = 0; id < count; ++id)
+        left[id] = duration(id, 0, maxLife);
+
+    BenchResult r;
+    QElapsedTimer timer;
+    timer.start();
+    for (int t = 0; t < ticks; ++t)
+    {
+        for (int id = 0; id < count; ++id)
+        {
+            if (--left[id] == 0)
+            {
+                left[id] = duration(id, ++rounds[id], maxLife);
+                ++r.fired;
+            }
+        }
+    }
+    r.nanos = timer.nsecsElapsed();
+    return r;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Echeancier des effets : cout par pas selon le nombre de minuteries");
+    parser.addHelpOption();
+    QCommandLineOption timersOpt("timers", "Nombres de minuteries, separes par des virgules.", "liste",
+                                 "100,1000,10000,100000");
+    QCommandLineOption ticksOpt("ticks", "Pas simules.", "n", "20000");
+    QCommandLineOption lifeOpt("max-life", "Duree maximale d'une minuterie, en pas.", "n", "600");
+    parser.addOptions({timersOpt, ticksOpt, lifeOpt});
+    parser.process(app);
+
+    int ticks = qMax(1, parser.value(ticksOpt).toInt());
+    int maxLife = qMax(1, parser.value(lifeOpt).toInt());
+
+    QTextStream out(stdout);
+    bool mismatch = false;
+    for (const QString &field : parser.value(timersOpt).split(','))
+    {
+        int count = qMax(1, field.toInt());
+        BenchResult wheel = runWheel(count, ticks, maxLife);
+        BenchResult naive = runCountdown(count, ticks, maxLife);
+        out << QString("%1 minuteries : roue %2 ns/pas (%3 ns/evenement), decompte %4 ns/pas, "
+                       "%5 evenements/pas")
+                   .arg(count, 7)
+                   .arg(double(wheel.nanos) / ticks, 9, 'f', 0)
+                   .arg(double(wheel.nanos) / qMax<qint64>(1, wheel.fired), 0, 'f', 0)
+                   .arg(double(naive.nanos) / ticks, 9, 'f', 0)
+                   .arg(double(wheel.fired) / ticks, 0, 'f', 1) << Qt::endl;
+        if (wheel.fired != naive.fired)
+        {
+            out << "ERREUR : " << wheel.fired << " evenements contre " << naive.fired << Qt::endl;
+            mismatch = true;
+        }
+    }
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,536 @@
+// Tournoi de bots chargés depuis des bibliothèques partagées (botapi.h,
+// exemples dans bots/). Trois modes, sur des graines fixées :
+//  - solo : chaque bot joue seul les mêmes parties ; deux bots sont
+//    comparés partie par partie (même graine, même plateau) ;
+//  - duel : chaque paire de bots dans l'arène, chaque graine jouée deux
+//    fois en échangeant les places ;
+//  - melee : tous les bots dans la même arène, places tournantes.
+// Un serpent gagne contre un autre par le score, à score égal en
+// survivant (comme Arena::winner).
+//
+// Les parties sont réparties sur tous les coeurs : chaque thread prend la
+// partie suivante et a ses propres instances de bots, son jeu et son
+// arène ; résultats et temps de décision ne sont fusionnés qu'à la fin.
+// Le classement de type Elo est ajusté sur l'ensemble des parties, donc
+// indépendant de l'ordre où les threads les finissent.
+//
+// Une décision rendue après le budget est ignorée (le serpent continue
+// tout droit) et comptée ; avec un budget, les résultats dépendent donc
+// de la charge de la machine. --budget-us 0 rend le tournoi reproductible.
+//
+//   snake_tournament bots/libbot_greedy.so bots/libbot_survivor.so
+//       [--games 1000] [--modes solo,duel,melee] [--jobs 0]
+//       [--budget-us 2000] [--seed 1] [--level 2] [--max-ticks 20000]
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtMath>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "arena.h"
+#include "botplugin.h"
+#include "game.h"
+
+enum Mode
+{
+    MODE_SOLO,
+    MODE_DUEL,
+    MODE_MELEE,
+    MODE_COUNT
+};
+
+static const char *const MODE_NAMES[MODE_COUNT] = {"solo", "duel", "melee"};
+
+struct Settings
+{
+    int level = 2;
+    quint32 maxTicks = 20000;
+    qint64 budgetNs = 2000000;
+};
+
+struct Match
+{
+    Mode mode;
+    int round;            // numéro de la partie dans son groupe
+    quint32 seed;
+    QVector<int> seats;   // bot de chaque serpent, ids croissants
+};
+
+struct MatchResult
+{
+    QVector<int> scores;  // par place
+    QVector<char> alive;  // en vie à la fin
+    quint32 ticks = 0;
+};
+
+// Temps de décision en classes logarithmiques : 8 classes par puissance
+// de 2, soit 12,5 % de précision à toutes les échelles, en 4 Ko
+struct LatencyHistogram
+{
+    static constexpr int CLASSES = 64 * 8;
+
+    QVector<quint64> counts = QVector<quint64>(CLASSES, 0);
+    quint64 total = 0;
+    quint64 late = 0;     // hors budget
+    qint64 max = 0;
+
+    static int classOf(qint64 ns)
+    {
+        if (ns < 8)
+            return int(qMax<qint64>(ns, 0));
+        int e = 63 - qCountLeadingZeroBits(quint64(ns));
+        return ((e - 2) << 3) + int((ns >> (e - 3)) & 7);
+    }
+    static qint64 lowerBound(int c)
+    {
+        if (c < 8)
+            return c;
+        return qint64(8 + (c & 7)) << ((c >> 3) - 1);
+    }
+
+    void add(qint64 ns, bool overBudget)
+    {
+        ++counts[classOf(ns)];
+        ++total;
+        late += overBudget;
+        max = qMax(max, ns);
+    }
+    void merge(const LatencyHistogram &other)
+    {
+        for (int c = 0; c < CLASSES; ++c)
+            counts[c] += other.counts[c];
+        total += other.total;
+        late += other.late;
+        max = qMax(max, other.max);
+    }
+    // Borne basse de la classe qui contient le centile `p`
+    qint64 percentile(double p) const
+    {
+        quint64 rank = quint64(p * total);
+        quint64 seen = 0;
+        for (int c = 0; c < CLASSES; ++c)
+        {
+            seen += counts[c];
+            if (seen > rank)
+                return lowerBound(c);
+        }
+        return max;
+    }
+};
+
+// Ce que voit et fait un thread : une instance de chaque bot
+class Table
+{
+public:
+    Table(const QVector<QSharedPointer<BotPlugin>> &plugins, const Settings &settings,
+          QVector<LatencyHistogram> &latency)
+        : plugins(plugins),
+        settings(settings),
+        latency(latency)
+    {
+        for (const QSharedPointer<BotPlugin> &plugin : plugins)
+            bots.append(plugin->create());
+    }
+    ~Table()
+    {
+        for (int b = 0; b < bots.size(); ++b)
+            plugins[b]->destroy(bots[b]);
+    }
+
+    void play(const Match &match, MatchResult &result)
+    {
+        if (match.mode == MODE_SOLO)
+            playSolo(match, result);
+        else
+            playArena(match, result);
+    }
+
+private:
+    const QVector<QSharedPointer<BotPlugin>> &plugins;
+    const Settings &settings;
+    QVector<LatencyHistogram> &latency;   // par bot
+    QVector<SnakeBot *> bots;
+    BotObserver observer;
+    Game game;
+    Arena arena;
+
+    Direction ask(int bot, const BotView &view, Direction current)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        int32_t answer = bots[bot]->decide(view);
+        qint64 ns = timer.nsecsElapsed();
+        bool late = settings.budgetNs > 0 && ns > settings.budgetNs;
+        latency[bot].add(ns, late);
+        return late ? current : botDecision(answer, current);
+    }
+
+    void playSolo(const Match &match, MatchResult &result)
+    {
+        int bot = match.seats[0];
+        game.setLevel(settings.level);
+        game.setSeed(match.seed);
+        game.reset();
+        bots[bot]->newGame(match.seed);
+        while (!game.isGameOver() && game.tickCount() < settings.maxTicks)
+        {
+            const BotView &view = observer.observe(game, settings.budgetNs);
+            game.changeDirection(ask(bot, view, game.getDirection()));
+            game.updateGame();
+        }
+        result.scores = {game.getScore()};
+        result.alive = {char(!game.isGameOver())};
+        result.ticks = quint32(game.tickCount());
+    }
+
+    void playArena(const Match &match, MatchResult &result)
+    {
+        int seats = match.seats.size();
+        arena.setSeed(match.seed);
+        arena.setup(seats, 0);
+        arena.setLevel(settings.level);
+        arena.reset();
+        observer.newGame();
+        for (int s = 0; s < seats; ++s)
+            bots[match.seats[s]]->newGame(match.seed + s);
+        while (!arena.isOver() && arena.tickCount() < settings.maxTicks)
+        {
+            for (int s = 0; s < seats; ++s)
+            {
+                const ArenaSnake &snake = arena.snake(s);
+                if (!snake.alive)
+                    continue;
+                const BotView &view = observer.observe(arena, s, settings.budgetNs);
+                arena.changeDirection(s, ask(match.seats[s], view, snake.direction));
+            }
+            arena.tick();
+        }
+        result.scores.resize(seats);
+        result.alive.resize(seats);
+        for (int s = 0; s < seats; ++s)
+        {
+            result.scores[s] = arena.snake(s).score;
+            result.alive[s] = arena.snake(s).alive;
+        }
+        result.ticks = arena.tickCount();
+    }
+};
+
+// Victoires de chaque bot contre chacun (un nul compte un demi-point de
+// chaque côté)
+struct Pairings
+{
+    int n;
+    QVector<double> wins;   // wins[i * n + j] : points de i contre j
+
+    explicit Pairings(int bots) : n(bots), wins(bots * bots, 0.0) {}
+
+    double points(int i, int j) const { return wins[i * n + j]; }
+    double games(int i, int j) const { return points(i, j) + points(j, i); }
+
+    // Place a contre place b d'une même partie
+    void record(int botA, int scoreA, bool aliveA, int botB, int scoreB, bool aliveB)
+    {
+        int cmp = scoreA != scoreB ? (scoreA > scoreB ? 1 : -1) : int(aliveA) - int(aliveB);
+        if (cmp > 0)
+            wins[botA * n + botB] += 1.0;
+        else if (cmp < 0)
+            wins[botB * n + botA] += 1.0;
+        else
+        {
+            wins[botA * n + botB] += 0.5;
+            wins[botB * n + botA] += 0.5;
+        }
+    }
+
+    // Classement de type Elo ajusté sur toutes les parties à la fois
+    // (modèle de Bradley-Terry, itérations MM) : P(i bat j) = s_i / (s_i +
+    // s_j), soit l'écart d'Elo 400 log10(s_i / s_j). Un demi-point fictif
+    // de chaque côté par paire rencontrée garde des forces finies quand un
+    // bot gagne tout.
+    QVector<double> ratings() const
+    {
+        QVector<double> strength(n, 1.0);
+        QVector<double> next(n);
+        for (int iter = 0; iter < 1000; ++iter)
+        {
+            double logSum = 0.0;
+            for (int i = 0; i < n; ++i)
+            {
+                double won = 0.0, denom = 0.0;
+                for (int j = 0; j < n; ++j)
+                {
+                    if (j == i || games(i, j) == 0.0)
+                        continue;
+                    won += points(i, j) + 0.5;
+                    denom += (games(i, j) + 1.0) / (strength[i] + strength[j]);
+                }
+                next[i] = denom > 0.0 ? won / denom : 1.0;
+                logSum += qLn(next[i]);
+            }
+            double scale = qExp(logSum / n);
+            double change = 0.0;
+            for (int i = 0; i < n; ++i)
+            {
+                change = qMax(change, qAbs(next[i] / scale - strength[i]) / strength[i]);
+                strength[i] = next[i] / scale;
+            }
+            if (change < 1e-9)
+                break;
+        }
+        QVector<double> elo(n);
+        for (int i = 0; i < n; ++i)
+            elo[i] = 1500.0 + 400.0 * std::log10(strength[i]);
+        return elo;
+    }
+};
+
+static QVector<Match> schedule(const bool modes[MODE_COUNT], int bots, int games, quint32 seed)
+{
+    QVector<Match> matches;
+    if (modes[MODE_SOLO])
+    {
+        for (int b = 0; b < bots; ++b)
+            for (int g = 0; g < games; ++g)
+                matches.append({MODE_SOLO, g, seed + quint32(g), {b}});
+    }
+    if (modes[MODE_DUEL])
+    {
+        for (int a = 0; a < bots; ++a)
+            for (int b = a + 1; b < bots; ++b)
+                for (int g = 0; g < games; ++g)
+                {
+                    // Même graine deux fois, places échangées
+                    QVector<int> seats = (g & 1) ? QVector<int>{b, a} : QVector<int>{a, b};
+                    matches.append({MODE_DUEL, g, seed + quint32(g / 2), seats});
+                }
+    }
+    if (modes[MODE_MELEE])
+    {
+        int seats = qMin(bots, int(Arena::MAX_SNAKES));
+        for (int g = 0; g < games; ++g)
+        {
+            QVector<int> order(seats);
+            for (int s = 0; s < seats; ++s)
+                order[s] = (g + s) % bots;
+            matches.append({MODE_MELEE, g, seed + quint32(g), order});
+        }
+    }
+    return matches;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tournoi de bots charges depuis des bibliotheques partagees");
+    parser.addHelpOption();
+    parser.addPositionalArgument("bots", "Bibliotheques des bots (voir botapi.h et bots/).");
+    QCommandLineOption gamesOpt("games", "Parties par bot (solo), par paire (duel) ou en "
+                                "tout (melee).", "n", "1000");
+    QCommandLineOption modesOpt("modes", "Modes joues, separes par des virgules : "
+                                "solo, duel, melee.", "liste", "solo,duel,melee");
+    QCommandLineOption jobsOpt("jobs", "Threads de jeu (0 : un par coeur).", "n", "0");
+    QCommandLineOption budgetOpt("budget-us", "Temps accorde a une decision (0 : illimite, "
+                                 "tournoi reproductible).", "us", "2000");
+    QCommandLineOption seedOpt("seed", "Graine de la premiere partie.", "n", "1");
+    QCommandLineOption levelOpt("level", "Niveau (1-3).", "n", "2");
+    QCommandLineOption ticksOpt("max-ticks", "Pas au-dela desquels une partie s'arrete.", "n",
+                                "20000");
+    parser.addOptions({gamesOpt, modesOpt, jobsOpt, budgetOpt, seedOpt, levelOpt, ticksOpt});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty())
+        parser.showHelp(2);
+
+    QVector<QSharedPointer<BotPlugin>> plugins;
+    for (const QString &path : paths)
+    {
+        QSharedPointer<BotPlugin> plugin(new BotPlugin);
+        QString error;
+        if (!plugin->load(path, &error))
+        {
+            out << path << " : " << error << Qt::endl;
+            return 1;
+        }
+        plugins.append(plugin);
+    }
+    int botCount = plugins.size();
+
+    Settings settings;
+    settings.level = qBound(1, parser.value(levelOpt).toInt(), 3);
+    settings.maxTicks = quint32(qMax(1, parser.value(ticksOpt).toInt()));
+    settings.budgetNs = qMax<qint64>(0, parser.value(budgetOpt).toLongLong()) * 1000;
+    int games = qMax(1, parser.value(gamesOpt).toInt());
+
+    bool modes[MODE_COUNT] = {};
+    for (const QString &name : parser.value(modesOpt).split(','))
+    {
+        int m = 0;
+        while (m < MODE_COUNT && name.trimmed() != MODE_NAMES[m])
+            ++m;
+        if (m == MODE_COUNT)
+        {
+            out << "Mode inconnu : " << name << Qt::endl;
+            return 2;
+        }
+        modes[m] = true;
+    }
+    // Une melee a deux n'est qu'un duel
+    if (modes[MODE_DUEL] && botCount < 2)
+        out << "duel ignore : il faut au moins 2 bots" << Qt::endl;
+    if (modes[MODE_MELEE] && botCount < 3)
+        out << "melee ignoree : il faut au moins 3 bots" << Qt::endl;
+    modes[MODE_DUEL] = modes[MODE_DUEL] && botCount >= 2;
+    modes[MODE_MELEE] = modes[MODE_MELEE] && botCount >= 3;
+
+    QVector<Match> matches = schedule(modes, botCount, games,
+                                      quint32(parser.value(seedOpt).toUInt()));
+    QVector<MatchResult> results(matches.size());
+
+    int jobs = parser.value(jobsOpt).toInt();
+    if (jobs <= 0)
+        jobs = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    QVector<QVector<LatencyHistogram>> perThread(jobs, QVector<LatencyHistogram>(botCount));
+    std::atomic<int> next(0);
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QFuture<void>> workers;
+    for (int j = 0; j < jobs; ++j)
+    {
+        QVector<LatencyHistogram> *latency = &perThread[j];
+        workers.append(QtConcurrent::run([&, latency]() {
+            Table table(plugins, settings, *latency);
+            for (int i = next++; i < matches.size(); i = next++)
+                table.play(matches[i], results[i]);
+        }));
+    }
+    for (QFuture<void> &worker : workers)
+        worker.waitForFinished();
+    double seconds = qMax(timer.nsecsElapsed() / 1e9, 1e-9);
+
+    qint64 ticks = 0;
+    for (const MatchResult &result : results)
+        ticks += result.ticks;
+    out << QString("%1 parties, %2 pas en %3 s sur %4 threads : %5 parties/s")
+               .arg(matches.size()).arg(ticks).arg(seconds, 0, 'f', 2).arg(jobs)
+               .arg(matches.size() / seconds, 0, 'f', 0) << Qt::endl;
+
+    for (int m = 0; m < MODE_COUNT; ++m)
+    {
+        if (!modes[m])
+            continue;
+        Pairings pairings(botCount);
+        QVector<qint64> scoreSum(botCount, 0), tickSum(botCount, 0), rankSum(botCount, 0);
+        QVector<int> played(botCount, 0), survived(botCount, 0), best(botCount, 0);
+        // Solo : scores de chaque bot par partie, comparés ensuite
+        QVector<QVector<int>> soloScores(botCount, QVector<int>(games, 0));
+        QVector<QVector<char>> soloAlive(botCount, QVector<char>(games, 0));
+        for (int i = 0; i < matches.size(); ++i)
+        {
+            const Match &match = matches[i];
+            const MatchResult &result = results[i];
+            if (match.mode != m)
+                continue;
+            int seats = match.seats.size();
+            for (int s = 0; s < seats; ++s)
+            {
+                int bot = match.seats[s];
+                scoreSum[bot] += result.scores[s];
+                tickSum[bot] += result.ticks;
+                best[bot] = qMax(best[bot], result.scores[s]);
+                survived[bot] += result.alive[s];
+                ++played[bot];
+                // Rang : 1 + serpents qui font mieux
+                int rank = 1;
+                for (int o = 0; o < seats; ++o)
+                    rank += result.scores[o] > result.scores[s]
+                         || (result.scores[o] == result.scores[s] && result.alive[o] > result.alive[s]);
+                rankSum[bot] += rank;
+                for (int o = s + 1; o < seats; ++o)
+                    pairings.record(bot, result.scores[s], result.alive[s], match.seats[o],
+                                    result.scores[o], result.alive[o]);
+            }
+            if (m == MODE_SOLO)
+            {
+                soloScores[match.seats[0]][match.round] = result.scores[0];
+                soloAlive[match.seats[0]][match.round] = result.alive[0];
+            }
+        }
+        if (m == MODE_SOLO)
+        {
+            for (int g = 0; g < games; ++g)
+                for (int a = 0; a < botCount; ++a)
+                    for (int b = a + 1; b < botCount; ++b)
+                        pairings.record(a, soloScores[a][g], soloAlive[a][g], b,
+                                        soloScores[b][g], soloAlive[b][g]);
+        }
+
+        QVector<double> elo = pairings.ratings();
+        QVector<int> order(botCount);
+        for (int b = 0; b < botCount; ++b)
+            order[b] = b;
+        std::sort(order.begin(), order.end(), [&elo](int a, int b) { return elo[a] > elo[b]; });
+
+        out << Qt::endl << QString("Mode %1 :").arg(MODE_NAMES[m]) << Qt::endl;
+        out << QString("  %1 %2 %3 %4 %5 %6 %7 %8")
+                   .arg("bot", -16).arg("Elo", 6).arg("parties", 8).arg("score", 8)
+                   .arg("max", 6).arg("pas", 8).arg("vivant", 7).arg("rang", 6) << Qt::endl;
+        for (int b : order)
+        {
+            double n = qMax(1, played[b]);
+            out << QString("  %1 %2 %3 %4 %5 %6 %7 %8")
+                       .arg(plugins[b]->name(), -16)
+                       .arg(elo[b], 6, 'f', 0)
+                       .arg(played[b], 8)
+                       .arg(scoreSum[b] / n, 8, 'f', 1)
+                       .arg(best[b], 6)
+                       .arg(tickSum[b] / n, 8, 'f', 0)
+                       .arg(QString("%1 %").arg(100.0 * survived[b] / n, 0, 'f', 0), 7)
+                       .arg(rankSum[b] / n, 6, 'f', 2) << Qt::endl;
+        }
+        // Bilan de chaque paire : victoires, nuls, défaites de la ligne
+        for (int a = 0; a < botCount; ++a)
+            for (int b = a + 1; b < botCount; ++b)
+            {
+                double total = pairings.games(a, b);
+                if (total == 0.0)
+                    continue;
+                out << QString("  %1 contre %2 : %3 % des points")
+                           .arg(plugins[a]->name()).arg(plugins[b]->name())
+                           .arg(100.0 * pairings.points(a, b) / total, 0, 'f', 1) << Qt::endl;
+            }
+    }
+
+    out << Qt::endl << QString("Temps de decision (us), budget %1 :")
+                           .arg(settings.budgetNs ? QString::number(settings.budgetNs / 1000)
+                                                  : QString("illimite")) << Qt::endl;
+    out << QString("  %1 %2 %3 %4 %5 %6 %7 %8")
+               .arg("bot", -16).arg("decisions", 12).arg("p50", 8).arg("p90", 8)
+               .arg("p99", 8).arg("p99.9", 8).arg("max", 8).arg("hors budget", 12) << Qt::endl;
+    for (int b = 0; b < botCount; ++b)
+    {
+        LatencyHistogram total;
+        for (const QVector<LatencyHistogram> &latency : perThread)
+            total.merge(latency[b]);
+        out << QString("  %1 %2 %3 %4 %5 %6 %7 %8")
+                   .arg(plugins[b]->name(), -16)
+                   .arg(total.total, 12)
+                   .arg(total.percentile(0.50) / 1e3, 8, 'f', 2)
+                   .arg(total.percentile(0.90) / 1e3, 8, 'f', 2)
+                   .arg(total.percentile(0.99) / 1e3, 8, 'f', 2)
+                   .arg(total.percentile(0.999) / 1e3, 8, 'f', 2)
+                   .arg(total.max / 1e3, 8, 'f', 2)
+                   .arg(total.late, 12) << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Tampon triple sans verrou, un écrivain et un lecteur. L'écrivain remplit
+// writeBuffer() puis publish() ; le lecteur appelle update() et lit
+// readBuffer(), stable jusqu'à son prochain update(). Aucun des deux
+// n'attend jamais l'autre : un état publié mais pas encore lu est
+// simplement remplacé par le suivant. L'échange d'indices est le seul
+// point de synchronisation (acquisition / libération).
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : middle(1), back(2), front(0) {}
+
+    // Écrivain
+    T &writeBuffer() { return buffers[back]; }
+    void publish() { back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX; }
+
+    // Lecteur : vrai si un nouvel état a été pris
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T &readBuffer() const { return buffers[front]; }
+
+private:
+    static constexpr int INDEX = 3;
+    static constexpr int FRESH = 4;
+
+    T buffers[3];
+    alignas(64) std::atomic<int> middle;
+    alignas(64) int back;    // propre à l'écrivain
+    alignas(64) int front;   // propre au lecteur
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,81 @@
+#ifndef WALLGRID_H
+#define WALLGRID_H
+
+#include <QVector>
+
+// Grille des murs, un bit par case (bit x & 7 de l'octet y * rowBytes + x / 8).
+// Même disposition que la bitmap d'un fichier de carte : la grille peut
+// donc soit posséder ses octets, soit lire directement une carte projetée
+// en mémoire (attach), sans copie.
+class WallGrid
+{
+public:
+    WallGrid() : bits(nullptr), w(0), h(0), stride(0) {}
+
+    // Lignes alignées sur 8 octets, comme dans les fichiers de carte
+    static int rowBytesFor(int width) { return ((width + 63) / 64) * 8; }
+
+    void reset(int width, int height)
+    {
+        w = width;
+        h = height;
+        stride = rowBytesFor(width);
+        storage.fill(0, stride * h);
+        bits = storage.constData();
+    }
+
+    void attach(const uchar *data, int width, int height, int rowBytes)
+    {
+        storage.clear();
+        bits = data;
+        w = width;
+        h = height;
+        stride = rowBytes;
+    }
+
+    bool isWall(int x, int y) const { return (bits[y * stride + (x >> 3)] >> (x & 7)) & 1; }
+
+    void setWall(int x, int y, bool wall = true)
+    {
+        detach();
+        uchar &b = storage[y * stride + (x >> 3)];
+        b = wall ? (b | (1 << (x & 7))) : (b & ~(1 << (x & 7)));
+        bits = storage.constData();
+    }
+
+    // Accès direct aux octets d'une ligne, pour les écritures en masse
+    // (bits au-delà de width() à laisser nuls)
+    uchar *mutableRow(int y)
+    {
+        detach();
+        uchar *data = storage.data();  // copie d'abord si les octets sont partagés
+        bits = storage.constData();
+        return data + y * stride;
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int rowBytes() const { return stride; }
+    const uchar *row(int y) const { return bits + y * stride; }
+    bool isAttached() const { return bits && storage.isEmpty(); }
+
+private:
+    QVector<uchar> storage;
+    const uchar *bits;
+    int w;
+    int h;
+    int stride;
+
+    // Une grille attachée est en lecture seule : copie avant la première écriture
+    void detach()
+    {
+        if (!isAttached())
+            return;
+        QVector<uchar> copy(stride * h);
+        for (int i = 0; i < copy.size(); ++i)
+            copy[i] = bits[i];
+        storage = copy;
+    }
+};
+
+#endif // WALLGRID_H